@@ -0,0 +1,28 @@
+# Proyecto completo: la biblioteca chatcore, la aplicación, las herramientas
+# y las pruebas.
+
+TEMPLATE = subdirs
+
+SUBDIRS += \
+    core \
+    app \
+    codecbench \
+    loadgen \
+    mockserver \
+    tests
+
+core.subdir = Client-OS-P1/core
+app.file = Client-OS-P1/Client-OS-P1.pro
+app.depends = core
+
+codecbench.subdir = Client-OS-P1/tools/codecbench
+codecbench.depends = core
+
+loadgen.subdir = Client-OS-P1/tools/loadgen
+loadgen.depends = core
+
+mockserver.subdir = Client-OS-P1/tools/mockserver
+mockserver.depends = core
+
+tests.subdir = Client-OS-P1/tests
+tests.depends = core
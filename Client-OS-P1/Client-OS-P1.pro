@@ -8,17 +8,36 @@ CONFIG += c++17
 # In order to do so, uncomment the following line.
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
+# En release los qCDebug/qDebug no generan código; info y superiores siguen
+# llegando al registro en memoria (ver logging.h).
+CONFIG(release, debug|release): DEFINES += QT_NO_DEBUG_OUTPUT
+
+# Protocolo, sesión y conversaciones viven en la biblioteca chatcore.
+include(core/core.pri)
+
 SOURCES += \
+    avatarcache.cpp \
     main.cpp \
     mainwindow.cpp \
-    websocketclient.cpp
+    messagedelegate.cpp \
+    messagelistmodel.cpp \
+    rosterdelegate.cpp \
+    rostermodel.cpp
 
 HEADERS += \
+    avatarcache.h \
     connectiondialog.h \
+    diagnosticsdock.h \
     mainwindow.h \
     messagebubble.h \
-    userchatitem.h \
-    websocketclient.h
+    messagedelegate.h \
+    messagelistmodel.h \
+    messagesearchdialog.h \
+    metricsdock.h \
+    quickswitcher.h \
+    rosterdelegate.h \
+    rostermodel.h \
+    userchatitem.h
 
 FORMS += \
     mainwindow.ui
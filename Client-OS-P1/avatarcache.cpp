@@ -0,0 +1,223 @@
+#include "avatarcache.h"
+
+#include <QFile>
+#include <QGuiApplication>
+#include <QPainter>
+#include <QPainterPath>
+#include <QtMath>
+
+namespace {
+
+// Decodifica y reduce la imagen; corre en el pool.
+QImage decodeSource(const QByteArray &encoded) {
+    QImage image = QImage::fromData(encoded);
+    if (image.isNull())
+        return image;
+    if (image.width() > AvatarCache::MaxSourceSize || image.height() > AvatarCache::MaxSourceSize)
+        image = image.scaled(AvatarCache::MaxSourceSize, AvatarCache::MaxSourceSize,
+                             Qt::KeepAspectRatioByExpanding, Qt::SmoothTransformation);
+    return image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+}
+
+// Recorta al centro, escala y enmascara en círculo; corre en el pool.
+QImage circleImage(const QImage &source, int pixels) {
+    const int side = qMin(source.width(), source.height());
+    const QImage square = source.copy((source.width() - side) / 2, (source.height() - side) / 2, side, side)
+                              .scaled(pixels, pixels, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+
+    QImage result(pixels, pixels, QImage::Format_ARGB32_Premultiplied);
+    result.fill(Qt::transparent);
+    QPainter painter(&result);
+    painter.setRenderHint(QPainter::Antialiasing);
+    QPainterPath circle;
+    circle.addEllipse(0, 0, pixels, pixels);
+    painter.setClipPath(circle);
+    painter.drawImage(0, 0, square);
+    return result;
+}
+
+qreal devicePixelRatio() {
+    return qApp ? qApp->devicePixelRatio() : 1.0;
+}
+
+} // namespace
+
+AvatarCache::AvatarCache(QObject *parent)
+    : QObject(parent)
+    , m_pixmaps(MaxCost)
+    , m_sources(MaxSourceCost)
+{
+    m_pool.setMaxThreadCount(2);
+}
+
+AvatarCache::~AvatarCache() {
+    // Los resultados que lleguen después se descartan junto con el objeto
+    m_pool.clear();
+    m_pool.waitForDone();
+}
+
+QColor AvatarCache::color(const QString &username) {
+    if (username.isEmpty())
+        return QColor("#128C7E"); // Default color
+
+    // Generate a hue based on the hash
+    int hash = 0;
+    for (const QChar &c : username) {
+        hash = ((hash << 5) - hash) + c.unicode();
+    }
+    return QColor::fromHsv(qAbs(hash) % 360, 200, 200);
+}
+
+QPixmap AvatarCache::avatar(const QString &username, int size) {
+    const QString cacheKey = key(username, size);
+    if (const QPixmap *cached = m_pixmaps.object(cacheKey))
+        return *cached;
+
+    // Primera vez que se ve al usuario: buscar su imagen fuera del hilo de la interfaz
+    if (!m_directory.isEmpty() && !m_probed.contains(username)) {
+        m_probed.insert(username);
+        // El nombre viene del servidor: nada de rutas fuera del directorio
+        if (username.isEmpty() || username.startsWith('.') || username.contains('/') || username.contains('\\'))
+            return avatar(username, size);
+        decode(username);
+    }
+
+    const QImage *source = m_sources.object(username);
+    if (!source && m_withImage.contains(username)) {
+        // La imagen salió de la caché de decodificadas: se vuelve a decodificar
+        decode(username);
+        return initials(username, size);
+    }
+    if (!source) {
+        QPixmap *pixmap = new QPixmap(initials(username, size));
+        const QPixmap result = *pixmap;
+        m_pixmaps.insert(cacheKey, pixmap, int(pixmap->width() * pixmap->height() * 4));
+        return result;
+    }
+
+    // Hay imagen: se escala en el pool y mientras tanto se usa la inicial
+    if (!m_scaling.contains(cacheKey)) {
+        m_scaling.insert(cacheKey);
+        const QImage image = *source;
+        const int pixels = qCeil(size * devicePixelRatio());
+        m_pool.start([this, username, size, image, pixels] {
+            const QImage scaled = circleImage(image, pixels);
+            QMetaObject::invokeMethod(this, [this, username, size, scaled] { scaledReady(username, size, scaled); },
+                                      Qt::QueuedConnection);
+        });
+    }
+    return initials(username, size);
+}
+
+void AvatarCache::setImageDirectory(const QString &directory) {
+    m_directory = directory;
+    m_probed.clear();
+}
+
+void AvatarCache::setImage(const QString &username, const QByteArray &encoded) {
+    m_probed.insert(username);
+    m_encoded.insert(username, encoded);
+    m_decoding.remove(username);
+    decode(username);
+}
+
+void AvatarCache::clear() {
+    m_pixmaps.clear();
+    m_sources.clear();
+    m_encoded.clear();
+    m_withImage.clear();
+    m_decoding.clear();
+    m_probed.clear();
+    m_scaling.clear();
+}
+
+qsizetype AvatarCache::memoryUsage() const {
+    // El costo de cada pixmap e imagen en las cachés ya está en bytes
+    qsizetype bytes = m_pixmaps.totalCost() + m_sources.totalCost();
+    for (const QByteArray &encoded : m_encoded)
+        bytes += encoded.size();
+    return bytes;
+}
+
+QString AvatarCache::key(const QString &username, int size) const {
+    return QString::number(size) + '/' + username;
+}
+
+QPixmap AvatarCache::initials(const QString &username, int size) const {
+    const qreal ratio = devicePixelRatio();
+    QPixmap pixmap(qCeil(size * ratio), qCeil(size * ratio));
+    pixmap.setDevicePixelRatio(ratio);
+    pixmap.fill(Qt::transparent);
+
+    QPainter painter(&pixmap);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setPen(Qt::NoPen);
+    painter.setBrush(color(username));
+    painter.drawEllipse(QRectF(0, 0, size, size));
+
+    QFont font = painter.font();
+    font.setBold(true);
+    font.setPixelSize(qMax(8, qRound(size * 0.36)));
+    painter.setFont(font);
+    painter.setPen(Qt::white);
+    painter.drawText(QRectF(0, 0, size, size), Qt::AlignCenter,
+                     username.isEmpty() ? QString("?") : QString(username.at(0).toUpper()));
+    return pixmap;
+}
+
+void AvatarCache::decode(const QString &username) {
+    if (m_decoding.contains(username))
+        return;
+    m_decoding.insert(username);
+
+    // Los bytes de setImage tienen prioridad sobre el archivo del directorio
+    const QByteArray given = m_encoded.value(username);
+    const QString base = given.isEmpty() && !m_directory.isEmpty() ? m_directory + '/' + username : QString();
+    m_pool.start([this, username, given, base] {
+        QByteArray encoded = given;
+        if (encoded.isEmpty() && !base.isEmpty()) {
+            for (const char *extension : {".png", ".jpg", ".jpeg"}) {
+                QFile file(base + QLatin1String(extension));
+                if (file.open(QIODevice::ReadOnly)) {
+                    encoded = file.readAll();
+                    break;
+                }
+            }
+        }
+        // Sin bytes la imagen queda nula y sourceReady solo baja la marca
+        const QImage image = encoded.isEmpty() ? QImage() : decodeSource(encoded);
+        QMetaObject::invokeMethod(this, [this, username, image] { sourceReady(username, image); },
+                                  Qt::QueuedConnection);
+    });
+}
+
+void AvatarCache::sourceReady(const QString &username, const QImage &image) {
+    m_decoding.remove(username);
+    if (image.isNull())
+        return;
+    m_withImage.insert(username);
+    m_sources.insert(username, new QImage(image), int(image.sizeInBytes()));
+    forget(username);
+    emit avatarChanged(username);
+}
+
+void AvatarCache::scaledReady(const QString &username, int size, const QImage &image) {
+    const QString cacheKey = key(username, size);
+    m_scaling.remove(cacheKey);
+    if (!m_withImage.contains(username))
+        return;
+
+    QPixmap *pixmap = new QPixmap(QPixmap::fromImage(image));
+    pixmap->setDevicePixelRatio(devicePixelRatio());
+    m_pixmaps.insert(cacheKey, pixmap, int(image.sizeInBytes()));
+    emit avatarChanged(username);
+}
+
+void AvatarCache::forget(const QString &username) {
+    const QString suffix = '/' + username;
+    const QList<QString> keys = m_pixmaps.keys();
+    for (const QString &cacheKey : keys) {
+        if (cacheKey.endsWith(suffix) && cacheKey.indexOf('/') == cacheKey.size() - suffix.size())
+            m_pixmaps.remove(cacheKey);
+    }
+}
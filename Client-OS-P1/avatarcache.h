@@ -0,0 +1,78 @@
+#ifndef AVATARCACHE_H
+#define AVATARCACHE_H
+#pragma once
+
+#include <QCache>
+#include <QHash>
+#include <QImage>
+#include <QObject>
+#include <QPixmap>
+#include <QSet>
+#include <QString>
+#include <QThreadPool>
+
+// Avatares de todos los usuarios, pintados una sola vez por (usuario, tamaño).
+//
+// Sin imagen, el avatar es el círculo con la inicial y el color derivado del
+// nombre que ya usaba la interfaz. Las imágenes reales (un archivo
+// <usuario>.png/.jpg en imageDirectory() o bytes entregados con setImage) se
+// decodifican y escalan en un QThreadPool propio; el hilo de la interfaz solo
+// convierte el resultado final a QPixmap. Mientras tanto se devuelve el
+// avatar con la inicial y, al terminar, se emite avatarChanged().
+//
+// Las imágenes decodificadas también van en una caché LRU acotada: si se
+// descarta una que vuelve a hacer falta, se decodifica otra vez.
+class AvatarCache : public QObject
+{
+    Q_OBJECT
+
+public:
+    // Costo máximo de la caché, en bytes de pixmap.
+    static constexpr int MaxCost = 8 * 1024 * 1024;
+    // Costo máximo de las imágenes decodificadas, en bytes (64 de 256 x 256).
+    static constexpr int MaxSourceCost = 16 * 1024 * 1024;
+    // Lado máximo con que se guarda una imagen decodificada.
+    static constexpr int MaxSourceSize = 256;
+
+    explicit AvatarCache(QObject *parent = nullptr);
+    ~AvatarCache();
+
+    // Color de fondo del avatar con la inicial de un usuario.
+    static QColor color(const QString &username);
+
+    // Avatar circular de `size` x `size` píxeles lógicos.
+    QPixmap avatar(const QString &username, int size);
+
+    // Directorio donde buscar <usuario>.png o <usuario>.jpg.
+    void setImageDirectory(const QString &directory);
+    QString imageDirectory() const { return m_directory; }
+    // Imagen codificada (PNG, JPEG, ...) para un usuario.
+    void setImage(const QString &username, const QByteArray &encoded);
+
+    void clear();
+    // Bytes de pixmaps en caché e imágenes decodificadas.
+    qsizetype memoryUsage() const;
+
+signals:
+    void avatarChanged(const QString &username);
+
+private:
+    QString key(const QString &username, int size) const;
+    QPixmap initials(const QString &username, int size) const;
+    void decode(const QString &username);
+    void sourceReady(const QString &username, const QImage &image);
+    void scaledReady(const QString &username, int size, const QImage &image);
+    void forget(const QString &username);
+
+    QCache<QString, QPixmap> m_pixmaps;
+    QCache<QString, QImage> m_sources;      // imágenes ya decodificadas
+    QHash<QString, QByteArray> m_encoded;   // bytes de setImage, para volver a decodificar
+    QSet<QString> m_withImage;              // usuarios cuya imagen se decodificó alguna vez
+    QSet<QString> m_decoding;               // usuarios con una decodificación en curso
+    QSet<QString> m_probed;                 // usuarios ya buscados en el directorio
+    QSet<QString> m_scaling;            // claves con un escalado en curso
+    QString m_directory;
+    QThreadPool m_pool;
+};
+
+#endif // AVATARCACHE_H
@@ -0,0 +1,96 @@
+#include "chatsession.h"
+
+#include <QDateTime>
+
+ChatSession::ChatSession() = default;
+
+ChatSession::~ChatSession() = default;
+
+void ChatSession::start(const QString &server, const QString &self, bool persistent) {
+    m_self = self;
+    m_log.reset(persistent ? new MessageLog(MessageLog::defaultDirectory(server, self)) : nullptr);
+    m_store.clear();
+    m_search.clear();
+}
+
+ChatSession::Route ChatSession::route(const QString &self, const QString &sender, bool isHistory) {
+    if (sender == "~")
+        return Notice;
+    // El historial llega completo por historyReceived y lo que YO envío ya se
+    // agregó al enviarlo; se ignora para evitar duplicados.
+    if (isHistory || sender == self)
+        return Ignored;
+    return Stored;
+}
+
+ChatSession::Route ChatSession::receive(const QString &sender, const QString &text, bool isHistory) {
+    const Route result = route(m_self, sender, isHistory);
+    if (result != Stored)
+        return result;
+
+    // Se guarda en su conversación aunque no esté abierta
+    ensureConversation(sender);
+    m_store.append(sender, LogRecord{sender, text, QDateTime::currentMSecsSinceEpoch()});
+    index(sender, m_store.count(sender) - 1, 1);
+    return result;
+}
+
+void ChatSession::sent(const QString &chat, const QString &text) {
+    ensureConversation(chat);
+    m_store.append(chat, LogRecord{m_self, text, QDateTime::currentMSecsSinceEpoch()});
+    index(chat, m_store.count(chat) - 1, 1);
+}
+
+qsizetype ChatSession::syncHistory(const QString &chat, const QList<HistoryEntry> &entries, qsizetype *prepended) {
+    const QList<LogRecord> page = records(entries);
+
+    // Persistir lo nuevo en disco y en memoria
+    if (m_log && !entries.isEmpty() && entries.first().hasPosition) {
+        QList<quint64> positions;
+        positions.reserve(entries.size());
+        for (const HistoryEntry &entry : entries)
+            positions.append(entry.position);
+        m_log->sync(chat, page, positions);
+    } else if (m_log) {
+        // Página sin cursor: sus posiciones no dicen nada
+        m_log->sync(chat, page);
+    }
+    qsizetype older = 0;
+    const qsizetype added = m_store.sync(chat, page, &older);
+    index(chat, 0, older);
+    index(chat, m_store.count(chat) - added, added);
+    if (prepended)
+        *prepended = older;
+    return added;
+}
+
+void ChatSession::prependOlder(const QString &chat, const QList<HistoryEntry> &entries) {
+    const QList<LogRecord> older = records(entries);
+    m_store.prepend(chat, older);
+    index(chat, 0, older.size());
+}
+
+void ChatSession::ensureConversation(const QString &chat) {
+    if (m_store.contains(chat))
+        return;
+
+    // Primera vez en la sesión: se parte de la cola del registro en disco
+    QList<LogRecord> tail;
+    if (m_log)
+        tail = m_log->tail(chat, LogRenderCount);
+    m_store.prepend(chat, tail);
+    index(chat, 0, tail.size());
+}
+
+QList<LogRecord> ChatSession::records(const QList<HistoryEntry> &entries) {
+    QList<LogRecord> out;
+    out.reserve(entries.size());
+    for (const HistoryEntry &entry : entries)
+        out.append(LogRecord{entry.sender, entry.message, 0});
+    return out;
+}
+
+void ChatSession::index(const QString &chat, qsizetype first, qsizetype count) {
+    for (qsizetype i = first; i < first + count; ++i)
+        m_search.add(chat, m_store.sequence(chat, i), m_store.message(chat, i).text);
+}
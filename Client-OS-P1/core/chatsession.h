@@ -0,0 +1,71 @@
+#ifndef CHATSESSION_H
+#define CHATSESSION_H
+#pragma once
+
+#include <QList>
+#include <QString>
+
+#include <memory>
+
+#include "conversationstore.h"
+#include "messagelog.h"
+#include "messagesearchindex.h"
+#include "networkworker.h"
+
+// Estado de una sesión de chat, sin interfaz.
+//
+// Reúne las conversaciones en memoria, su registro en disco y el índice de
+// búsqueda, y aplica las reglas de enrutamiento de los mensajes entrantes:
+// los avisos del servidor ("~") van al chat general, el historial y el eco
+// de lo que uno mismo envió se ignoran (ya llegan por otra vía) y el resto se
+// guarda en la conversación del remitente. La ventana, un bot o una
+// herramienta de carga usan exactamente este mismo código.
+class ChatSession {
+public:
+    enum Route {
+        Notice,     // aviso del sistema para el chat general
+        Ignored,    // historial o eco propio: ya está en la conversación
+        Stored      // guardado en la conversación del remitente
+    };
+
+    // Mensajes del registro en disco con que arranca una conversación.
+    static constexpr int LogRenderCount = 100;
+
+    ChatSession();
+    ~ChatSession();
+
+    // Nueva sesión de `self` en `server` ("host:puerto"); descarta la anterior.
+    // Con `persistent` en false no se lee ni escribe el registro en disco.
+    void start(const QString &server, const QString &self, bool persistent = true);
+    QString self() const { return m_self; }
+
+    static Route route(const QString &self, const QString &sender, bool isHistory);
+    // Aplica route() y, si corresponde, guarda el mensaje.
+    Route receive(const QString &sender, const QString &text, bool isHistory);
+    // Mensaje propio enviado a `chat`.
+    void sent(const QString &chat, const QString &text);
+
+    // Primera página del historial: se concilia con lo que ya había y
+    // devuelve cuántos mensajes nuevos se agregaron al final. En `prepended`,
+    // si no es nulo, cuántos más antiguos que todo lo que había se antepusieron.
+    qsizetype syncHistory(const QString &chat, const QList<HistoryEntry> &entries, qsizetype *prepended = nullptr);
+    // Página anterior: se antepone a la conversación.
+    void prependOlder(const QString &chat, const QList<HistoryEntry> &entries);
+    // Carga la cola del registro en disco la primera vez que se abre `chat`.
+    void ensureConversation(const QString &chat);
+
+    const ConversationStore &store() const { return m_store; }
+    MessageSearchIndex &search() { return m_search; }
+    const MessageSearchIndex &search() const { return m_search; }
+
+private:
+    static QList<LogRecord> records(const QList<HistoryEntry> &entries);
+    void index(const QString &chat, qsizetype first, qsizetype count);
+
+    QString m_self;
+    std::unique_ptr<MessageLog> m_log;
+    ConversationStore m_store;
+    MessageSearchIndex m_search;
+};
+
+#endif // CHATSESSION_H
@@ -0,0 +1,48 @@
+#include "connectgate.h"
+
+void ConnectGate::start(bool cached) {
+    *this = ConnectGate();
+    m_nameOk = cached;
+}
+
+ConnectGate::State ConnectGate::nameChecked(int httpCode) {
+    if (m_state != Waiting)
+        return m_state;
+    if (httpCode >= 200 && httpCode < 300)
+        m_nameOk = true;
+    else if (httpCode == 400 && m_socketLost)
+        m_state = Rejected;     // el servidor ya cerró el WebSocket
+    else if (httpCode == 400)
+        m_nameDisputed = true;
+    else
+        m_state = Failed;
+    return update();
+}
+
+ConnectGate::State ConnectGate::socketConnected() {
+    m_socketUp = true;
+    m_socketLost = false;
+    return update();
+}
+
+ConnectGate::State ConnectGate::sessionConfirmed() {
+    if (m_socketUp)
+        m_confirmed = true;
+    return update();
+}
+
+ConnectGate::State ConnectGate::socketLost() {
+    m_socketUp = false;
+    m_socketLost = true;
+    m_confirmed = false;
+    // Sin 400 el cliente reintenta solo; con 400 el servidor no nos quiso
+    if (m_state == Waiting && m_nameDisputed)
+        m_state = Rejected;
+    return m_state;
+}
+
+ConnectGate::State ConnectGate::update() {
+    if (m_state == Waiting && m_socketUp && (m_nameOk || (m_nameDisputed && m_confirmed)))
+        m_state = Ready;
+    return m_state;
+}
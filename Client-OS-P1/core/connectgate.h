@@ -0,0 +1,46 @@
+#ifndef CONNECTGATE_H
+#define CONNECTGATE_H
+#pragma once
+
+// Decide cuándo una conexión nueva queda lista para usarse.
+//
+// La verificación HTTP del nombre y el WebSocket se abren a la vez. El
+// servidor da un nombre por ocupado en cuanto registra su WebSocket, así que
+// si nuestro handshake le gana a la verificación, esta responde 400 por
+// nuestra propia sesión. Por eso un 400 no es definitivo: se espera a que el
+// servidor confirme la sesión (responde la lista de usuarios que se pide al
+// conectar) o la cierre, que es lo que hace con un nombre de verdad ocupado.
+// Con una verificación en caché solo se espera al WebSocket.
+class ConnectGate {
+public:
+    enum State {
+        Waiting,    // falta la verificación, el WebSocket o la confirmación
+        Ready,      // se puede habilitar la interfaz
+        Rejected,   // nombre ocupado o inválido
+        Failed      // la verificación respondió otro código
+    };
+
+    // Nueva conexión; `cached` si hay una verificación reciente en caché.
+    void start(bool cached);
+    // Respuesta de la verificación HTTP.
+    State nameChecked(int httpCode);
+    // Se abrió el WebSocket.
+    State socketConnected();
+    // El servidor respondió a la sesión: el WebSocket quedó registrado.
+    State sessionConfirmed();
+    // Se cerró el WebSocket antes de quedar lista.
+    State socketLost();
+    State state() const { return m_state; }
+
+private:
+    State update();
+
+    State m_state = Waiting;
+    bool m_nameOk = false;
+    bool m_nameDisputed = false;   // 400: puede ser por nuestra propia sesión
+    bool m_socketUp = false;
+    bool m_socketLost = false;     // se cerró sin haber quedado lista
+    bool m_confirmed = false;
+};
+
+#endif // CONNECTGATE_H
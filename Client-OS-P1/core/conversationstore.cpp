@@ -0,0 +1,149 @@
+#include "conversationstore.h"
+
+#include <QAnyStringView>
+#include <QUtf8StringView>
+
+static_assert(sizeof(ConversationStore::Record) == 24, "Record debe mantenerse compacto");
+
+qsizetype ConversationStore::count(const QString &conversation) const {
+    auto it = m_conversations.constFind(conversation);
+    return it == m_conversations.constEnd() ? 0 : it->size();
+}
+
+LogRecord ConversationStore::message(const QString &conversation, qsizetype index) const {
+    const Record &record = m_conversations.value(conversation).at(index);
+    return LogRecord{m_senders.at(record.sender), QString::fromUtf8(textOf(record)), record.timestamp};
+}
+
+QString ConversationStore::sender(const QString &conversation, qsizetype index) const {
+    return m_senders.at(m_conversations.value(conversation).at(index).sender);
+}
+
+qint64 ConversationStore::timestamp(const QString &conversation, qsizetype index) const {
+    return m_conversations.value(conversation).at(index).timestamp;
+}
+
+qint64 ConversationStore::sequence(const QString &conversation, qsizetype index) const {
+    return m_origins.value(conversation) + index;
+}
+
+qsizetype ConversationStore::indexOf(const QString &conversation, qint64 sequence) const {
+    const qsizetype index = sequence - m_origins.value(conversation);
+    return index >= 0 && index < count(conversation) ? index : -1;
+}
+
+void ConversationStore::append(const QString &conversation, const LogRecord &message) {
+    m_conversations[conversation].append(store(message));
+}
+
+void ConversationStore::prepend(const QString &conversation, const QList<LogRecord> &older) {
+    QList<Record> &records = m_conversations[conversation];
+    QList<Record> merged;
+    merged.reserve(older.size() + records.size());
+    for (const LogRecord &message : older)
+        merged.append(store(message));
+    merged.append(records);
+    records.swap(merged);
+    m_origins[conversation] -= older.size();
+}
+
+qsizetype ConversationStore::sync(const QString &conversation, const QList<LogRecord> &page,
+                                  qsizetype *prepended) {
+    QList<Record> &records = m_conversations[conversation];
+    const qsizetype size = records.size();
+
+    // Fin de lo ya conocido en la página: el mayor `end` tal que los últimos
+    // `overlap` = min(end, size) mensajes de la conversación son
+    // page[end - overlap..end). O la página empieza dentro de la conversación
+    // o la conversación entera está dentro de la página.
+    qsizetype end = 0;
+    qsizetype overlap = 0;
+    for (qsizetype e = page.size(); e > 0 && end == 0; --e) {
+        const qsizetype n = qMin(e, size);
+        qsizetype i = 0;
+        while (i < n && sameMessage(records.at(size - n + i), page.at(e - n + i)))
+            ++i;
+        if (n > 0 && i == n) {
+            end = e;
+            overlap = n;
+        }
+    }
+
+    // Lo que llega sin hora (el historial no la trae) queda con timestamp 0:
+    // la hora real se desconoce y la vista no la muestra
+    for (qsizetype i = end; i < page.size(); ++i)
+        records.append(store(page.at(i)));
+
+    // Lo de la página anterior a toda la conversación va al inicio
+    const qsizetype older = end - overlap;
+    if (older > 0)
+        prepend(conversation, page.first(older));
+    if (prepended)
+        *prepended = older;
+    return page.size() - end;
+}
+
+qsizetype ConversationStore::memoryUsage() const {
+    qsizetype bytes = 0;
+    for (const QByteArray &chunk : m_chunks)
+        bytes += chunk.capacity();
+    for (const QList<Record> &records : m_conversations)
+        bytes += records.capacity() * qsizetype(sizeof(Record));
+    for (const QString &sender : m_senders)
+        bytes += sender.capacity() * qsizetype(sizeof(QChar)) + qsizetype(sizeof(QString) + sizeof(quint32));
+    return bytes;
+}
+
+void ConversationStore::clear() {
+    m_conversations.clear();
+    m_origins.clear();
+    m_senderIds.clear();
+    m_senders.clear();
+    m_chunks.clear();
+    m_messageCount = 0;
+}
+
+ConversationStore::Record ConversationStore::store(const LogRecord &message) {
+    const qsizetype required = m_encoder.requiredSpace(message.text.size());
+
+    // Un mensaje que no cabe en el bloque actual abre uno nuevo; los mensajes
+    // enormes reciben un bloque a su medida.
+    if (m_chunks.isEmpty() || m_chunks.last().capacity() - m_chunks.last().size() < required) {
+        QByteArray chunk;
+        chunk.reserve(qMax(ChunkSize, required));
+        m_chunks.append(chunk);
+    }
+
+    QByteArray &chunk = m_chunks.last();
+    const qsizetype offset = chunk.size();
+    chunk.resize(offset + required);   // dentro de la capacidad reservada
+    m_encoder.resetState();
+    char *end = m_encoder.appendToBuffer(chunk.data() + offset, message.text);
+    chunk.resize(end - chunk.constData());
+
+    ++m_messageCount;
+    return Record{message.timestamp, quint32(m_chunks.size() - 1), quint32(offset),
+                  quint32(chunk.size() - offset), intern(message.sender)};
+}
+
+quint32 ConversationStore::intern(const QString &sender) {
+    auto it = m_senderIds.constFind(sender);
+    if (it != m_senderIds.constEnd())
+        return *it;
+
+    const quint32 id = quint32(m_senders.size());
+    m_senders.append(sender);
+    m_senderIds.insert(sender, id);
+    return id;
+}
+
+QByteArrayView ConversationStore::textOf(const Record &record) const {
+    return QByteArrayView(m_chunks.at(record.chunk).constData() + record.offset, record.length);
+}
+
+bool ConversationStore::sameMessage(const Record &record, const LogRecord &message) const {
+    if (m_senders.at(record.sender) != message.sender)
+        return false;
+    const QByteArrayView text = textOf(record);
+    return QAnyStringView::equal(QUtf8StringView(text.data(), text.size()), message.text);
+}
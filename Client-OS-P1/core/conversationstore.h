@@ -0,0 +1,73 @@
+#ifndef CONVERSATIONSTORE_H
+#define CONVERSATIONSTORE_H
+#pragma once
+
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QStringEncoder>
+
+#include "messagelog.h"
+
+// Mensajes en memoria de todas las conversaciones abiertas en la sesión.
+//
+// El texto de los mensajes se guarda en UTF-8 dentro de bloques compartidos
+// de ChunkSize bytes; cada mensaje es un registro fijo de 24 bytes con su
+// bloque, desplazamiento, largo, remitente (internado como número) y
+// timestamp. Así cambiar de conversación no requiere volver a pedir nada al
+// servidor y el costo por mensaje se queda en el registro más su texto.
+class ConversationStore {
+public:
+    static constexpr qsizetype ChunkSize = 64 * 1024;
+
+    struct Record {
+        qint64 timestamp;
+        quint32 chunk;
+        quint32 offset;
+        quint32 length;
+        quint32 sender;
+    };
+
+    bool contains(const QString &conversation) const { return m_conversations.contains(conversation); }
+    qsizetype count(const QString &conversation) const;
+    LogRecord message(const QString &conversation, qsizetype index) const;
+    QString sender(const QString &conversation, qsizetype index) const;
+    qint64 timestamp(const QString &conversation, qsizetype index) const;
+    // Número estable de un mensaje: no cambia cuando se anteponen mensajes
+    // más antiguos, a diferencia de su índice.
+    qint64 sequence(const QString &conversation, qsizetype index) const;
+    // Índice actual del mensaje con ese número, o -1.
+    qsizetype indexOf(const QString &conversation, qint64 sequence) const;
+
+    void append(const QString &conversation, const LogRecord &message);
+    // Mensajes más antiguos que los que ya hay, en orden cronológico.
+    void prepend(const QString &conversation, const QList<LogRecord> &older);
+    // Alinea una página del servidor con la cola de la conversación, anexa
+    // solo lo que falta y devuelve cuántos mensajes se agregaron al final.
+    // Si la conversación entera está dentro de la página (por ejemplo, solo
+    // tenía mensajes recibidos en vivo), lo anterior de la página se
+    // antepone; `prepended`, si no es nulo, recibe cuántos.
+    qsizetype sync(const QString &conversation, const QList<LogRecord> &page, qsizetype *prepended = nullptr);
+
+    qsizetype messageCount() const { return m_messageCount; }
+    // Bytes ocupados por bloques de texto, registros y remitentes.
+    qsizetype memoryUsage() const;
+    void clear();
+
+private:
+    Record store(const LogRecord &message);
+    quint32 intern(const QString &sender);
+    QByteArrayView textOf(const Record &record) const;
+    bool sameMessage(const Record &record, const LogRecord &message) const;
+
+    QHash<QString, QList<Record>> m_conversations;
+    QHash<QString, qint64> m_origins;   // número estable del índice 0
+    QHash<QString, quint32> m_senderIds;
+    QList<QString> m_senders;
+    QList<QByteArray> m_chunks;
+    QStringEncoder m_encoder{QStringEncoder::Utf8};
+    qsizetype m_messageCount = 0;
+};
+
+#endif // CONVERSATIONSTORE_H
@@ -0,0 +1,14 @@
+# Enlaza la biblioteca chatcore: include(<ruta>/core/core.pri) desde el .pro
+# de la aplicación o de una herramienta. La compila ChatOS.pro (raíz).
+
+INCLUDEPATH += $$PWD
+DEPENDPATH += $$PWD
+QT *= core network websockets
+
+CHATCORE_DIR = $$shadowed($$PWD)
+win32:CONFIG(debug, debug|release): CHATCORE_DIR = $$CHATCORE_DIR/debug
+else:win32:CONFIG(release, debug|release): CHATCORE_DIR = $$CHATCORE_DIR/release
+
+LIBS += -L$$CHATCORE_DIR -lchatcore
+win32-msvc*: PRE_TARGETDEPS += $$CHATCORE_DIR/chatcore.lib
+else: PRE_TARGETDEPS += $$CHATCORE_DIR/libchatcore.a
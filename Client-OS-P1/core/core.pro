@@ -0,0 +1,54 @@
+# Núcleo del cliente sin interfaz: protocolo, sesión, roster y conversaciones.
+# Lo enlazan la aplicación y las herramientas (ver core.pri); no depende de
+# QtWidgets ni de QtGui, así que corre sin servidor gráfico.
+
+TEMPLATE = lib
+TARGET = chatcore
+CONFIG += staticlib c++17
+
+QT = core network websockets
+
+CONFIG(release, debug|release): DEFINES += QT_NO_DEBUG_OUTPUT
+
+SOURCES += \
+    chatsession.cpp \
+    connectgate.cpp \
+    conversationstore.cpp \
+    fragmentation.cpp \
+    historypager.cpp \
+    latencyhistogram.cpp \
+    latencytracker.cpp \
+    logging.cpp \
+    messagelog.cpp \
+    messagesearchindex.cpp \
+    metrics.cpp \
+    mockserver.cpp \
+    namevalidationcache.cpp \
+    networkworker.cpp \
+    protocolcodec.cpp \
+    reconnectpolicy.cpp \
+    roster.cpp \
+    rostersearchindex.cpp \
+    websocketclient.cpp
+
+HEADERS += \
+    chatsession.h \
+    connectgate.h \
+    conversationstore.h \
+    fragmentation.h \
+    historypager.h \
+    latencyhistogram.h \
+    latencytracker.h \
+    logging.h \
+    messagelog.h \
+    messagesearchindex.h \
+    metrics.h \
+    mockserver.h \
+    namevalidationcache.h \
+    networkworker.h \
+    protocolcodec.h \
+    reconnectpolicy.h \
+    roster.h \
+    rostersearchindex.h \
+    spscqueue.h \
+    websocketclient.h
@@ -0,0 +1,154 @@
+#include "fragmentation.h"
+
+namespace Fragmentation {
+
+namespace {
+
+constexpr char HexDigits[] = "0123456789abcdef";
+
+void writeHex(char *out, quint32 value, int digits) {
+    for (int i = digits - 1; i >= 0; --i) {
+        out[i] = HexDigits[value & 0xF];
+        value >>= 4;
+    }
+}
+
+bool readHex(const char *in, int digits, quint32 &value) {
+    value = 0;
+    for (int i = 0; i < digits; ++i) {
+        const char c = in[i];
+        quint32 nibble;
+        if (c >= '0' && c <= '9')
+            nibble = quint32(c - '0');
+        else if (c >= 'a' && c <= 'f')
+            nibble = quint32(c - 'a' + 10);
+        else
+            return false;
+        value = (value << 4) | nibble;
+    }
+    return true;
+}
+
+} // namespace
+
+bool isFragment(QByteArrayView text) {
+    return text.size() >= HeaderSize && text.front() == Marker;
+}
+
+Splitter::Splitter(QByteArrayView utf8, quint16 messageId)
+    : m_text(utf8), m_messageId(messageId)
+{
+    qsizetype start = 0;
+    while (start < m_text.size()) {
+        if (m_ends.size() == MaxFragments) {
+            m_truncated = true;
+            break;
+        }
+        qsizetype end = qMin(start + MaxChunk, m_text.size());
+        // No cortar una secuencia UTF-8 a la mitad.
+        while (end < m_text.size() && end > start && (quint8(m_text[end]) & 0xC0) == 0x80)
+            --end;
+        m_ends.append(end);
+        start = end;
+    }
+}
+
+QByteArrayView Splitter::header(int index) {
+    m_header[0] = Marker;
+    writeHex(m_header + 1, m_messageId, 4);
+    writeHex(m_header + 5, quint32(index), 2);
+    writeHex(m_header + 7, quint32(count()), 2);
+    return QByteArrayView(m_header, HeaderSize);
+}
+
+QByteArrayView Splitter::chunk(int index) const {
+    const qsizetype start = index == 0 ? 0 : m_ends[index - 1];
+    return m_text.sliced(start, m_ends[index] - start);
+}
+
+Reassembler::Result Reassembler::feed(QByteArrayView sender, QByteArrayView text, qint64 nowMs,
+                                      QByteArray &message)
+{
+    if (!isFragment(text))
+        return NotFragment;
+
+    quint32 id, index, count;
+    if (!readHex(text.data() + 1, 4, id) || !readHex(text.data() + 5, 2, index)
+        || !readHex(text.data() + 7, 2, count) || count == 0 || index >= count) {
+        return Dropped;
+    }
+    const QByteArrayView chunk = text.sliced(HeaderSize);
+
+    QByteArray key;
+    key.reserve(sender.size() + 5);
+    key.append(sender).append('\0').append(text.sliced(1, 4));
+
+    auto it = m_partials.find(key);
+    if (index == 0) {
+        // Un índice 0 siempre inicia el mensaje, aunque hubiera uno a medias.
+        if (it != m_partials.end())
+            drop(it);
+
+        if (count == 1) {
+            message = chunk.toByteArray();
+            return Complete;
+        }
+
+        const qsizetype reserved = qsizetype(count) * MaxChunk;
+        if (m_partials.size() >= MaxPending || m_bufferedBytes + reserved > MaxBufferedBytes)
+            return Dropped;
+
+        Partial partial;
+        partial.data.reserve(reserved);
+        partial.data.append(chunk);
+        partial.next = 1;
+        partial.count = int(count);
+        partial.deadline = nowMs + TimeoutMs;
+        m_partials.insert(key, std::move(partial));
+        m_bufferedBytes += reserved;
+        return Incomplete;
+    }
+
+    // El servidor reenvía en orden, así que un hueco significa que se perdió
+    // un fragmento y el mensaje ya no se puede reconstruir.
+    if (it == m_partials.end())
+        return Dropped;
+    if (int(index) != it->next || int(count) != it->count) {
+        drop(it);
+        return Dropped;
+    }
+
+    it->data.append(chunk);
+    if (++it->next < it->count)
+        return Incomplete;
+
+    message = std::move(it->data);
+    drop(it);
+    return Complete;
+}
+
+int Reassembler::expire(qint64 nowMs) {
+    int expired = 0;
+    for (auto it = m_partials.begin(); it != m_partials.end();) {
+        if (it->deadline <= nowMs) {
+            m_bufferedBytes -= qsizetype(it->count) * MaxChunk;
+            it = m_partials.erase(it);
+            ++expired;
+        } else {
+            ++it;
+        }
+    }
+    return expired;
+}
+
+void Reassembler::clear() {
+    m_partials.clear();
+    m_bufferedBytes = 0;
+}
+
+void Reassembler::drop(QHash<QByteArray, Partial>::iterator it) {
+    m_bufferedBytes -= qsizetype(it->count) * MaxChunk;
+    m_partials.erase(it);
+}
+
+} // namespace Fragmentation
@@ -0,0 +1,90 @@
+#ifndef FRAGMENTATION_H
+#define FRAGMENTATION_H
+#pragma once
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QHash>
+#include <QVarLengthArray>
+
+// Transporte fragmentado para mensajes de más de 255 bytes.
+//
+// Los opcodes 4 y 55 solo admiten un byte de longitud, así que un mensaje
+// largo se envía como varios mensajes normales cuyo texto empieza con una
+// cabecera ASCII de 9 bytes:
+//
+//     0x1E  id (4 hex)  índice (2 hex)  total (2 hex)  fragmento UTF-8...
+//
+// El servidor los reenvía sin cambios y el receptor los reensambla. Los
+// cortes siempre caen en un límite de code point, así que cada fragmento es
+// UTF-8 válido por sí mismo.
+namespace Fragmentation {
+
+constexpr char Marker = '\x1E';
+constexpr qsizetype HeaderSize = 9;
+constexpr qsizetype MaxChunk = 255 - HeaderSize;
+constexpr int MaxFragments = 255;
+constexpr qsizetype MaxMessageSize = MaxChunk * MaxFragments;
+
+bool isFragment(QByteArrayView text);
+
+// Divide un mensaje ya codificado en fragmentos que caben en un campo de
+// 255 bytes. Solo guarda los puntos de corte: no copia el texto.
+class Splitter {
+public:
+    Splitter(QByteArrayView utf8, quint16 messageId);
+
+    int count() const { return int(m_ends.size()); }
+    // Cabecera de 9 bytes del fragmento `index`, válida hasta la siguiente llamada.
+    QByteArrayView header(int index);
+    QByteArrayView chunk(int index) const;
+    bool truncated() const { return m_truncated; }
+
+private:
+    QByteArrayView m_text;
+    quint16 m_messageId;
+    QVarLengthArray<qsizetype, 16> m_ends;
+    bool m_truncated = false;
+    char m_header[HeaderSize];
+};
+
+// Reensambla fragmentos por (remitente, id). Cada fragmento se copia una
+// única vez, directamente al buffer final del mensaje, y la memoria total
+// retenida está acotada por MaxPending y MaxBufferedBytes.
+class Reassembler {
+public:
+    enum Result {
+        NotFragment,  // texto normal, se entrega tal cual
+        Incomplete,   // fragmento aceptado, faltan más
+        Complete,     // mensaje completo en `message`
+        Dropped       // fragmento inválido, fuera de orden o sin espacio
+    };
+
+    static constexpr int MaxPending = 64;
+    static constexpr qsizetype MaxBufferedBytes = 4 * 1024 * 1024;
+    static constexpr qint64 TimeoutMs = 30000;
+
+    Result feed(QByteArrayView sender, QByteArrayView text, qint64 nowMs, QByteArray &message);
+    // Descarta los mensajes parciales cuyo plazo ya venció.
+    int expire(qint64 nowMs);
+    int pendingCount() const { return int(m_partials.size()); }
+    qsizetype bufferedBytes() const { return m_bufferedBytes; }
+    void clear();
+
+private:
+    struct Partial {
+        QByteArray data;
+        int next = 0;
+        int count = 0;
+        qint64 deadline = 0;
+    };
+
+    void drop(QHash<QByteArray, Partial>::iterator it);
+
+    QHash<QByteArray, Partial> m_partials;
+    qsizetype m_bufferedBytes = 0;
+};
+
+} // namespace Fragmentation
+
+#endif // FRAGMENTATION_H
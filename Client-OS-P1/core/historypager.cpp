@@ -0,0 +1,67 @@
+#include "historypager.h"
+
+HistoryPager::Request HistoryPager::newest(const QString &chat) {
+    ++m_generation;
+    m_chat = chat;
+    m_cursor = 0;
+    m_hasMore = false;
+    m_olderInFlight = false;
+    return enqueue(0, false);
+}
+
+bool HistoryPager::older(Request &out) {
+    if (m_chat.isEmpty() || !m_hasMore || m_olderInFlight)
+        return false;
+    m_olderInFlight = true;
+    out = enqueue(m_cursor, true);
+    return true;
+}
+
+bool HistoryPager::complete(bool hasCursor, quint32 nextCursor, Request &answered) {
+    if (m_pending.isEmpty())
+        return false;
+
+    Pending pending = m_pending.dequeue();
+    answered = pending.request;
+    adapt(pending.sent.elapsed());
+
+    // Respuestas pedidas antes del último newest() o clear() no cambian el cursor.
+    if (!isCurrent(answered))
+        return true;
+
+    if (answered.older)
+        m_olderInFlight = false;
+    m_cursor = nextCursor;
+    m_hasMore = hasCursor && nextCursor != 0;
+    return true;
+}
+
+void HistoryPager::clear() {
+    ++m_generation;
+    m_chat.clear();
+    m_cursor = 0;
+    m_hasMore = false;
+    m_olderInFlight = false;
+    m_pending.clear();
+}
+
+HistoryPager::Request HistoryPager::enqueue(quint32 cursor, bool older) {
+    Pending pending;
+    pending.request.chat = m_chat;
+    pending.request.cursor = cursor;
+    pending.request.limit = quint8(m_pageSize);
+    pending.request.older = older;
+    pending.request.generation = m_generation;
+    pending.sent.start();
+    m_pending.enqueue(pending);
+    return pending.request;
+}
+
+void HistoryPager::adapt(qint64 rttMs) {
+    // Crecimiento multiplicativo cuando sobra margen, reducción a la mitad
+    // cuando la página tarda más que el objetivo.
+    if (rttMs < TargetRttMs / 2)
+        m_pageSize = qMin(m_pageSize * 2, MaxPageSize);
+    else if (rttMs > TargetRttMs)
+        m_pageSize = qMax(m_pageSize / 2, MinPageSize);
+}
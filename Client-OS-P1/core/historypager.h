@@ -0,0 +1,68 @@
+#ifndef HISTORYPAGER_H
+#define HISTORYPAGER_H
+#pragma once
+
+#include <QElapsedTimer>
+#include <QQueue>
+#include <QString>
+
+// Paginación del historial de un chat.
+//
+// La primera página es la más reciente; las siguientes se piden con el
+// cursor opaco que devolvió el servidor en la página anterior, así que el
+// costo de cambiar de chat no depende del largo del historial. El tamaño de
+// página se ajusta según el tiempo de ida y vuelta medido: crece mientras las
+// páginas llegan rápido y se reduce cuando superan el objetivo.
+class HistoryPager {
+public:
+    struct Request {
+        QString chat;
+        quint32 cursor = 0;
+        quint8 limit = 0;
+        bool older = false;
+        // newest() y clear() abren una generación nueva; una respuesta de
+        // una generación anterior ya no corresponde a lo que se muestra.
+        quint32 generation = 0;
+    };
+
+    static constexpr int MinPageSize = 20;
+    static constexpr int MaxPageSize = 255;
+    static constexpr int InitialPageSize = 50;
+    static constexpr qint64 TargetRttMs = 150;
+
+    // Primera página de un chat; descarta el estado del chat anterior.
+    Request newest(const QString &chat);
+    // Página anterior del chat actual. Devuelve false si no hay más páginas
+    // o si ya hay una en camino.
+    bool older(Request &out);
+    // Registra la respuesta (opcode 56) y devuelve la solicitud que contesta.
+    // Las respuestas llegan en el mismo orden en que se enviaron; las de una
+    // generación vieja no cambian el cursor.
+    bool complete(bool hasCursor, quint32 nextCursor, Request &answered);
+    bool isCurrent(const Request &request) const { return request.generation == m_generation; }
+
+    bool hasMore() const { return m_hasMore; }
+    bool olderInFlight() const { return m_olderInFlight; }
+    int pageSize() const { return m_pageSize; }
+    QString chat() const { return m_chat; }
+    void clear();
+
+private:
+    struct Pending {
+        Request request;
+        QElapsedTimer sent;
+    };
+
+    Request enqueue(quint32 cursor, bool older);
+    void adapt(qint64 rttMs);
+
+    QString m_chat;
+    quint32 m_cursor = 0;
+    bool m_hasMore = false;
+    bool m_olderInFlight = false;
+    int m_pageSize = InitialPageSize;
+    quint32 m_generation = 0;
+    QQueue<Pending> m_pending;
+};
+
+#endif // HISTORYPAGER_H
@@ -0,0 +1,78 @@
+#include "latencyhistogram.h"
+
+#include <QtAlgorithms>
+
+#include <cmath>
+
+int LatencyHistogram::bucketOf(quint64 value) {
+    if (value < 2 * SubBuckets)
+        return int(value);
+    // Exponente relativo a la primera potencia de dos con subcubetas
+    const int shift = 63 - qCountLeadingZeroBits(value) - SubBucketBits;
+    return shift * SubBuckets + int(value >> shift);
+}
+
+quint64 LatencyHistogram::upperBoundOf(int bucket) {
+    if (bucket < 2 * SubBuckets)
+        return quint64(bucket);
+    const int shift = bucket / SubBuckets - 1;
+    const quint64 sub = quint64(bucket % SubBuckets + SubBuckets);
+    return ((sub + 1) << shift) - 1;
+}
+
+void LatencyHistogram::record(qint64 nanos) {
+    // Un reloj que retrocede entre hilos no debe producir valores negativos
+    const qint64 value = qMax<qint64>(nanos, 0);
+    ++m_counts[bucketOf(quint64(value))];
+    if (m_count == 0 || value < m_min)
+        m_min = value;
+    if (value > m_max)
+        m_max = value;
+    ++m_count;
+    m_sum += quint64(value);
+}
+
+void LatencyHistogram::merge(const LatencyHistogram &other) {
+    if (other.m_count == 0)
+        return;
+    for (int i = 0; i < BucketCount; ++i)
+        m_counts[i] += other.m_counts[i];
+    m_min = m_count ? qMin(m_min, other.m_min) : other.m_min;
+    m_max = qMax(m_max, other.m_max);
+    m_count += other.m_count;
+    m_sum += other.m_sum;
+}
+
+void LatencyHistogram::reset() {
+    m_counts.fill(0);
+    m_count = 0;
+    m_sum = 0;
+    m_min = 0;
+    m_max = 0;
+}
+
+qint64 LatencyHistogram::percentile(double percent) const {
+    if (m_count == 0)
+        return 0;
+    if (percent >= 100.0)
+        return m_max;
+
+    const quint64 rank = qMax<quint64>(1, quint64(std::ceil(percent / 100.0 * double(m_count))));
+    quint64 seen = 0;
+    for (int i = 0; i < BucketCount; ++i) {
+        seen += m_counts[i];
+        if (seen >= rank)
+            return qMin(qint64(upperBoundOf(i)), m_max);
+    }
+    return m_max;
+}
+
+QString LatencyHistogram::format(qint64 nanos) {
+    if (nanos < 1000)
+        return QString::number(nanos) + " ns";
+    if (nanos < 1000 * 1000)
+        return QString::number(double(nanos) / 1e3, 'f', 1) + " µs";
+    if (nanos < 1000 * 1000 * 1000)
+        return QString::number(double(nanos) / 1e6, 'f', 2) + " ms";
+    return QString::number(double(nanos) / 1e9, 'f', 2) + " s";
+}
@@ -0,0 +1,51 @@
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+#pragma once
+
+#include <QString>
+#include <QtGlobal>
+
+#include <array>
+
+// Histograma de latencias en nanosegundos con error relativo acotado.
+//
+// Cubetas log-lineales, al estilo de HdrHistogram: los valores menores que
+// 2 * SubBuckets se guardan exactos y cada potencia de dos por encima se
+// divide en SubBuckets cubetas iguales, así que cualquier percentil tiene un
+// error de a lo sumo 1/SubBuckets (~3 %). Registrar es O(1) y no reserva
+// memoria; combinar histogramas de varios hilos es sumar cubetas.
+//
+// No es seguro entre hilos: cada hilo registra en el suyo y se combinan al
+// final con merge().
+class LatencyHistogram {
+public:
+    static constexpr int SubBucketBits = 5;
+    static constexpr int SubBuckets = 1 << SubBucketBits;
+    static constexpr int BucketCount = (64 - SubBucketBits) * SubBuckets;
+
+    void record(qint64 nanos);
+    void merge(const LatencyHistogram &other);
+    void reset();
+
+    quint64 count() const { return m_count; }
+    qint64 min() const { return m_count ? m_min : 0; }
+    qint64 max() const { return m_max; }
+    qint64 mean() const { return m_count ? qint64(m_sum / m_count) : 0; }
+    // Valor bajo el cual cae el `percent` % de las muestras (0 a 100).
+    qint64 percentile(double percent) const;
+
+    // "850 ns", "12.4 µs", "3.07 ms", "1.20 s"
+    static QString format(qint64 nanos);
+
+private:
+    static int bucketOf(quint64 value);
+    static quint64 upperBoundOf(int bucket);
+
+    std::array<quint64, BucketCount> m_counts{};
+    quint64 m_count = 0;
+    quint64 m_sum = 0;
+    qint64 m_min = 0;
+    qint64 m_max = 0;
+};
+
+#endif // LATENCYHISTOGRAM_H
@@ -0,0 +1,46 @@
+#include "latencytracker.h"
+
+#include <QMutexLocker>
+
+qint64 LatencyTracker::sloNanos(Action action) {
+    constexpr qint64 Ms = 1000 * 1000;
+    switch (action) {
+    case MessageEcho: return 300 * Ms;
+    case HistoryPage: return 500 * Ms;
+    case UserList: return 500 * Ms;
+    case ActionCount: break;
+    }
+    return 0;
+}
+
+QString LatencyTracker::actionName(Action action) {
+    switch (action) {
+    case MessageEcho: return QStringLiteral("Envío de mensaje");
+    case HistoryPage: return QStringLiteral("Página de historial");
+    case UserList: return QStringLiteral("Lista de usuarios");
+    case ActionCount: break;
+    }
+    return QString();
+}
+
+void LatencyTracker::record(Action action, qint64 nanos) {
+    QMutexLocker locker(&m_mutex);
+    m_histograms[action].record(nanos);
+}
+
+void LatencyTracker::reset() {
+    QMutexLocker locker(&m_mutex);
+    for (LatencyHistogram &histogram : m_histograms)
+        histogram.reset();
+}
+
+LatencyTracker::Summary LatencyTracker::summary(Action action) const {
+    QMutexLocker locker(&m_mutex);
+    const LatencyHistogram &histogram = m_histograms[action];
+    return Summary{histogram.count(), histogram.percentile(50.0), histogram.percentile(99.0), histogram.max()};
+}
+
+LatencyHistogram LatencyTracker::histogram(Action action) const {
+    QMutexLocker locker(&m_mutex);
+    return m_histograms[action];
+}
@@ -0,0 +1,47 @@
+#ifndef LATENCYTRACKER_H
+#define LATENCYTRACKER_H
+#pragma once
+
+#include <QMutex>
+#include <QString>
+
+#include <array>
+
+#include "latencyhistogram.h"
+
+// Tiempos de ida y vuelta de las acciones que el usuario percibe.
+//
+// NetworkWorker registra desde el hilo de red; la interfaz lee resúmenes o
+// copias de los histogramas desde el suyo. El registro es de baja frecuencia
+// (una muestra por mensaje enviado o página pedida), así que basta un mutex.
+class LatencyTracker {
+public:
+    enum Action {
+        MessageEcho,    // opcode 4 -> eco 55 del propio mensaje
+        HistoryPage,    // opcode 5 -> 56
+        UserList,       // opcode 1 -> 51
+        ActionCount
+    };
+
+    struct Summary {
+        quint64 count = 0;
+        qint64 p50 = 0;
+        qint64 p99 = 0;
+        qint64 max = 0;
+    };
+
+    // Objetivo de p99 por acción, en nanosegundos.
+    static qint64 sloNanos(Action action);
+    static QString actionName(Action action);
+
+    void record(Action action, qint64 nanos);
+    void reset();
+    Summary summary(Action action) const;
+    LatencyHistogram histogram(Action action) const;
+
+private:
+    mutable QMutex m_mutex;
+    std::array<LatencyHistogram, ActionCount> m_histograms;
+};
+
+#endif // LATENCYTRACKER_H
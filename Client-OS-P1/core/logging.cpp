@@ -0,0 +1,116 @@
+#include "logging.h"
+
+#include <QDateTime>
+#include <QFile>
+#include <QList>
+#include <QMutex>
+#include <QMutexLocker>
+
+Q_LOGGING_CATEGORY(lcProtocol, "chat.protocol", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcRender, "chat.render", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcRoster, "chat.roster", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcPresence, "chat.presence", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcStorage, "chat.storage", QtInfoMsg)
+
+namespace {
+
+struct Line {
+    qint64 time = 0;
+    QtMsgType type = QtDebugMsg;
+    const char *category = nullptr;   // literal de Q_LOGGING_CATEGORY
+    QString message;
+};
+
+// Búfer circular de tamaño fijo: escribir nunca reserva memoria nueva
+// salvo por el texto del mensaje.
+struct Ring {
+    QMutex mutex;
+    QList<Line> lines = QList<Line>(Logging::RingSize);
+    qsizetype next = 0;
+    bool wrapped = false;
+};
+
+Ring &ring() {
+    static Ring instance;
+    return instance;
+}
+
+QtMessageHandler previousHandler = nullptr;
+
+const char *typeName(QtMsgType type) {
+    switch (type) {
+    case QtDebugMsg:    return "D";
+    case QtInfoMsg:     return "I";
+    case QtWarningMsg:  return "W";
+    case QtCriticalMsg: return "C";
+    case QtFatalMsg:    return "F";
+    }
+    return "?";
+}
+
+void handler(QtMsgType type, const QMessageLogContext &context, const QString &message) {
+    {
+        Ring &r = ring();
+        QMutexLocker locker(&r.mutex);
+        Line &line = r.lines[r.next];
+        line.time = QDateTime::currentMSecsSinceEpoch();
+        line.type = type;
+        line.category = context.category;
+        line.message = message;
+        if (++r.next == r.lines.size()) {
+            r.next = 0;
+            r.wrapped = true;
+        }
+    }
+
+    if (type != QtDebugMsg && type != QtInfoMsg && previousHandler)
+        previousHandler(type, context, message);
+}
+
+} // namespace
+
+namespace Logging {
+
+void install() {
+    if (!previousHandler)
+        previousHandler = qInstallMessageHandler(handler);
+}
+
+QString dump() {
+    Ring &r = ring();
+    QMutexLocker locker(&r.mutex);
+
+    QString out;
+    const qsizetype count = r.wrapped ? r.lines.size() : r.next;
+    const qsizetype first = r.wrapped ? r.next : 0;
+    for (qsizetype i = 0; i < count; ++i) {
+        const Line &line = r.lines.at((first + i) % r.lines.size());
+        out += QDateTime::fromMSecsSinceEpoch(line.time).toString("hh:mm:ss.zzz");
+        out += QLatin1Char(' ');
+        out += QLatin1String(typeName(line.type));
+        out += QLatin1Char(' ');
+        out += QLatin1String(line.category ? line.category : "default");
+        out += QLatin1String(": ");
+        out += line.message;
+        out += QLatin1Char('\n');
+    }
+    return out;
+}
+
+bool dumpToFile(const QString &path) {
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text))
+        return false;
+    return file.write(dump().toUtf8()) >= 0;
+}
+
+qsizetype memoryUsage() {
+    Ring &r = ring();
+    QMutexLocker locker(&r.mutex);
+    qsizetype bytes = r.lines.capacity() * qsizetype(sizeof(Line));
+    for (const Line &line : r.lines)
+        bytes += line.message.capacity() * qsizetype(sizeof(QChar));
+    return bytes;
+}
+
+} // namespace Logging
@@ -0,0 +1,38 @@
+#ifndef LOGGING_H
+#define LOGGING_H
+#pragma once
+
+#include <QLoggingCategory>
+#include <QString>
+
+// Categorías de log por subsistema.
+//
+// Se usan con qCDebug/qCInfo/qCWarning: si el nivel está apagado el mensaje
+// cuesta una sola comparación y sus argumentos ni se evalúan; en compilación
+// release QT_NO_DEBUG_OUTPUT elimina del todo los qCDebug. Por defecto solo
+// están activos info y superiores; para depurar, por ejemplo:
+//   QT_LOGGING_RULES="chat.protocol.debug=true"
+Q_DECLARE_LOGGING_CATEGORY(lcProtocol)   // frames, envío y recepción
+Q_DECLARE_LOGGING_CATEGORY(lcRender)     // mensajes en pantalla e historial
+Q_DECLARE_LOGGING_CATEGORY(lcRoster)     // lista de usuarios
+Q_DECLARE_LOGGING_CATEGORY(lcPresence)   // cambios de estado
+Q_DECLARE_LOGGING_CATEGORY(lcStorage)    // registro en disco
+
+namespace Logging {
+
+// Líneas que se conservan en memoria.
+constexpr int RingSize = 4096;
+
+// Instala el manejador que guarda cada mensaje emitido en un búfer circular
+// en memoria. Solo las advertencias y errores siguen además a stderr.
+void install();
+
+// Contenido del búfer, del más antiguo al más reciente, una línea por mensaje.
+QString dump();
+bool dumpToFile(const QString &path);
+// Memoria aproximada del búfer, en bytes.
+qsizetype memoryUsage();
+
+} // namespace Logging
+
+#endif // LOGGING_H
@@ -0,0 +1,390 @@
+#include "messagelog.h"
+
+#include <QCryptographicHash>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QSaveFile>
+#include <QSet>
+#include <QStandardPaths>
+#include <QThread>
+#include <QtEndian>
+
+#include <cstring>
+
+#include "logging.h"
+
+namespace {
+
+constexpr int RecordHeader = 4 + 8 + 1;
+constexpr int IndexEntrySize = 8 + 4 + 4;
+// Ventana para agrupar escrituras que llegan casi juntas en un solo flush.
+constexpr unsigned long GroupCommitMs = 5;
+
+struct IndexEntry {
+    quint64 record = 0;
+    quint32 segment = 0;
+    quint32 offset = 0;
+};
+
+const QString PositionFile = QStringLiteral("position");
+
+QString segmentName(quint32 segment) {
+    return QString("%1.log").arg(segment, 8, 10, QLatin1Char('0'));
+}
+
+QByteArray encodeRecord(const LogRecord &record) {
+    const QByteArray sender = record.sender.toUtf8().left(255);
+    const QByteArray text = record.text.toUtf8();
+    const quint32 length = quint32(8 + 1 + sender.size() + text.size());
+
+    QByteArray bytes(4 + qsizetype(length), Qt::Uninitialized);
+    char *out = bytes.data();
+    qToLittleEndian<quint32>(length, out);
+    qToLittleEndian<qint64>(record.timestamp, out + 4);
+    out[12] = char(quint8(sender.size()));
+    std::memcpy(out + RecordHeader, sender.constData(), sender.size());
+    std::memcpy(out + RecordHeader + sender.size(), text.constData(), text.size());
+    return bytes;
+}
+
+// Recorre los registros de un segmento mapeado desde `offset`. Devuelve el
+// final del último registro válido; un registro truncado (por ejemplo tras un
+// cierre abrupto) marca el final.
+template <typename Visitor>
+qint64 walkSegment(const uchar *data, qint64 size, qint64 offset, Visitor visit) {
+    while (size - offset >= 4) {
+        const quint32 length = qFromLittleEndian<quint32>(data + offset);
+        if (length < RecordHeader - 4 || size - offset - 4 < qint64(length))
+            break;
+        const uchar *p = data + offset;
+        const int senderLength = p[12];
+        if (int(length) < 8 + 1 + senderLength)
+            break;
+        visit(p, length, senderLength);
+        offset += 4 + qint64(length);
+    }
+    return offset;
+}
+
+LogRecord decodeRecord(const uchar *p, quint32 length, int senderLength) {
+    LogRecord record;
+    record.timestamp = qFromLittleEndian<qint64>(p + 4);
+    const char *sender = reinterpret_cast<const char *>(p + RecordHeader);
+    record.sender = QString::fromUtf8(sender, senderLength);
+    record.text = QString::fromUtf8(sender + senderLength, qsizetype(length) - 9 - senderLength);
+    return record;
+}
+
+QList<IndexEntry> readIndex(const QString &path) {
+    QList<IndexEntry> entries;
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly) || file.size() < IndexEntrySize)
+        return entries;
+
+    const qint64 count = file.size() / IndexEntrySize;
+    const uchar *data = file.map(0, count * IndexEntrySize);
+    if (!data)
+        return entries;
+
+    entries.reserve(count);
+    for (qint64 i = 0; i < count; ++i) {
+        const uchar *p = data + i * IndexEntrySize;
+        entries.append({qFromLittleEndian<quint64>(p), qFromLittleEndian<quint32>(p + 8),
+                        qFromLittleEndian<quint32>(p + 12)});
+    }
+    file.unmap(const_cast<uchar *>(data));
+    return entries;
+}
+
+// Recorre los segmentos desde `start` hasta el final, llamando a `visit` con
+// el número de registro de cada uno. Devuelve el número del siguiente
+// registro y deja en `lastSize` los bytes válidos del último segmento.
+template <typename Visitor>
+quint64 walkFrom(const QString &directory, const QList<quint32> &segments, const IndexEntry &start,
+                 qint64 &lastSize, Visitor visit) {
+    quint64 record = start.record;
+    for (quint32 segment : segments) {
+        if (segment < start.segment)
+            continue;
+
+        QFile file(directory + '/' + segmentName(segment));
+        if (!file.open(QIODevice::ReadOnly))
+            break;
+        lastSize = 0;
+        if (file.size() == 0)
+            continue;
+
+        const uchar *data = file.map(0, file.size());
+        if (!data)
+            break;
+        const qint64 offset = segment == start.segment ? start.offset : 0;
+        lastSize = walkSegment(data, file.size(), offset, [&](const uchar *p, quint32 length, int senderLength) {
+            visit(record++, p, length, senderLength);
+        });
+        file.unmap(const_cast<uchar *>(data));
+    }
+    return record;
+}
+
+} // namespace
+
+MessageLog::MessageLog(const QString &directory)
+    : m_directory(directory)
+{
+    QDir().mkpath(m_directory);
+    m_writer = QThread::create([this] { writerLoop(); });
+    m_writer->start();
+}
+
+MessageLog::~MessageLog() {
+    {
+        QMutexLocker locker(&m_mutex);
+        m_stopping = true;
+    }
+    m_wake.wakeAll();
+    m_writer->wait();
+    delete m_writer;
+}
+
+QString MessageLog::defaultDirectory(const QString &server, const QString &username) {
+    // Nombre de directorio estable y seguro para cualquier servidor/usuario
+    const QByteArray key = QCryptographicHash::hash((server + '\n' + username).toUtf8(),
+                                                    QCryptographicHash::Sha1).toHex();
+    return QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation)
+           + "/history/" + QString::fromLatin1(key);
+}
+
+QList<LogRecord> MessageLog::tail(const QString &name, int count) {
+    const Conversation &conv = conversation(name);
+    const qsizetype start = qMax<qsizetype>(0, conv.recent.size() - count);
+    return conv.recent.mid(start);
+}
+
+QList<LogRecord> MessageLog::sync(const QString &name, const QList<LogRecord> &page,
+                                  const QList<quint64> &positions) {
+    Q_ASSERT(positions.size() == page.size());
+    Conversation &conv = conversation(name);
+
+    // Lo anterior a serverEnd ya está registrado. Si la página empieza
+    // después, los mensajes intermedios no se vieron nunca y se pierden.
+    QList<LogRecord> fresh;
+    for (qsizetype i = 0; i < page.size(); ++i) {
+        if (positions.at(i) < conv.serverEnd)
+            continue;
+        append(conv, page.at(i), positions.at(i) + 1);
+        fresh.append(page.at(i));
+    }
+    return fresh;
+}
+
+QList<LogRecord> MessageLog::sync(const QString &name, const QList<LogRecord> &page) {
+    Conversation &conv = conversation(name);
+    const QList<LogRecord> &recent = conv.recent;
+    const qsizetype size = recent.size();
+
+    // Fin de lo ya registrado en la página: el mayor `end` tal que los
+    // últimos min(end, size) registros son page[..end). La hora no cuenta:
+    // el historial no la trae.
+    auto same = [](const LogRecord &a, const LogRecord &b) {
+        return a.sender == b.sender && a.text == b.text;
+    };
+    qsizetype end = 0;
+    for (qsizetype e = page.size(); e > 0 && end == 0; --e) {
+        const qsizetype n = qMin(e, size);
+        qsizetype i = 0;
+        while (i < n && same(recent.at(size - n + i), page.at(e - n + i)))
+            ++i;
+        if (n > 0 && i == n)
+            end = e;
+    }
+
+    const QList<LogRecord> fresh = page.mid(end);
+    for (const LogRecord &record : fresh)
+        append(conv, record, conv.serverEnd);
+    return fresh;
+}
+
+void MessageLog::flush() {
+    QMutexLocker locker(&m_mutex);
+    while (!m_queue.isEmpty() || m_writing)
+        m_drained.wait(&m_mutex);
+}
+
+MessageLog::Conversation &MessageLog::conversation(const QString &name) {
+    auto it = m_conversations.find(name);
+    if (it != m_conversations.end())
+        return *it;
+
+    Conversation conv;
+    conv.directory = m_directory + '/' + QString::fromLatin1(name.toUtf8().toHex());
+    load(conv);
+    return *m_conversations.insert(name, conv);
+}
+
+void MessageLog::load(Conversation &conv) {
+    QDir dir(conv.directory);
+    const QStringList files = dir.entryList({"*.log"}, QDir::Files, QDir::Name);
+    if (files.isEmpty())
+        return;
+
+    QList<quint32> segments;
+    segments.reserve(files.size());
+    for (const QString &file : files)
+        segments.append(file.section('.', 0, 0).toUInt());
+    conv.lastSegment = segments.last();
+
+    // 1. Contar registros desde la última entrada del índice disperso
+    const QList<IndexEntry> index = readIndex(conv.directory + "/index.idx");
+    IndexEntry first;
+    first.segment = segments.first();
+    const IndexEntry last = index.isEmpty() ? first : index.last();
+
+    qint64 lastSize = 0;
+    conv.recordCount = walkFrom(conv.directory, segments, last, lastSize,
+                                [](quint64, const uchar *, quint32, int) {});
+    conv.lastSegmentSize = lastSize;
+
+    // Un registro sin posición guardada se supone alineado con el comienzo
+    // del historial del servidor
+    conv.serverEnd = conv.recordCount;
+    QFile position(conv.directory + '/' + PositionFile);
+    if (position.open(QIODevice::ReadOnly) && position.size() == 8) {
+        const QByteArray bytes = position.readAll();
+        conv.serverEnd = qFromLittleEndian<quint64>(bytes.constData());
+    }
+
+    // 2. Leer solo la cola, arrancando desde la entrada del índice más cercana
+    const quint64 target = conv.recordCount > quint64(CacheSize) ? conv.recordCount - CacheSize : 0;
+    IndexEntry start = first;
+    for (auto it = index.crbegin(); it != index.crend(); ++it) {
+        if (it->record <= target) {
+            start = *it;
+            break;
+        }
+    }
+
+    conv.recent.reserve(CacheSize);
+    walkFrom(conv.directory, segments, start, lastSize,
+             [&](quint64 record, const uchar *p, quint32 length, int senderLength) {
+        if (record >= target)
+            conv.recent.append(decodeRecord(p, length, senderLength));
+    });
+}
+
+void MessageLog::append(Conversation &conv, const LogRecord &record, quint64 serverEnd) {
+    conv.serverEnd = serverEnd;
+
+    PendingWrite write;
+    write.directory = conv.directory;
+    write.recordNumber = conv.recordCount++;
+    write.segment = conv.lastSegment;
+    write.segmentSize = conv.lastSegmentSize;
+    write.serverEnd = serverEnd;
+    write.bytes = encodeRecord(record);
+
+    conv.recent.append(record);
+    if (conv.recent.size() > CacheSize)
+        conv.recent.removeFirst();
+
+    {
+        QMutexLocker locker(&m_mutex);
+        m_queue.append(std::move(write));
+    }
+    m_wake.wakeOne();
+}
+
+void MessageLog::writerLoop() {
+    struct Writer {
+        QString directory;
+        QFile segment;
+        QFile index;
+        quint32 segmentNumber = 0;
+        qint64 size = 0;
+        quint64 serverEnd = 0;
+    };
+    QHash<QString, Writer *> writers;
+
+    forever {
+        QList<PendingWrite> batch;
+        {
+            QMutexLocker locker(&m_mutex);
+            while (m_queue.isEmpty() && !m_stopping)
+                m_wake.wait(&m_mutex);
+            if (m_queue.isEmpty())
+                break;
+            // Commit en grupo: damos unos milisegundos para que se sumen
+            // más mensajes al mismo lote.
+            if (!m_stopping)
+                m_wake.wait(&m_mutex, GroupCommitMs);
+            batch.swap(m_queue);
+            m_writing = true;
+        }
+
+        QSet<Writer *> touched;
+        for (const PendingWrite &write : batch) {
+            Writer *writer = writers.value(write.directory);
+            if (!writer) {
+                writer = new Writer;
+                writers.insert(write.directory, writer);
+                writer->directory = write.directory;
+                QDir().mkpath(write.directory);
+                writer->segmentNumber = write.segment;
+                writer->segment.setFileName(write.directory + '/' + segmentName(write.segment));
+                writer->index.setFileName(write.directory + "/index.idx");
+                if (!writer->segment.open(QIODevice::ReadWrite) || !writer->index.open(QIODevice::Append)) {
+                    qCWarning(lcStorage) << "MessageLog: no se pudo abrir" << writer->segment.fileName();
+                    continue;
+                }
+                // Descarta un registro truncado al final del segmento
+                writer->segment.resize(write.segmentSize);
+                writer->segment.seek(write.segmentSize);
+                writer->size = write.segmentSize;
+            }
+            if (!writer->segment.isOpen())
+                continue;
+
+            if (writer->size > 0 && writer->size + write.bytes.size() > SegmentSize) {
+                writer->segment.close();
+                writer->segment.setFileName(write.directory + '/' + segmentName(++writer->segmentNumber));
+                writer->segment.open(QIODevice::WriteOnly | QIODevice::Truncate);
+                writer->size = 0;
+            }
+
+            if (write.recordNumber % IndexInterval == 0) {
+                char entry[IndexEntrySize];
+                qToLittleEndian<quint64>(write.recordNumber, entry);
+                qToLittleEndian<quint32>(writer->segmentNumber, entry + 8);
+                qToLittleEndian<quint32>(quint32(writer->size), entry + 12);
+                writer->index.write(entry, IndexEntrySize);
+            }
+
+            writer->segment.write(write.bytes);
+            writer->size += write.bytes.size();
+            writer->serverEnd = write.serverEnd;
+            touched.insert(writer);
+        }
+
+        for (Writer *writer : std::as_const(touched)) {
+            writer->segment.flush();
+            writer->index.flush();
+
+            // La posición se escribe después de los registros: tras un corte
+            // puede quedar atrás (y repetir algún mensaje), nunca adelante.
+            QSaveFile position(writer->directory + '/' + PositionFile);
+            char bytes[8];
+            qToLittleEndian<quint64>(writer->serverEnd, bytes);
+            if (!position.open(QIODevice::WriteOnly) || position.write(bytes, 8) != 8 || !position.commit())
+                qCWarning(lcStorage) << "MessageLog: no se pudo guardar la posición en" << writer->directory;
+        }
+
+        {
+            QMutexLocker locker(&m_mutex);
+            m_writing = false;
+            if (m_queue.isEmpty())
+                m_drained.wakeAll();
+        }
+    }
+
+    qDeleteAll(writers);
+}
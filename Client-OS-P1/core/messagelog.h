@@ -0,0 +1,102 @@
+#ifndef MESSAGELOG_H
+#define MESSAGELOG_H
+#pragma once
+
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QString>
+#include <QWaitCondition>
+
+class QThread;
+
+struct LogRecord {
+    QString sender;
+    QString text;
+    qint64 timestamp = 0;
+};
+
+// Registro local, solo de anexado, de los mensajes de cada conversación.
+//
+// Cada conversación vive en su propio directorio con segmentos de hasta
+// SegmentSize bytes y un índice disperso (una entrada cada IndexInterval
+// registros) que permite llegar a la cola sin recorrer todo el archivo. Las
+// lecturas se hacen sobre el archivo mapeado en memoria; las escrituras se
+// encolan y un hilo propio las agrupa, con un solo flush por lote.
+//
+// Formato de un registro (little-endian):
+//     [u32 largo][i64 timestamp ms][u8 largo remitente][remitente][texto]
+// donde `largo` cuenta todo lo que sigue al propio campo. Un timestamp 0
+// significa que la hora se desconoce (el historial del servidor no la trae).
+//
+// El registro solo recibe mensajes del historial del servidor, en orden, así
+// que cada conversación recuerda en `position` (u64) la posición del servidor
+// que sigue a su último registro. Las páginas sin cursor no traen posiciones
+// y se alinean por contenido.
+class MessageLog {
+public:
+    static constexpr qint64 SegmentSize = 8 * 1024 * 1024;
+    static constexpr int IndexInterval = 32;
+    // Registros recientes que se mantienen en memoria por conversación.
+    static constexpr int CacheSize = 512;
+
+    explicit MessageLog(const QString &directory);
+    ~MessageLog();
+
+    // Directorio por defecto para un usuario en un servidor.
+    static QString defaultDirectory(const QString &server, const QString &username);
+
+    // Últimos `count` mensajes (como mucho CacheSize), del más viejo al más nuevo.
+    QList<LogRecord> tail(const QString &conversation, int count);
+
+    // Anexa de una página del servidor solo lo que sigue a lo ya registrado.
+    // `positions[i]` es la posición de page[i] en el historial del servidor
+    // (la de su último fragmento); la posición decide, así dos mensajes
+    // iguales seguidos son dos registros. Devuelve los mensajes nuevos, en orden.
+    QList<LogRecord> sync(const QString &conversation, const QList<LogRecord> &page,
+                          const QList<quint64> &positions);
+    // Página sin posiciones (el servidor no la paginó): se alinea por
+    // contenido con la cola del registro y no cambia la posición guardada.
+    // Si la cola no aparece en la página, toda la página es nueva.
+    QList<LogRecord> sync(const QString &conversation, const QList<LogRecord> &page);
+
+    // Espera a que el hilo escritor vacíe la cola.
+    void flush();
+
+private:
+    struct Conversation {
+        QString directory;
+        QList<LogRecord> recent;     // cola en memoria, como mucho CacheSize
+        quint64 recordCount = 0;     // registros totales en disco + en cola
+        quint32 lastSegment = 0;
+        qint64 lastSegmentSize = 0;  // bytes válidos del último segmento
+        quint64 serverEnd = 0;       // posición del servidor tras el último registro
+    };
+
+    struct PendingWrite {
+        QString directory;
+        quint64 recordNumber;
+        quint32 segment;             // segmento y tamaño conocidos al cargar,
+        qint64 segmentSize;          // solo los usa la primera escritura
+        quint64 serverEnd;
+        QByteArray bytes;
+    };
+
+    Conversation &conversation(const QString &name);
+    void load(Conversation &conv);
+    void append(Conversation &conv, const LogRecord &record, quint64 serverEnd);
+    void writerLoop();
+
+    QString m_directory;
+    QHash<QString, Conversation> m_conversations;
+
+    QThread *m_writer = nullptr;
+    QMutex m_mutex;
+    QWaitCondition m_wake;
+    QWaitCondition m_drained;
+    QList<PendingWrite> m_queue;
+    bool m_writing = false;
+    bool m_stopping = false;
+};
+
+#endif // MESSAGELOG_H
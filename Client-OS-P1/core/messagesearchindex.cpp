@@ -0,0 +1,239 @@
+#include "messagesearchindex.h"
+
+#include <QMutexLocker>
+#include <QReadLocker>
+#include <QTextBoundaryFinder>
+#include <QWriteLocker>
+
+#include <algorithm>
+
+namespace {
+
+// Palabras más largas que esto no se indexan (enlaces, bloques pegados)
+constexpr qsizetype MaxTokenLength = 64;
+
+} // namespace
+
+MessageSearchIndex::MessageSearchIndex(QObject *parent)
+    : QObject(parent)
+{
+    // Un solo hilo: los lotes se mezclan en el orden en que llegaron
+    m_pool.setMaxThreadCount(1);
+}
+
+MessageSearchIndex::~MessageSearchIndex()
+{
+    {
+        QMutexLocker locker(&m_queueMutex);
+        m_queue.clear();
+    }
+    m_pool.waitForDone();
+}
+
+QStringList MessageSearchIndex::tokenize(const QString &text) {
+    const QString folded = text.toCaseFolded();
+    QStringList tokens;
+    QTextBoundaryFinder finder(QTextBoundaryFinder::Word, folded);
+    qsizetype start = 0;
+    for (qsizetype end = finder.toNextBoundary(); end >= 0; end = finder.toNextBoundary()) {
+        // Solo los tramos que empiezan con letra o número son palabras
+        const qsizetype length = end - start;
+        if (length > 0 && length <= MaxTokenLength && folded.at(start).isLetterOrNumber())
+            tokens.append(folded.mid(start, length));
+        start = end;
+    }
+    return tokens;
+}
+
+void MessageSearchIndex::add(const QString &conversation, qint64 sequence, const QString &text) {
+    QMutexLocker locker(&m_queueMutex);
+    m_queue.append(Pending{conversation, sequence, text});
+    if (m_draining)
+        return;
+    m_draining = true;
+    m_pool.start([this] { drain(); });
+}
+
+void MessageSearchIndex::clear() {
+    {
+        QMutexLocker locker(&m_queueMutex);
+        m_queue.clear();
+        ++m_generation;
+    }
+    QWriteLocker locker(&m_lock);
+    m_documents.clear();
+    m_conversations.clear();
+    m_conversationIds.clear();
+    m_postings.clear();
+}
+
+qsizetype MessageSearchIndex::size() const {
+    QReadLocker locker(&m_lock);
+    return m_documents.size();
+}
+
+qsizetype MessageSearchIndex::pendingCount() const {
+    QMutexLocker locker(&m_queueMutex);
+    return m_queue.size();
+}
+
+qsizetype MessageSearchIndex::memoryUsage() const {
+    QReadLocker locker(&m_lock);
+    qsizetype bytes = m_documents.capacity() * qsizetype(sizeof(Document));
+    for (const QString &conversation : m_conversations)
+        bytes += conversation.capacity() * qsizetype(sizeof(QChar)) + qsizetype(sizeof(QString) + sizeof(quint32));
+    for (auto it = m_postings.cbegin(); it != m_postings.cend(); ++it) {
+        bytes += it.key().capacity() * qsizetype(sizeof(QChar)) + qsizetype(sizeof(QString) + sizeof(QList<Posting>));
+        bytes += it.value().capacity() * qsizetype(sizeof(Posting));
+    }
+    return bytes;
+}
+
+void MessageSearchIndex::drain() {
+    for (;;) {
+        QList<Pending> batch;
+        quint64 generation;
+        {
+            QMutexLocker locker(&m_queueMutex);
+            if (m_queue.isEmpty()) {
+                m_draining = false;
+                return;
+            }
+            batch = m_queue.mid(0, BatchSize);
+            m_queue.remove(0, batch.size());
+            generation = m_generation;
+        }
+
+        // Lo caro (tokenizar) se hace sin bloquear las consultas
+        QList<QStringList> tokens;
+        tokens.reserve(batch.size());
+        for (const Pending &pending : std::as_const(batch))
+            tokens.append(tokenize(pending.text));
+
+        QWriteLocker locker(&m_lock);
+        {
+            // Un clear() mientras se tokenizaba descarta el lote
+            QMutexLocker queueLocker(&m_queueMutex);
+            if (generation != m_generation)
+                continue;
+        }
+
+        for (qsizetype i = 0; i < batch.size(); ++i) {
+            const Pending &pending = batch.at(i);
+            auto conversation = m_conversationIds.constFind(pending.conversation);
+            if (conversation == m_conversationIds.constEnd()) {
+                conversation = m_conversationIds.insert(pending.conversation, quint32(m_conversations.size()));
+                m_conversations.append(pending.conversation);
+            }
+
+            const quint32 document = quint32(m_documents.size());
+            m_documents.append(Document{*conversation, pending.sequence});
+            const QStringList &words = tokens.at(i);
+            for (qsizetype position = 0; position < words.size(); ++position)
+                m_postings[words.at(position)].append(Posting{document, quint32(position)});
+        }
+    }
+}
+
+QList<MessageSearchIndex::Hit> MessageSearchIndex::search(const QString &query, const QString &conversation,
+                                                          int limit) const {
+    // Cada palabra suelta es una cláusula; cada frase entre comillas, otra
+    QList<QStringList> clauses;
+    const QStringList parts = query.split(QChar('"'));
+    for (qsizetype i = 0; i < parts.size(); ++i) {
+        const QStringList words = tokenize(parts.at(i));
+        if (i % 2 == 1) {
+            if (!words.isEmpty())
+                clauses.append(words);
+        } else {
+            for (const QString &word : words)
+                clauses.append(QStringList{word});
+        }
+    }
+    if (clauses.isEmpty())
+        return {};
+
+    QReadLocker locker(&m_lock);
+
+    quint32 conversationId = 0;
+    if (!conversation.isEmpty()) {
+        auto it = m_conversationIds.constFind(conversation);
+        if (it == m_conversationIds.constEnd())
+            return {};
+        conversationId = *it;
+    }
+
+    QList<QList<quint32>> matches;
+    matches.reserve(clauses.size());
+    for (const QStringList &clause : std::as_const(clauses)) {
+        QList<quint32> documents = match(clause);
+        if (documents.isEmpty())
+            return {};
+        matches.append(std::move(documents));
+    }
+
+    // Se parte de la lista más corta y se descarta lo que no está en las demás
+    std::sort(matches.begin(), matches.end(), [](const QList<quint32> &a, const QList<quint32> &b) {
+        return a.size() < b.size();
+    });
+    QList<quint32> documents = matches.first();
+    for (qsizetype i = 1; i < matches.size() && !documents.isEmpty(); ++i) {
+        const QList<quint32> &other = matches.at(i);
+        auto from = other.cbegin();
+        documents.removeIf([&](quint32 document) {
+            from = std::lower_bound(from, other.cend(), document);
+            return from == other.cend() || *from != document;
+        });
+    }
+
+    QList<Hit> hits;
+    for (auto it = documents.crbegin(); it != documents.crend() && (limit < 0 || hits.size() < limit); ++it) {
+        const Document &document = m_documents.at(*it);
+        if (!conversation.isEmpty() && document.conversation != conversationId)
+            continue;
+        hits.append(Hit{m_conversations.at(document.conversation), document.sequence});
+    }
+    return hits;
+}
+
+QList<quint32> MessageSearchIndex::match(const QStringList &phrase) const {
+    QList<const QList<Posting> *> postings;
+    postings.reserve(phrase.size());
+    for (const QString &word : phrase) {
+        auto it = m_postings.constFind(word);
+        if (it == m_postings.constEnd())
+            return {};
+        postings.append(&*it);
+    }
+
+    // Se recorre la palabra menos frecuente y se verifica que las demás estén
+    // en la posición que les corresponde dentro del mismo mensaje
+    qsizetype rarest = 0;
+    for (qsizetype i = 1; i < postings.size(); ++i) {
+        if (postings.at(i)->size() < postings.at(rarest)->size())
+            rarest = i;
+    }
+
+    auto before = [](const Posting &a, const Posting &b) {
+        return a.document != b.document ? a.document < b.document : a.position < b.position;
+    };
+
+    QList<quint32> documents;
+    for (const Posting &posting : *postings.at(rarest)) {
+        if (!documents.isEmpty() && documents.last() == posting.document)
+            continue;
+        if (posting.position < quint32(rarest))
+            continue;
+        const quint32 start = posting.position - quint32(rarest);
+
+        bool found = true;
+        for (qsizetype i = 0; i < postings.size() && found; ++i) {
+            if (i != rarest)
+                found = std::binary_search(postings.at(i)->cbegin(), postings.at(i)->cend(),
+                                           Posting{posting.document, start + quint32(i)}, before);
+        }
+        if (found)
+            documents.append(posting.document);
+    }
+    return documents;
+}
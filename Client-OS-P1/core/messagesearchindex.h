@@ -0,0 +1,95 @@
+#ifndef MESSAGESEARCHINDEX_H
+#define MESSAGESEARCHINDEX_H
+#pragma once
+
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QObject>
+#include <QReadWriteLock>
+#include <QString>
+#include <QStringList>
+#include <QThreadPool>
+
+// Índice invertido de todos los mensajes de la sesión.
+//
+// Cada mensaje se identifica por su conversación y su número estable en el
+// ConversationStore. add() solo encola el texto: la tokenización (límites de
+// palabra Unicode sobre el texto en casefold) y la mezcla en las listas de
+// apariciones corren en un hilo propio, así recibir un mensaje no espera al
+// índice. Las listas están ordenadas por documento y posición, y una consulta
+// intersecta primero las más cortas.
+//
+// Consultas: palabras sueltas (todas deben aparecer) y frases entre comillas,
+// por ejemplo  hola "nos vemos mañana".
+class MessageSearchIndex : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Hit {
+        QString conversation;
+        qint64 sequence;
+    };
+
+    static constexpr int DefaultLimit = 100;
+    // Mensajes que el hilo del índice toma de la cola por vez.
+    static constexpr int BatchSize = 512;
+
+    explicit MessageSearchIndex(QObject *parent = nullptr);
+    ~MessageSearchIndex();
+
+    static QStringList tokenize(const QString &text);
+
+    void add(const QString &conversation, qint64 sequence, const QString &text);
+    void clear();
+
+    // Coincidencias de la más nueva a la más antigua. Con `conversation` no
+    // vacía solo se busca en esa conversación.
+    QList<Hit> search(const QString &query, const QString &conversation = QString(),
+                      int limit = DefaultLimit) const;
+
+    // Mensajes ya indexados (no incluye los que siguen en cola).
+    qsizetype size() const;
+    // Mensajes en cola esperando al hilo del índice.
+    qsizetype pendingCount() const;
+    // Memoria aproximada del índice, en bytes (sin la cola).
+    qsizetype memoryUsage() const;
+
+private:
+    struct Pending {
+        QString conversation;
+        qint64 sequence;
+        QString text;
+    };
+
+    struct Document {
+        quint32 conversation;
+        qint64 sequence;
+    };
+
+    struct Posting {
+        quint32 document;
+        quint32 position;
+    };
+
+    void drain();
+    QList<quint32> match(const QStringList &phrase) const;
+
+    // Cola de mensajes sin indexar, protegida por m_queueMutex
+    mutable QMutex m_queueMutex;
+    QList<Pending> m_queue;
+    bool m_draining = false;
+    quint64 m_generation = 0;
+
+    // Índice, protegido por m_lock
+    mutable QReadWriteLock m_lock;
+    QList<Document> m_documents;
+    QList<QString> m_conversations;
+    QHash<QString, quint32> m_conversationIds;
+    QHash<QString, QList<Posting>> m_postings;
+
+    QThreadPool m_pool;
+};
+
+#endif // MESSAGESEARCHINDEX_H
@@ -0,0 +1,167 @@
+#include "metrics.h"
+
+#include <QDateTime>
+#include <QFile>
+#include <QJsonDocument>
+#include <QMutexLocker>
+
+#include <map>
+#include <memory>
+
+namespace {
+
+// std::map: las entradas no se mueven al insertar y la instantánea sale
+// ordenada por nombre.
+template <typename T>
+using Table = std::map<QString, std::unique_ptr<T>>;
+
+struct Registry {
+    QMutex mutex;
+    Table<Metrics::Counter> counters;
+    Table<Metrics::Gauge> gauges;
+    Table<Metrics::Timer> timers;
+    QElapsedTimer uptime;
+
+    // Tráfico por sentido y opcode, sin mutex: un frame son dos sumas atómicas.
+    std::atomic<quint64> frames[Metrics::DirectionCount][256] = {};
+    std::atomic<quint64> bytes[Metrics::DirectionCount][256] = {};
+
+    Registry() { uptime.start(); }
+};
+
+Registry &registry() {
+    static Registry instance;
+    return instance;
+}
+
+template <typename T>
+T &lookup(Table<T> &table, const QString &name) {
+    QMutexLocker locker(&registry().mutex);
+    std::unique_ptr<T> &entry = table[name];
+    if (!entry)
+        entry = std::make_unique<T>();
+    return *entry;
+}
+
+QJsonObject trafficObject(Registry &r, Metrics::Direction direction) {
+    QJsonObject out;
+    for (int opcode = 0; opcode < 256; ++opcode) {
+        const quint64 frames = r.frames[direction][opcode].load(std::memory_order_relaxed);
+        if (frames == 0)
+            continue;
+        out.insert(QString::number(opcode), QJsonObject{
+            {"frames", qint64(frames)},
+            {"bytes", qint64(r.bytes[direction][opcode].load(std::memory_order_relaxed))},
+        });
+    }
+    return out;
+}
+
+bool write(const QString &path, QIODevice::OpenMode mode, const QByteArray &data) {
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | mode))
+        return false;
+    return file.write(data) == data.size();
+}
+
+} // namespace
+
+namespace Metrics {
+
+void Timer::record(qint64 nanos) {
+    QMutexLocker locker(&m_mutex);
+    m_histogram.record(nanos);
+}
+
+void Timer::reset() {
+    QMutexLocker locker(&m_mutex);
+    m_histogram.reset();
+}
+
+LatencyHistogram Timer::histogram() const {
+    QMutexLocker locker(&m_mutex);
+    return m_histogram;
+}
+
+Counter &counter(const QString &name) {
+    return lookup(registry().counters, name);
+}
+
+Gauge &gauge(const QString &name) {
+    return lookup(registry().gauges, name);
+}
+
+Timer &timer(const QString &name) {
+    return lookup(registry().timers, name);
+}
+
+void frame(Direction direction, QByteArrayView data) {
+    if (data.isEmpty())
+        return;
+    Registry &r = registry();
+    const quint8 opcode = quint8(data.front());
+    r.frames[direction][opcode].fetch_add(1, std::memory_order_relaxed);
+    r.bytes[direction][opcode].fetch_add(quint64(data.size()), std::memory_order_relaxed);
+}
+
+void reset() {
+    Registry &r = registry();
+    {
+        QMutexLocker locker(&r.mutex);
+        for (auto &entry : r.counters)
+            entry.second->reset();
+        for (auto &entry : r.timers)
+            entry.second->reset();
+    }
+    for (int direction = 0; direction < DirectionCount; ++direction) {
+        for (int opcode = 0; opcode < 256; ++opcode) {
+            r.frames[direction][opcode].store(0, std::memory_order_relaxed);
+            r.bytes[direction][opcode].store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+QJsonObject snapshot() {
+    Registry &r = registry();
+    QJsonObject counters, gauges, timers;
+    {
+        QMutexLocker locker(&r.mutex);
+        for (const auto &entry : r.counters)
+            counters.insert(entry.first, qint64(entry.second->value()));
+        for (const auto &entry : r.gauges)
+            gauges.insert(entry.first, entry.second->value());
+        for (const auto &entry : r.timers) {
+            const LatencyHistogram histogram = entry.second->histogram();
+            timers.insert(entry.first, QJsonObject{
+                {"count", qint64(histogram.count())},
+                {"meanNs", qint64(histogram.mean())},
+                {"p50Ns", histogram.percentile(50.0)},
+                {"p90Ns", histogram.percentile(90.0)},
+                {"p99Ns", histogram.percentile(99.0)},
+                {"maxNs", histogram.max()},
+            });
+        }
+    }
+
+    return QJsonObject{
+        {"timestamp", QDateTime::currentDateTimeUtc().toString(Qt::ISODateWithMs)},
+        {"uptimeMs", r.uptime.elapsed()},
+        {"counters", counters},
+        {"gauges", gauges},
+        {"timers", timers},
+        {"traffic", QJsonObject{
+            {"received", trafficObject(r, Received)},
+            {"sent", trafficObject(r, Sent)},
+        }},
+    };
+}
+
+bool writeSnapshot(const QString &path) {
+    return write(path, QIODevice::Truncate, QJsonDocument(snapshot()).toJson(QJsonDocument::Indented));
+}
+
+bool appendSnapshot(const QString &path) {
+    return write(path, QIODevice::Append, QJsonDocument(snapshot()).toJson(QJsonDocument::Compact) + '\n');
+}
+
+} // namespace Metrics
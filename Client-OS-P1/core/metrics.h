@@ -0,0 +1,103 @@
+#ifndef METRICS_H
+#define METRICS_H
+#pragma once
+
+#include <QByteArrayView>
+#include <QElapsedTimer>
+#include <QJsonObject>
+#include <QMutex>
+#include <QString>
+
+#include <atomic>
+
+#include "latencyhistogram.h"
+
+// Métricas del cliente en ejecución: contadores, medidores, tiempos y tráfico
+// por opcode, en un registro global que se puede volcar a JSON.
+//
+// Cada sitio medido busca su métrica una sola vez, normalmente en una
+// variable estática local:
+//   static Metrics::Timer &decode = Metrics::timer("protocol.decode");
+// Las referencias son válidas mientras viva el proceso, así que después solo
+// cuesta una operación atómica (contadores, medidores, tráfico) o un mutex
+// sin competencia (tiempos). Se puede medir desde cualquier hilo.
+namespace Metrics {
+
+class Counter {
+public:
+    void add(quint64 amount = 1) { m_value.fetch_add(amount, std::memory_order_relaxed); }
+    quint64 value() const { return m_value.load(std::memory_order_relaxed); }
+    void reset() { m_value.store(0, std::memory_order_relaxed); }
+
+private:
+    std::atomic<quint64> m_value{0};
+};
+
+// Valor instantáneo (profundidad de una cola, memoria de un subsistema).
+class Gauge {
+public:
+    void set(qint64 value) { m_value.store(value, std::memory_order_relaxed); }
+    qint64 value() const { return m_value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<qint64> m_value{0};
+};
+
+// Distribución de duraciones, en nanosegundos.
+class Timer {
+public:
+    void record(qint64 nanos);
+    void reset();
+    LatencyHistogram histogram() const;
+
+private:
+    mutable QMutex m_mutex;
+    LatencyHistogram m_histogram;
+};
+
+// Registra en `timer` lo que dura el bloque que la contiene.
+class ScopedTimer {
+public:
+    explicit ScopedTimer(Timer &timer) : m_timer(timer) { m_clock.start(); }
+    ~ScopedTimer() { m_timer.record(m_clock.nsecsElapsed()); }
+
+    ScopedTimer(const ScopedTimer &) = delete;
+    ScopedTimer &operator=(const ScopedTimer &) = delete;
+
+private:
+    Timer &m_timer;
+    QElapsedTimer m_clock;
+};
+
+enum Direction {
+    Received,
+    Sent,
+    DirectionCount
+};
+
+Counter &counter(const QString &name);
+Gauge &gauge(const QString &name);
+Timer &timer(const QString &name);
+
+// Un frame completo tal como viaja por el socket; el opcode es su primer byte.
+void frame(Direction direction, QByteArrayView data);
+
+// Pone en cero contadores, tiempos y tráfico. Los medidores conservan su
+// último valor: no son acumulados.
+void reset();
+
+// Estado actual de todas las métricas:
+//   { "timestamp", "uptimeMs", "counters": {...}, "gauges": {...},
+//     "timers": { nombre: { "count", "meanNs", "p50Ns", "p90Ns", "p99Ns", "maxNs" } },
+//     "traffic": { "received"|"sent": { opcode: { "frames", "bytes" } } } }
+QJsonObject snapshot();
+
+// Escribe la instantánea como un documento JSON, reemplazando el archivo.
+bool writeSnapshot(const QString &path);
+// Agrega la instantánea como una línea al final del archivo (JSON Lines),
+// para exportar una serie a intervalos.
+bool appendSnapshot(const QString &path);
+
+} // namespace Metrics
+
+#endif // METRICS_H
@@ -0,0 +1,424 @@
+#include "mockserver.h"
+
+#include <QTcpSocket>
+#include <QUrlQuery>
+#include <QWebSocket>
+
+#include "logging.h"
+#include "protocolcodec.h"
+
+namespace {
+
+constexpr char BroadcastChat[] = "~";
+constexpr quint8 StatusDisconnected = 0;
+constexpr quint8 StatusActive = 1;
+constexpr quint8 StatusIdle = 3;
+constexpr qsizetype MaxEntries = 255;
+
+// Códigos del opcode 50
+enum ErrorCode : quint8 {
+    UserNotFound = 1,
+    InvalidStatus = 2,
+    EmptyMessage = 3,
+    RecipientOffline = 4
+};
+
+} // namespace
+
+struct MockChatServer::Client {
+    QWebSocket *socket = nullptr;
+    QByteArray name;
+    quint8 status = StatusActive;
+    bool compress = false;      // pidió compress=zlib y el servidor lo admite
+
+    // Frames retenidos por la latencia inyectada, en orden de envío
+    struct Pending {
+        qint64 dueMs;
+        QByteArray frame;
+    };
+    QQueue<Pending> outbox;
+    qint64 lastDueMs = 0;
+    QTimer *outboxTimer = nullptr;
+};
+
+MockChatServer::MockChatServer(const MockServerConfig &config, QObject *parent)
+    : QObject(parent), m_config(config),
+      m_webSockets(QStringLiteral("mock-chat"), QWebSocketServer::NonSecureMode),
+      m_random(config.seed)
+{
+    m_clock.start();
+    connect(&m_tcp, &QTcpServer::newConnection, this, &MockChatServer::onTcpConnection);
+    connect(&m_webSockets, &QWebSocketServer::newConnection, this, &MockChatServer::onWebSocketConnection);
+
+    m_storm.setInterval(StormTickMs);
+    connect(&m_storm, &QTimer::timeout, this, &MockChatServer::stormTick);
+
+    setRosterSize(config.rosterSize);
+    setPresenceStorm(config.presenceStormHz);
+}
+
+MockChatServer::~MockChatServer() {
+    close();
+}
+
+bool MockChatServer::listen(const QHostAddress &address, quint16 port) {
+    if (!m_tcp.listen(address, port)) {
+        qCWarning(lcProtocol) << "MockChatServer: no se pudo escuchar en" << port << m_tcp.errorString();
+        return false;
+    }
+    qCInfo(lcProtocol) << "MockChatServer: escuchando en" << url().toString();
+    return true;
+}
+
+void MockChatServer::close() {
+    m_tcp.close();
+    // Los sockets se borran en onClientGone al cerrarse
+    const QList<Client *> clients = m_clients.values();
+    for (Client *client : clients)
+        client->socket->abort();
+}
+
+QUrl MockChatServer::url() const {
+    QUrl url;
+    url.setScheme(QStringLiteral("ws"));
+    const QHostAddress address = m_tcp.serverAddress();
+    url.setHost(address == QHostAddress::Any || address == QHostAddress::AnyIPv4
+                    ? QStringLiteral("127.0.0.1") : address.toString());
+    url.setPort(m_tcp.serverPort());
+    return url;
+}
+
+void MockChatServer::setLatency(int latencyMs, int jitterMs) {
+    m_config.latencyMs = qMax(0, latencyMs);
+    m_config.jitterMs = qMax(0, jitterMs);
+}
+
+void MockChatServer::setRosterSize(int size) {
+    m_config.rosterSize = qMax(0, size);
+    m_bots.resize(m_config.rosterSize);
+    for (int i = 0; i < m_bots.size(); ++i) {
+        if (m_bots[i].name.isEmpty())
+            m_bots[i] = Bot{"bot-" + QByteArray::number(i), quint8(StatusActive + m_random.bounded(3))};
+    }
+}
+
+void MockChatServer::setHistoryDepth(int depth) {
+    m_config.historyDepth = qMax(1, depth);
+}
+
+void MockChatServer::setPresenceStorm(int hz) {
+    m_config.presenceStormHz = qMax(0, hz);
+    m_stormBudget = 0.0;
+    if (m_config.presenceStormHz > 0)
+        m_storm.start();
+    else
+        m_storm.stop();
+}
+
+void MockChatServer::setCompression(bool enabled) {
+    m_config.compression = enabled;
+}
+
+void MockChatServer::onTcpConnection() {
+    while (QTcpSocket *socket = m_tcp.nextPendingConnection()) {
+        // Se espera a tener la cabecera completa para decidir el destino
+        connect(socket, &QTcpSocket::readyRead, this, [this, socket] {
+            const QByteArray head = socket->peek(socket->bytesAvailable());
+            if (!head.contains("\r\n\r\n"))
+                return;
+            socket->disconnect();
+            if (head.toLower().contains("upgrade: websocket")) {
+                // QWebSocketServer toma el socket y lee el handshake que quedó en el buffer
+                m_webSockets.handleConnection(socket);
+            } else {
+                connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+                answerNameCheck(socket, socket->readAll());
+            }
+        });
+        // Conexión que se cierra sin mandar una cabecera completa
+        connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+    }
+}
+
+void MockChatServer::answerNameCheck(QTcpSocket *socket, const QByteArray &request) {
+    // Línea de petición: GET /?name=<usuario> HTTP/1.1
+    const QList<QByteArray> line = request.left(request.indexOf("\r\n")).split(' ');
+    const QUrl target = line.size() >= 2 ? QUrl::fromEncoded(line[1]) : QUrl();
+    const QByteArray name = QUrlQuery(target).queryItemValue("name", QUrl::FullyDecoded).toUtf8();
+
+    const bool ok = line.value(0) == "GET" && nameAvailable(name);
+    socket->write(ok ? "HTTP/1.1 200 OK\r\n" : "HTTP/1.1 400 Bad Request\r\n");
+    socket->write("Content-Length: 0\r\nConnection: close\r\n\r\n");
+    socket->disconnectFromHost();
+}
+
+bool MockChatServer::nameAvailable(const QByteArray &name) const {
+    if (name.isEmpty() || name.size() > Protocol::FrameBuilder::MaxString8 || name == BroadcastChat)
+        return false;
+    if (m_clients.contains(name))
+        return false;
+    for (const Bot &bot : m_bots) {
+        if (bot.name == name)
+            return false;
+    }
+    return true;
+}
+
+void MockChatServer::onWebSocketConnection() {
+    while (QWebSocket *socket = m_webSockets.nextPendingConnection()) {
+        const QUrlQuery query(socket->requestUrl());
+        const QByteArray name = query.queryItemValue("name", QUrl::FullyDecoded).toUtf8();
+        if (!nameAvailable(name)) {
+            socket->close(QWebSocketProtocol::CloseCodePolicyViolated, QStringLiteral("nombre en uso"));
+            socket->deleteLater();
+            continue;
+        }
+
+        auto *client = new Client;
+        client->socket = socket;
+        client->name = name;
+        client->compress = m_config.compression
+                           && query.queryItemValue(Protocol::CompressionParam) == QLatin1String(Protocol::CompressionMode);
+        client->outboxTimer = new QTimer(socket);
+        client->outboxTimer->setSingleShot(true);
+        connect(client->outboxTimer, &QTimer::timeout, socket, [this, client] { flushOutbox(client); });
+        connect(socket, &QWebSocket::binaryMessageReceived, this, [this, client](const QByteArray &frame) {
+            onFrame(client, frame);
+        });
+        connect(socket, &QWebSocket::disconnected, this, [this, client] { onClientGone(client); });
+
+        // Los demás se enteran antes de que el nuevo quede en la lista
+        broadcast(Protocol::FrameWriter(Protocol::UserConnected).string8(name).data());
+        m_clients.insert(name, client);
+        emit clientConnected(QString::fromUtf8(name));
+    }
+}
+
+void MockChatServer::onClientGone(Client *client) {
+    if (m_clients.value(client->name) != client)
+        return;
+    m_clients.remove(client->name);
+    client->outboxTimer->stop();
+    client->socket->disconnect(this);
+    client->socket->deleteLater();
+    broadcast(Protocol::FrameWriter(Protocol::StatusChange).string8(client->name).u8(StatusDisconnected).data());
+    emit clientDisconnected(QString::fromUtf8(client->name));
+    delete client;
+}
+
+void MockChatServer::onFrame(Client *client, const QByteArray &frame) {
+    Protocol::FrameReader in(frame);
+    quint8 opcode = 0;
+    in.readU8(opcode);
+
+    switch (opcode) {
+    case Protocol::ListUsers:
+        sendUserList(client);
+        break;
+    case Protocol::GetUser: {
+        QByteArrayView name;
+        if (in.readString8(name))
+            sendUserInfo(client, name);
+        break;
+    }
+    case Protocol::ChangeStatus: {
+        QByteArrayView name;
+        quint8 status = 0;
+        if (in.readString8(name) && in.readU8(status))
+            changeStatus(client, name, status);
+        break;
+    }
+    case Protocol::SendChatMessage: {
+        QByteArrayView recipient;
+        QByteArrayView text;
+        if (in.readString8(recipient) && in.readString8(text))
+            sendMessage(client, recipient, text);
+        break;
+    }
+    case Protocol::GetChatHistory: {
+        QByteArrayView chat;
+        if (!in.readString8(chat))
+            break;
+        // Forma paginada: [cursor u32][límite]
+        quint32 cursor = 0;
+        quint8 limit = 0;
+        const bool paged = in.readU32(cursor) && in.readU8(limit);
+        sendHistory(client, chat, paged, cursor, limit);
+        break;
+    }
+    default:
+        qCDebug(lcProtocol) << "MockChatServer: opcode desconocido" << opcode << "de" << client->name;
+        break;
+    }
+}
+
+void MockChatServer::sendUserList(Client *client) {
+    Protocol::FrameWriter frame(Protocol::UserList);
+    const qsizetype count = qMin<qsizetype>(m_clients.size() + m_bots.size(), MaxEntries);
+    frame.u8(quint8(count));
+    qsizetype left = count;
+    for (const Client *other : std::as_const(m_clients)) {
+        if (left-- == 0)
+            break;
+        frame.string8(other->name).u8(other->status);
+    }
+    for (const Bot &bot : std::as_const(m_bots)) {
+        if (left-- <= 0)
+            break;
+        frame.string8(bot.name).u8(bot.status);
+    }
+    deliverCompressible(client, frame.data());
+}
+
+void MockChatServer::sendUserInfo(Client *client, QByteArrayView name) {
+    const QByteArray key = name.toByteArray();
+    if (const Client *other = m_clients.value(key)) {
+        deliver(client, Protocol::FrameWriter(Protocol::UserInfo).string8(name).u8(other->status).data());
+        return;
+    }
+    for (const Bot &bot : std::as_const(m_bots)) {
+        if (bot.name == key) {
+            deliver(client, Protocol::FrameWriter(Protocol::UserInfo).string8(name).u8(bot.status).data());
+            return;
+        }
+    }
+    sendError(client, UserNotFound);
+}
+
+void MockChatServer::changeStatus(Client *client, QByteArrayView name, quint8 status) {
+    // Solo se puede cambiar el estado propio; 0 se reserva para la desconexión
+    if (name != client->name || status == StatusDisconnected || status > StatusIdle) {
+        sendError(client, InvalidStatus);
+        return;
+    }
+    client->status = status;
+    broadcast(Protocol::FrameWriter(Protocol::StatusChange).string8(name).u8(status).data());
+}
+
+void MockChatServer::sendMessage(Client *client, QByteArrayView recipient, QByteArrayView text) {
+    if (text.isEmpty()) {
+        sendError(client, EmptyMessage);
+        return;
+    }
+
+    const QByteArray frame = Protocol::FrameWriter(Protocol::ChatMessage).string8(client->name).string8(text).data();
+    if (recipient == BroadcastChat) {
+        appendHistory(BroadcastChat, Entry{client->name, text.toByteArray()});
+        broadcast(frame);
+        return;
+    }
+
+    Client *target = m_clients.value(recipient.toByteArray());
+    bool botTarget = false;
+    for (const Bot &bot : std::as_const(m_bots))
+        botTarget = botTarget || bot.name == recipient;
+    if (!target && !botTarget) {
+        sendError(client, RecipientOffline);
+        return;
+    }
+
+    appendHistory(historyKey(client->name, recipient), Entry{client->name, text.toByteArray()});
+    // Como el servidor real, el remitente también recibe su mensaje
+    if (target && target != client)
+        deliver(target, frame);
+    deliver(client, frame);
+}
+
+void MockChatServer::sendHistory(Client *client, QByteArrayView chat, bool paged, quint32 cursor, quint8 limit) {
+    const History history = m_history.value(historyKey(client->name, chat));
+    const quint32 first = history.dropped;
+    const quint32 last = history.dropped + quint32(history.entries.size());
+
+    // El cursor es la posición absoluta donde termina la página; 0 pide la más reciente
+    const quint32 end = paged && cursor != 0 ? qBound(first, cursor, last) : last;
+    const quint32 size = paged && limit != 0 ? quint32(limit) : quint32(MaxEntries);
+    const quint32 begin = end - qMin(end - first, size);
+
+    Protocol::FrameWriter frame(Protocol::ChatHistory);
+    frame.u8(quint8(end - begin));
+    for (quint32 i = begin; i < end; ++i) {
+        const Entry &entry = history.entries.at(qsizetype(i - first));
+        frame.string8(entry.sender).string8(entry.text);
+    }
+    // El cursor devuelto es la posición del primer mensaje de la página; el
+    // cliente lo usa también para no registrar dos veces lo que ya tiene.
+    // Solo una página vacía indica que no hay más.
+    if (paged)
+        frame.u32(end > begin ? begin : 0);
+    deliverCompressible(client, frame.data());
+}
+
+void MockChatServer::sendError(Client *client, quint8 code) {
+    deliver(client, Protocol::FrameWriter(Protocol::Error).u8(code).data());
+}
+
+QByteArray MockChatServer::historyKey(const QByteArray &requester, QByteArrayView chat) const {
+    if (chat == BroadcastChat)
+        return BroadcastChat;
+    // El chat directo es el mismo visto desde cualquiera de los dos lados
+    const QByteArray other = chat.toByteArray();
+    return requester < other ? requester + '\n' + other : other + '\n' + requester;
+}
+
+void MockChatServer::appendHistory(const QByteArray &key, const Entry &entry) {
+    History &history = m_history[key];
+    history.entries.append(entry);
+    const qsizetype excess = history.entries.size() - m_config.historyDepth;
+    if (excess > 0) {
+        history.entries.remove(0, excess);
+        history.dropped += quint32(excess);
+    }
+}
+
+void MockChatServer::deliverCompressible(Client *client, const QByteArray &frame) {
+    if (!client->compress) {
+        deliver(client, frame);
+        return;
+    }
+    // [57][qCompress(frame)]: qCompress ya antepone el tamaño original
+    QByteArray compressed = qCompress(frame);
+    compressed.prepend(char(Protocol::Compressed));
+    deliver(client, compressed);
+}
+
+void MockChatServer::deliver(Client *client, const QByteArray &frame) {
+    if (m_config.latencyMs == 0 && m_config.jitterMs == 0 && client->outbox.isEmpty()) {
+        client->socket->sendBinaryMessage(frame);
+        return;
+    }
+
+    // Con jitter un frame puede salir antes que el anterior; se conserva el
+    // orden como lo haría una conexión TCP.
+    const qint64 now = m_clock.elapsed();
+    const qint64 jitter = m_config.jitterMs ? m_random.bounded(m_config.jitterMs + 1) : 0;
+    client->lastDueMs = qMax(now + m_config.latencyMs + jitter, client->lastDueMs);
+    client->outbox.enqueue(Client::Pending{client->lastDueMs, frame});
+    if (!client->outboxTimer->isActive())
+        client->outboxTimer->start(int(client->outbox.head().dueMs - now));
+}
+
+void MockChatServer::flushOutbox(Client *client) {
+    const qint64 now = m_clock.elapsed();
+    while (!client->outbox.isEmpty() && client->outbox.head().dueMs <= now)
+        client->socket->sendBinaryMessage(client->outbox.dequeue().frame);
+    if (!client->outbox.isEmpty())
+        client->outboxTimer->start(int(client->outbox.head().dueMs - now));
+}
+
+void MockChatServer::broadcast(const QByteArray &frame) {
+    for (Client *client : std::as_const(m_clients))
+        deliver(client, frame);
+}
+
+void MockChatServer::stormTick() {
+    if (m_bots.isEmpty())
+        return;
+    // Acumula fracciones para respetar frecuencias que no dividen el tick
+    m_stormBudget += double(m_config.presenceStormHz) * StormTickMs / 1000.0;
+    while (m_stormBudget >= 1.0) {
+        m_stormBudget -= 1.0;
+        Bot &bot = m_bots[m_random.bounded(int(m_bots.size()))];
+        bot.status = quint8(StatusActive + (bot.status - StatusActive + 1 + m_random.bounded(2)) % 3);
+        broadcast(Protocol::FrameWriter(Protocol::StatusChange).string8(bot.name).u8(bot.status).data());
+    }
+}
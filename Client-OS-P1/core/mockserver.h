@@ -0,0 +1,117 @@
+#ifndef MOCKSERVER_H
+#define MOCKSERVER_H
+#pragma once
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QHostAddress>
+#include <QList>
+#include <QObject>
+#include <QQueue>
+#include <QRandomGenerator>
+#include <QTcpServer>
+#include <QTimer>
+#include <QUrl>
+#include <QWebSocketServer>
+
+struct MockServerConfig {
+    int latencyMs = 0;          // retraso fijo de cada frame servidor -> cliente
+    int jitterMs = 0;           // retraso extra aleatorio, 0..jitterMs
+    int rosterSize = 0;         // usuarios simulados ("bot-N") en la lista
+    int historyDepth = 500;     // mensajes que se conservan por chat
+    int presenceStormHz = 0;    // cambios de estado por segundo de los bots
+    quint32 seed = 1;           // semilla de jitter y bots, para repetir corridas
+    bool compression = false;   // envolver 51 y 56 en 57 a quien pida compress=zlib
+};
+
+// Servidor de chat local para pruebas y benchmarks, sin depender del
+// servidor remoto.
+//
+// Escucha en un solo puerto como el servidor real: un GET HTTP normal es la
+// verificación de nombre (200 libre, 400 en uso o inválido) y un GET con
+// "Upgrade: websocket" se entrega a QWebSocketServer. Implementa los opcodes
+// 1 a 5 (incluida la forma paginada del 5) y responde con 50 a 56. Con
+// `compression`, a los clientes que lo negocian les manda 51 y 56 envueltos
+// en un 57, como el servidor real.
+//
+// El comportamiento se puede ajustar en caliente: latencia inyectada, tamaño
+// del roster simulado, profundidad del historial y frecuencia de la tormenta
+// de presencia. Con la misma semilla, la misma secuencia de peticiones da las
+// mismas respuestas.
+class MockChatServer : public QObject {
+    Q_OBJECT
+public:
+    explicit MockChatServer(const MockServerConfig &config = {}, QObject *parent = nullptr);
+    ~MockChatServer();
+
+    // Puerto 0: el sistema elige uno libre (ver port()).
+    bool listen(const QHostAddress &address = QHostAddress::LocalHost, quint16 port = 0);
+    void close();
+    quint16 port() const { return m_tcp.serverPort(); }
+    QUrl url() const;
+    int clientCount() const { return int(m_clients.size()); }
+
+    void setLatency(int latencyMs, int jitterMs);
+    void setRosterSize(int size);
+    void setHistoryDepth(int depth);
+    void setPresenceStorm(int hz);
+    // Afecta a los clientes que se conecten después.
+    void setCompression(bool enabled);
+
+signals:
+    void clientConnected(const QString &name);
+    void clientDisconnected(const QString &name);
+
+private:
+    struct Client;
+    struct Entry {
+        QByteArray sender;
+        QByteArray text;
+    };
+    struct History {
+        QList<Entry> entries;
+        quint32 dropped = 0;    // mensajes descartados al inicio; los cursores son absolutos
+    };
+    struct Bot {
+        QByteArray name;
+        quint8 status;
+    };
+
+    static constexpr int StormTickMs = 10;
+
+    void onTcpConnection();
+    void onWebSocketConnection();
+    void answerNameCheck(QTcpSocket *socket, const QByteArray &request);
+    bool nameAvailable(const QByteArray &name) const;
+    void onFrame(Client *client, const QByteArray &frame);
+    void onClientGone(Client *client);
+
+    void sendUserList(Client *client);
+    void sendUserInfo(Client *client, QByteArrayView name);
+    void changeStatus(Client *client, QByteArrayView name, quint8 status);
+    void sendMessage(Client *client, QByteArrayView recipient, QByteArrayView text);
+    void sendHistory(Client *client, QByteArrayView chat, bool paged, quint32 cursor, quint8 limit);
+    void sendError(Client *client, quint8 code);
+
+    void deliver(Client *client, const QByteArray &frame);
+    void deliverCompressible(Client *client, const QByteArray &frame);
+    void broadcast(const QByteArray &frame);
+    void flushOutbox(Client *client);
+    void stormTick();
+    QByteArray historyKey(const QByteArray &requester, QByteArrayView chat) const;
+    void appendHistory(const QByteArray &key, const Entry &entry);
+
+    MockServerConfig m_config;
+    QTcpServer m_tcp;
+    QWebSocketServer m_webSockets;
+    QHash<QByteArray, Client *> m_clients;
+    QList<Bot> m_bots;
+    QHash<QByteArray, History> m_history;
+    QRandomGenerator m_random;
+    QElapsedTimer m_clock;
+    QTimer m_storm;
+    double m_stormBudget = 0.0;
+};
+
+#endif // MOCKSERVER_H
@@ -0,0 +1,21 @@
+#include "namevalidationcache.h"
+
+bool NameValidationCache::isValid(const QString &server, const QString &username) const {
+    const auto it = m_accepted.constFind(key(server, username));
+    return it != m_accepted.constEnd() && !it->hasExpired(TtlMs);
+}
+
+void NameValidationCache::remember(const QString &server, const QString &username) {
+    QElapsedTimer accepted;
+    accepted.start();
+    m_accepted.insert(key(server, username), accepted);
+}
+
+void NameValidationCache::forget(const QString &server, const QString &username) {
+    m_accepted.remove(key(server, username));
+}
+
+QString NameValidationCache::key(const QString &server, const QString &username) {
+    // Un host no contiene '\n': la clave no es ambigua
+    return server + QLatin1Char('\n') + username;
+}
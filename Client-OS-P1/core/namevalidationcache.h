@@ -0,0 +1,29 @@
+#ifndef NAMEVALIDATIONCACHE_H
+#define NAMEVALIDATIONCACHE_H
+#pragma once
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QString>
+
+// Verificaciones HTTP del nombre ya aceptadas, por servidor y usuario.
+//
+// Mientras una verificación es reciente, volver a conectar con el mismo
+// nombre abre el WebSocket directamente, sin esperar otra ida y vuelta HTTP.
+// El servidor sigue teniendo la última palabra: si rechaza el nombre al
+// conectar (error 1), la entrada se olvida.
+class NameValidationCache {
+public:
+    static constexpr qint64 TtlMs = 5 * 60 * 1000;
+
+    bool isValid(const QString &server, const QString &username) const;
+    void remember(const QString &server, const QString &username);
+    void forget(const QString &server, const QString &username);
+
+private:
+    static QString key(const QString &server, const QString &username);
+
+    QHash<QString, QElapsedTimer> m_accepted;
+};
+
+#endif // NAMEVALIDATIONCACHE_H
@@ -0,0 +1,661 @@
+#include "networkworker.h"
+#include <QDateTime>
+#include <QMutexLocker>
+#include <QUrlQuery>
+#include "logging.h"
+#include "metrics.h"
+
+namespace {
+
+// Eventos esperando fuera de la cola llena
+Metrics::Gauge &overflowDepth() {
+    static Metrics::Gauge &gauge = Metrics::gauge("queue.networkOverflow");
+    return gauge;
+}
+
+QString statusText(quint8 status) {
+    switch (status) {
+    case 1: return QStringLiteral("Activo");
+    case 2: return QStringLiteral("Ocupado");
+    case 3: return QStringLiteral("Inactivo");
+    default: return QStringLiteral("Desconectado");
+    }
+}
+
+} // namespace
+
+NetworkWorker::NetworkWorker(const QUrl& url, const QString& username, Queue* queue, LatencyTracker* latency,
+                             std::function<void()> notify)
+    : url(url), username(username), usernameUtf8(username.toUtf8()), queue(queue), latency(latency),
+      notify(std::move(notify))
+{
+}
+
+void NetworkWorker::open() {
+    clock.start();
+
+    socket = new QWebSocket(QString(), QWebSocketProtocol::VersionLatest, this);
+    connect(socket, &QWebSocket::connected, this, &NetworkWorker::onConnected);
+    connect(socket, &QWebSocket::binaryMessageReceived, this, [this](const QByteArray& message) {
+        // Tráfico por opcode tal como llega (un 57 cuenta como 57) y tiempo
+        // de decodificación, incluido el inflado y el armado del evento
+        static Metrics::Timer& decodeTime = Metrics::timer("protocol.decode");
+        Metrics::frame(Metrics::Received, message);
+        Metrics::ScopedTimer timing(decodeTime);
+        onBinaryMessage(message);
+    });
+    connect(socket, &QWebSocket::disconnected, this, &NetworkWorker::onSocketLost);
+    // Un intento de reconexión que no llega a conectar no siempre emite disconnected
+    connect(socket, &QWebSocket::errorOccurred, this, [this] {
+        if (!online && everConnected)
+            onSocketLost();
+    });
+
+    // Barrido periódico de mensajes fragmentados que nunca se completaron
+    fragmentTimer = new QTimer(this);
+    fragmentTimer->setInterval(5000);
+    connect(fragmentTimer, &QTimer::timeout, this, &NetworkWorker::expireFragments);
+
+    overflowTimer = new QTimer(this);
+    overflowTimer->setSingleShot(true);
+    overflowTimer->setInterval(OverflowRetryMs);
+    connect(overflowTimer, &QTimer::timeout, this, &NetworkWorker::flushOverflow);
+
+    reconnectTimer = new QTimer(this);
+    reconnectTimer->setSingleShot(true);
+    connect(reconnectTimer, &QTimer::timeout, this, [this] { socket->open(fullUrl); });
+
+    fullUrl = url;
+    QUrlQuery query;
+    query.addQueryItem("name", username);
+    // Ofrecemos compresión de historial y lista de usuarios; un servidor que
+    // no la soporte ignora el parámetro y responde sin comprimir.
+    query.addQueryItem(Protocol::CompressionParam, Protocol::CompressionMode);
+    fullUrl.setQuery(query);
+
+    socket->open(fullUrl);
+}
+
+void NetworkWorker::close() {
+    // Simplemente cerrar la conexión sin enviar el mensaje 0x06
+    closing = true;
+    if (reconnectTimer)
+        reconnectTimer->stop();
+    if (socket)
+        socket->close();
+}
+
+void NetworkWorker::onConnected() {
+    online = true;
+    reconnect.connected();
+
+    if (everConnected) {
+        resumed = true;
+        rosterResync = true;
+        qCInfo(lcProtocol) << "NetworkWorker: reconectado tras" << reconnect.attempts() << "intentos";
+        post(NetworkEvent{NetworkEvent::Resumed});
+    } else {
+        everConnected = true;
+        post(NetworkEvent{NetworkEvent::Connected});
+    }
+
+    // Un solo pedido al conectar: el estado propio viene en la misma lista
+    // de usuarios, así que no hace falta el opcode 2 (ver deliverSelfStatus)
+    selfStatusPending = true;
+    requestUserList();
+
+    // Al reconectar el servidor nos da por activos: se restaura el estado
+    // que había, y su eco (54) actualiza la interfaz
+    if (resumed && ownStatus != Roster::Active) {
+        selfStatusPending = false;
+        send(frames.changeStatus(username, ownStatus));
+    }
+}
+
+void NetworkWorker::deliverSelfStatus(const Protocol::UserListFrame& frame) {
+    if (!selfStatusPending)
+        return;
+    selfStatusPending = false;
+
+    for (const Protocol::UserEntry &entry : frame.users) {
+        if (entry.name == usernameUtf8) {
+            NetworkEvent event{NetworkEvent::UserStatus};
+            event.status = entry.status;
+            post(std::move(event));
+            return;
+        }
+    }
+
+    // Un servidor que no incluye al propio usuario en la lista (o una lista
+    // recortada): se pide aparte, como antes
+    send(frames.getUser(username));
+}
+
+void NetworkWorker::onSocketLost() {
+    // disconnected y errorOccurred pueden llegar los dos por la misma caída
+    if (reconnectTimer->isActive())
+        return;
+
+    online = false;
+    rosterResync = false;
+    selfStatusPending = false;
+    logCompressionStats();
+    // Lo que quedó sin respuesta ya no la va a tener
+    pendingEchoes.clear();
+    pendingHistory.clear();
+    pendingPages.clear();
+    pendingUserLists.clear();
+
+    if (closing || !everConnected) {
+        post(NetworkEvent{NetworkEvent::Disconnected});
+        return;
+    }
+
+    NetworkEvent event{NetworkEvent::Reconnecting};
+    event.retryMs = reconnect.nextDelayMs();
+    event.attempt = reconnect.attempts();
+    qCInfo(lcProtocol) << "NetworkWorker: conexión perdida, intento" << event.attempt
+                       << "en" << event.retryMs << "ms";
+    reconnectTimer->start(int(event.retryMs));
+    post(std::move(event));
+}
+
+void NetworkWorker::send(const QByteArray& frame) {
+    Metrics::frame(Metrics::Sent, frame);
+    socket->sendBinaryMessage(frame);
+}
+
+void NetworkWorker::post(NetworkEvent&& event) {
+    // Si ya hay eventos esperando, este va detrás para no alterar el orden
+    if (!overflow.isEmpty() || !queue->push(std::move(event))) {
+        overflow.append(std::move(event));
+        overflowDepth().set(overflow.size());
+        if (overflowTimer && !overflowTimer->isActive())
+            overflowTimer->start();
+    }
+    notify();
+}
+
+void NetworkWorker::postMessage(const QString& sender, const QString& text) {
+    NetworkEvent event{NetworkEvent::Message};
+    event.name = sender;
+    event.text = text;
+    post(std::move(event));
+}
+
+void NetworkWorker::postNotice(const QString& text) {
+    NetworkEvent event{NetworkEvent::Notice};
+    event.text = text;
+    post(std::move(event));
+}
+
+void NetworkWorker::flushOverflow() {
+    qsizetype moved = 0;
+    while (moved < overflow.size() && queue->push(std::move(overflow[moved])))
+        ++moved;
+    overflow.remove(0, moved);
+    overflowDepth().set(overflow.size());
+    if (!overflow.isEmpty())
+        overflowTimer->start();
+    notify();
+}
+
+void NetworkWorker::onBinaryMessage(const QByteArray& message) {
+    // Todos los campos decodificados son vistas sobre `message`; solo se crean
+    // QString al armar el evento, que es cuando el texto sobrevive al frame.
+    switch (Protocol::opcodeOf(message)) {
+    case Protocol::UserList: { // 51 - Lista de usuarios conectados
+        completeReply(pendingUserLists, LatencyTracker::UserList);
+        Protocol::UserListFrame frame;
+        if (!Protocol::decodeUserList(message, frame)) {
+            qCWarning(lcProtocol) << "NetworkWorker: frame 51 truncado, descartado";
+            break;
+        }
+
+        if (rosterResync) {
+            rosterResync = false;
+            resyncRoster(frame);
+            deliverSelfStatus(frame);
+            break;
+        }
+
+        // Sincronización completa: reemplaza la copia local del roster
+        NetworkEvent event{NetworkEvent::UserList};
+        event.users.reserve(frame.users.size());
+        roster.clear();
+        roster.reserve(frame.users.size());
+        presence.clear();
+        for (const Protocol::UserEntry &entry : frame.users) {
+            const QString name = Protocol::toString(entry.name);
+            roster.insert(name, entry.status);
+            event.users.append(name + " (" + statusText(entry.status) + ")");
+        }
+
+        post(std::move(event));
+        deliverSelfStatus(frame);
+        break;
+    }
+
+    case Protocol::UserInfo: { // 52 - Información del usuario (estado actual)
+        Protocol::UserInfoFrame frame;
+        if (!Protocol::decodeUserInfo(message, frame)) {
+            qCWarning(lcProtocol) << "NetworkWorker: frame 52 truncado, descartado";
+            break;
+        }
+        NetworkEvent event{NetworkEvent::UserStatus};
+        event.status = frame.status;
+        post(std::move(event));
+        break;
+    }
+
+    case Protocol::UserConnected: { // 53 - Usuario conectado
+        Protocol::UserConnectedFrame frame;
+        if (!Protocol::decodeUserConnected(message, frame)) {
+            qCWarning(lcProtocol) << "NetworkWorker: frame 53 truncado, descartado";
+            break;
+        }
+
+        const QString name = Protocol::toString(frame.name);
+        postNotice("🔔 " + name + " se ha conectado.");
+
+        // Delta sobre el roster local en lugar de volver a pedir la lista
+        if (roster.connectUser(name) != Roster::Unchanged) {
+            NetworkEvent event{NetworkEvent::UserConnected};
+            event.name = name;
+            post(std::move(event));
+        }
+        break;
+    }
+
+    case Protocol::StatusChange: { // 54 - Cambio de estado
+        Protocol::StatusChangeFrame frame;
+        if (!Protocol::decodeStatusChange(message, frame)) {
+            qCWarning(lcProtocol) << "NetworkWorker: frame 54 truncado, descartado";
+            break;
+        }
+        onStatusChange(frame);
+        break;
+    }
+
+    case Protocol::ChatMessage: { // 55 - Nuevo mensaje recibido (mensaje normal)
+        Protocol::MessageFrame frame;
+        if (!Protocol::decodeMessage(message, frame)) {
+            qCWarning(lcProtocol) << "NetworkWorker: frame 55 truncado, descartado";
+            break;
+        }
+        QByteArray complete;
+        const bool own = frame.sender == usernameUtf8;
+        switch (reassembler.feed(frame.sender, frame.text, QDateTime::currentMSecsSinceEpoch(), complete)) {
+        case Fragmentation::Reassembler::NotFragment:
+            if (own)
+                matchEcho(frame.text);
+            postMessage(Protocol::toString(frame.sender), Protocol::toString(frame.text));
+            break;
+        case Fragmentation::Reassembler::Complete:
+            if (own)
+                matchEcho(complete);
+            postMessage(Protocol::toString(frame.sender), QString::fromUtf8(complete));
+            break;
+        case Fragmentation::Reassembler::Incomplete:
+            if (!fragmentTimer->isActive())
+                fragmentTimer->start();
+            break;
+        case Fragmentation::Reassembler::Dropped:
+            qCWarning(lcProtocol) << "NetworkWorker: fragmento descartado de" << Protocol::toString(frame.sender);
+            break;
+        }
+        break;
+    }
+
+    case Protocol::ChatHistory: { // 56 - Historial recibido
+        completeReply(pendingHistory, LatencyTracker::HistoryPage);
+        Protocol::HistoryFrame frame;
+        if (!Protocol::decodeHistory(message, frame)) {
+            qCWarning(lcProtocol) << "NetworkWorker: frame 56 truncado, descartado";
+            break;
+        }
+
+        qCDebug(lcProtocol) << "NetworkWorker: Recibidos" << frame.messages.size() << "mensajes en el historial.";
+        onHistoryPage(frame);
+        break;
+    }
+
+    case Protocol::Compressed: { // 57 - Frame comprimido (51 o 56 envuelto)
+        QElapsedTimer timer;
+        timer.start();
+        QByteArray inflated;
+        if (!Protocol::inflateFrame(message, inflated)) {
+            qCWarning(lcProtocol) << "NetworkWorker: frame 57 inválido, descartado";
+            break;
+        }
+
+        const qint64 inflateNanos = timer.nsecsElapsed();
+        {
+            QMutexLocker locker(&statsMutex);
+            compression.frames++;
+            compression.compressedBytes += quint64(message.size());
+            compression.inflatedBytes += quint64(inflated.size());
+            compression.inflateNanos += quint64(inflateNanos);
+            qCDebug(lcProtocol) << "NetworkWorker: frame" << Protocol::opcodeOf(inflated) << "comprimido"
+                     << message.size() << "->" << inflated.size() << "bytes, ratio acumulado"
+                     << compression.ratio();
+        }
+
+        // Los mismos datos en el panel de métricas y en la exportación JSON
+        static Metrics::Counter& compressedBytes = Metrics::counter("compression.compressedBytes");
+        static Metrics::Counter& inflatedBytes = Metrics::counter("compression.inflatedBytes");
+        static Metrics::Timer& inflateTime = Metrics::timer("compression.inflate");
+        compressedBytes.add(quint64(message.size()));
+        inflatedBytes.add(quint64(inflated.size()));
+        inflateTime.record(inflateNanos);
+        static Metrics::Gauge& ratio = Metrics::gauge("compression.ratioPercent");
+        ratio.set(qint64(compressionStats().ratio() * 100.0));
+
+        onBinaryMessage(inflated);
+        break;
+    }
+
+    case Protocol::Error: { // 50 - Códigos de error
+        Protocol::ErrorFrame frame;
+        if (Protocol::decodeError(message, frame)) {
+            if (frame.code == 1 && rosterResync) {
+                // Rechazo del nombre al reconectar, antes de recibir la lista:
+                // el servidor todavía no cerró la conexión anterior. Se
+                // cierra esta y se reintenta con la siguiente espera.
+                qCInfo(lcProtocol) << "NetworkWorker: nombre aún en uso al reconectar, se reintenta";
+                socket->close();
+                break;
+            }
+            NetworkEvent event{NetworkEvent::Error};
+            event.status = frame.code;
+            post(std::move(event));
+        }
+        break;
+    }
+
+    default:
+        break;
+    }
+}
+
+void NetworkWorker::resyncRoster(const Protocol::UserListFrame& frame) {
+    // La interfaz conservó su roster durante el corte: en lugar de una lista
+    // completa recibe solo lo que cambió, como si fueran cambios de estado.
+    Roster fresh;
+    fresh.reserve(frame.users.size());
+    for (const Protocol::UserEntry &entry : frame.users) {
+        const QString name = Protocol::toString(entry.name);
+        fresh.insert(name, entry.status);
+        if (entry.name == usernameUtf8 || roster.status(name) == entry.status)
+            continue;
+
+        NetworkEvent event{NetworkEvent::StatusChanged};
+        event.name = name;
+        event.status = entry.status;
+        post(std::move(event));
+    }
+
+    // Los que se fueron durante el corte
+    for (const QString &name : roster.users()) {
+        if (name == username || fresh.contains(name))
+            continue;
+
+        NetworkEvent event{NetworkEvent::StatusChanged};
+        event.name = name;
+        event.status = Roster::Disconnected;
+        post(std::move(event));
+    }
+
+    qCInfo(lcRoster) << "NetworkWorker: roster resincronizado,"
+                     << fresh.size() << "usuarios (antes" << roster.size() << ")";
+    roster = std::move(fresh);
+    presence.clear();
+}
+
+void NetworkWorker::onStatusChange(const Protocol::StatusChangeFrame& frame) {
+    const QString name = Protocol::toString(frame.name);
+    const quint8 newStatus = frame.status;
+
+    // Verificamos si ya recibimos esta misma notificación hace menos de 1 segundo
+    const qint64 now = clock.elapsed();
+    auto stamp = presence.find(name);
+    if (stamp != presence.end() && stamp->status == newStatus && now - stamp->atMs < PresenceDedupMs)
+        return; // ignoramos duplicado
+    presence.insert(name, PresenceStamp{newStatus, now});
+
+    QString notice;
+    switch (newStatus) {
+    case 0: notice = "🚪 " + name + " se ha desconectado."; break;
+    case 1: notice = "✅ " + name + " está activo."; break;
+    case 2: notice = "🔴 " + name + " está ocupado."; break;
+    case 3: notice = "💤 " + name + " está inactivo."; break;
+    default: break;
+    }
+    postNotice(notice);
+
+    const Roster::Change change = roster.changeStatus(name, newStatus);
+    if (change == Roster::Unknown) {
+        // Un cambio de estado de alguien que no está en el roster indica
+        // que perdimos eventos: lo agregamos y pedimos una resincronización.
+        roster.insert(name, newStatus);
+        requestRosterResync();
+    }
+
+    if (frame.name == usernameUtf8) {
+        NetworkEvent event{NetworkEvent::UserStatus};
+        event.status = newStatus;
+        post(std::move(event));
+    } else if (change != Roster::Unchanged) {
+        NetworkEvent event{NetworkEvent::StatusChanged};
+        event.name = name;
+        event.status = newStatus;
+        post(std::move(event));
+    }
+}
+
+void NetworkWorker::sendMessage(const QString& recipient, const QString& message) {
+    if (!socket || !socket->isValid()) {
+        qCWarning(lcProtocol) << "Error en NetworkWorker::sendMessage: socket no válido";
+        return;
+    }
+
+    // Solo los mensajes que podrían no caber en el byte de longitud se
+    // codifican aparte; los cortos van directo al FrameBuilder.
+    QByteArray utf8;
+    if (message.size() * 3 > Protocol::FrameBuilder::MaxString8) {
+        utf8 = message.toUtf8();
+        if (utf8.size() > Protocol::FrameBuilder::MaxString8) {
+            sendFragmented(recipient, utf8);
+            return;
+        }
+    }
+
+    const QByteArray &payload = utf8.isNull()
+        ? frames.sendMessage(recipient, message)
+        : frames.sendMessageUtf8(recipient, QByteArrayView(), utf8);
+
+    // Los argumentos (incluido el volcado hex) solo se evalúan si
+    // chat.protocol.debug está activo
+    qCDebug(lcProtocol) << "enviando paquete de" << payload.size() << "bytes:" << payload.toHex(' ');
+
+    // El texto es el último campo del frame: [4][len][destinatario][len][texto]
+    Protocol::FrameReader fields(payload);
+    quint8 opcode;
+    QByteArrayView to, text;
+    if (fields.readU8(opcode) && fields.readString8(to) && fields.readString8(text))
+        expectEcho(text);
+
+    send(payload);
+}
+
+void NetworkWorker::sendFragmented(const QString& recipient, const QByteArray& utf8) {
+    Fragmentation::Splitter splitter(utf8, nextMessageId++);
+    if (splitter.truncated()) {
+        qCWarning(lcProtocol) << "NetworkWorker::sendMessage: mensaje mayor a" << Fragmentation::MaxMessageSize
+                 << "bytes, se trunca";
+    }
+
+    qCDebug(lcProtocol) << "enviando mensaje de" << utf8.size() << "bytes en"
+             << splitter.count() << "fragmentos";
+
+    // El eco se empareja con el mensaje reensamblado, es decir, lo que cupo
+    // en los fragmentos aunque se haya truncado
+    if (splitter.count() > 0) {
+        const QByteArrayView last = splitter.chunk(splitter.count() - 1);
+        expectEcho(QByteArrayView(utf8.constData(), last.data() + last.size() - utf8.constData()));
+    }
+    for (int i = 0; i < splitter.count(); ++i) {
+        send(frames.sendMessageUtf8(recipient, splitter.header(i), splitter.chunk(i)));
+    }
+}
+
+void NetworkWorker::expireFragments() {
+    const int expired = reassembler.expire(QDateTime::currentMSecsSinceEpoch());
+    if (expired > 0)
+        qCWarning(lcProtocol) << "NetworkWorker:" << expired << "mensajes fragmentados expiraron incompletos";
+    if (reassembler.pendingCount() == 0)
+        fragmentTimer->stop();
+}
+
+void NetworkWorker::getHistoryPage(const QString& chat, quint32 cursor, quint8 limit) {
+    if (!socket || !socket->isValid())
+        return;
+    expectReply(pendingHistory);
+    if (pendingPages.size() == MaxPendingRoundTrips)
+        pendingPages.dequeue();
+    pendingPages.enqueue(PendingPage{chat, cursor != 0});
+    send(frames.getHistoryPage(chat, cursor, limit));
+}
+
+void NetworkWorker::onHistoryPage(const Protocol::HistoryFrame& frame) {
+    // Un 56 que nadie pidió (servidor sin paginación) se trata como la
+    // página más reciente de un chat desconocido.
+    const PendingPage page = pendingPages.isEmpty() ? PendingPage{} : pendingPages.dequeue();
+
+    // Un mensaje largo puede quedar partido entre dos páginas: sus primeros
+    // fragmentos al final de la página más vieja y el resto al comienzo de
+    // la más nueva, que llega antes. Esos últimos se guardan y se agregan al
+    // final de la página siguiente del mismo chat.
+    QList<HistoryFragment> carried;
+    if (page.older && page.chat == historyChat)
+        carried.swap(historyCarry);
+    historyCarry.clear();
+    historyChat = page.chat;
+    historyReassembler.clear();
+
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    NetworkEvent event{NetworkEvent::History};
+    event.hasCursor = frame.hasCursor;
+    event.nextCursor = frame.nextCursor;
+    event.entries.reserve(frame.messages.size() + carried.size());
+
+    auto feed = [&](QByteArrayView sender, QByteArrayView text, quint32 position) {
+        QByteArray complete;
+        switch (historyReassembler.feed(sender, text, now, complete)) {
+        case Fragmentation::Reassembler::NotFragment:
+            event.entries.append(HistoryEntry{Protocol::toString(sender), Protocol::toString(text), frame.hasCursor, position});
+            break;
+        case Fragmentation::Reassembler::Complete:
+            event.entries.append(HistoryEntry{Protocol::toString(sender), QString::fromUtf8(complete), frame.hasCursor, position});
+            break;
+        case Fragmentation::Reassembler::Incomplete:
+            break;
+        case Fragmentation::Reassembler::Dropped:
+            // Sin su comienzo en esta página: puede estar en la anterior.
+            // Un mensaje no pasa de MaxFragments, así que eso acota lo guardado.
+            if (frame.hasCursor && frame.nextCursor != 0
+                && historyCarry.size() < Fragmentation::MaxFragments) {
+                historyCarry.append(HistoryFragment{sender.toByteArray(), text.toByteArray(), position});
+            }
+            break;
+        }
+    };
+
+    // Sin cursor la página no dice dónde empieza: las entradas van sin posición
+    quint32 position = frame.hasCursor ? frame.nextCursor : 0;
+    for (const Protocol::MessageFrame &entry : frame.messages)
+        feed(entry.sender, entry.text, position++);
+    for (const HistoryFragment &fragment : std::as_const(carried))
+        feed(fragment.sender, fragment.text, fragment.position);
+
+    // Lo que sigue incompleto al terminar la página ya no tiene con qué completarse
+    if (historyReassembler.pendingCount() > 0) {
+        qCDebug(lcProtocol) << "NetworkWorker:" << historyReassembler.pendingCount()
+                            << "mensajes fragmentados incompletos en el historial";
+        historyReassembler.clear();
+    }
+
+    post(std::move(event));
+}
+
+void NetworkWorker::changeStatus(quint8 newStatus) {
+    if (!socket || !socket->isValid())
+        return;
+    ownStatus = newStatus;
+    const QByteArray &payload = frames.changeStatus(username, newStatus);
+    send(payload);
+    qCDebug(lcPresence) << "cambio de estado a" << newStatus << "- payload:" << payload.toHex(' ');
+}
+
+void NetworkWorker::requestRosterResync() {
+    // Como mucho una resincronización cada RosterResyncIntervalMs, para que
+    // una ráfaga de eventos desconocidos no dispare una descarga por evento.
+    if (lastRosterResync.isValid() && lastRosterResync.elapsed() < RosterResyncIntervalMs)
+        return;
+    lastRosterResync.start();
+
+    qCInfo(lcRoster) << "NetworkWorker: roster desincronizado, solicitando lista completa";
+    if (socket->isValid())
+        requestUserList();
+}
+
+void NetworkWorker::requestUserList() {
+    expectReply(pendingUserLists);
+    send(frames.listUsers());
+}
+
+void NetworkWorker::expectEcho(QByteArrayView text) {
+    if (pendingEchoes.size() == MaxPendingRoundTrips)
+        pendingEchoes.dequeue();
+    pendingEchoes.enqueue(PendingEcho{clock.nsecsElapsed(), qHash(text)});
+}
+
+void NetworkWorker::matchEcho(QByteArrayView text) {
+    // Los ecos llegan en orden: los envíos anteriores al que coincide ya no
+    // van a tener eco (el servidor los rechazó) y se descartan.
+    const size_t hash = qHash(text);
+    for (qsizetype i = 0; i < pendingEchoes.size(); ++i) {
+        if (pendingEchoes[i].textHash != hash)
+            continue;
+        latency->record(LatencyTracker::MessageEcho, clock.nsecsElapsed() - pendingEchoes[i].sentNs);
+        pendingEchoes.remove(0, i + 1);
+        return;
+    }
+}
+
+void NetworkWorker::expectReply(QQueue<qint64>& pending) {
+    if (pending.size() == MaxPendingRoundTrips)
+        pending.dequeue();
+    pending.enqueue(clock.nsecsElapsed());
+}
+
+void NetworkWorker::completeReply(QQueue<qint64>& pending, LatencyTracker::Action action) {
+    // Una respuesta que nadie pidió (por ejemplo, un 51 espontáneo) no se mide
+    if (!pending.isEmpty())
+        latency->record(action, clock.nsecsElapsed() - pending.dequeue());
+}
+
+void NetworkWorker::logCompressionStats() const {
+    const CompressionStats stats = compressionStats();
+    if (stats.frames == 0)
+        return;
+    qCInfo(lcProtocol).nospace() << "NetworkWorker: " << stats.frames << " frames comprimidos, "
+                                 << stats.compressedBytes << " -> " << stats.inflatedBytes << " bytes (ratio "
+                                 << stats.ratio() << "), inflado "
+                                 << LatencyHistogram::format(qint64(stats.inflateNanos)) << " en total";
+}
+
+NetworkWorker::CompressionStats NetworkWorker::compressionStats() const {
+    QMutexLocker locker(&statsMutex);
+    return compression;
+}
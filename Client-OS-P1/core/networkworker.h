@@ -0,0 +1,214 @@
+#ifndef NETWORKWORKER_H
+#define NETWORKWORKER_H
+#pragma once
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QObject>
+#include <QQueue>
+#include <QStringList>
+#include <QTimer>
+#include <QUrl>
+#include <QWebSocket>
+
+#include <functional>
+
+#include "fragmentation.h"
+#include "latencytracker.h"
+#include "protocolcodec.h"
+#include "reconnectpolicy.h"
+#include "roster.h"
+#include "spscqueue.h"
+
+struct HistoryEntry {
+    QString sender;
+    QString message;
+    // Posición en el historial del servidor; la del último fragmento si el
+    // mensaje llegó partido. Solo la hay en páginas con cursor.
+    bool hasPosition = false;
+    quint32 position = 0;
+};
+
+// Evento ya decodificado que el hilo de red entrega a la interfaz.
+struct NetworkEvent {
+    enum Type : quint8 {
+        Connected,
+        Disconnected,
+        Message,        // name: remitente, text
+        Notice,         // text: aviso de conexión o presencia para el chat general
+        UserList,       // users: "nombre (Estado)"
+        UserStatus,     // status: estado propio
+        UserConnected,  // name
+        StatusChanged,  // name, status: cambio que alteró el roster
+        History,        // entries, hasCursor, nextCursor
+        Error,          // status: código de error del opcode 50
+        Reconnecting,   // attempt, retryMs: se perdió la conexión y se reintenta
+        Resumed         // reconectado; el roster llega como StatusChanged
+    };
+
+    Type type = Message;
+    quint8 status = 0;
+    int attempt = 0;
+    qint64 retryMs = 0;
+    bool hasCursor = false;
+    quint32 nextCursor = 0;
+    QString name;
+    QString text;
+    QStringList users;
+    QList<HistoryEntry> entries;
+};
+
+// Todo lo que toca la red: el QWebSocket, la decodificación de frames, el
+// rearmado de fragmentos y el roster con sus filtros de presencia.
+//
+// Vive en el hilo de red de WebSocketClient. Los eventos decodificados van a
+// una SpscQueue y `notify` avisa al consumidor; si la cola se llena (la
+// interfaz está ocupada) los eventos esperan aquí, en orden, y se reintenta
+// un poco después en lugar de bloquear la lectura del socket.
+//
+// También mide la ida y vuelta de los envíos que esperan respuesta (4 con su
+// eco, 5 con 56, 1 con 51) y la registra en `latency`. Se mide aquí, en el
+// hilo de red, así que cubre red y servidor pero no el tiempo de la interfaz.
+// Los frames y bytes por opcode en cada sentido y el tiempo de decodificación
+// van al registro de Metrics.
+//
+// Si la conexión se cae sin que nadie llamara a close(), se reabre sola según
+// ReconnectPolicy. Al volver se envía Resumed en lugar de Connected: la
+// interfaz conserva su roster, el chat abierto y el desplazamiento, la lista
+// de usuarios se compara con la copia local y solo se entregan las
+// diferencias, y se restaura el último estado propio pedido.
+class NetworkWorker : public QObject {
+    Q_OBJECT
+public:
+    using Queue = SpscQueue<NetworkEvent, 1024>;
+
+    // Estadísticas de los frames recibidos comprimidos (opcode 57)
+    struct CompressionStats {
+        quint64 frames = 0;
+        quint64 compressedBytes = 0;
+        quint64 inflatedBytes = 0;
+        quint64 inflateNanos = 0;
+
+        double ratio() const {
+            return compressedBytes ? double(inflatedBytes) / double(compressedBytes) : 0.0;
+        }
+    };
+
+    NetworkWorker(const QUrl& url, const QString& username, Queue* queue, LatencyTracker* latency,
+                  std::function<void()> notify);
+
+    // Todo lo que sigue se llama en el hilo de red.
+    void open();
+    void close();
+    void sendMessage(const QString& recipient, const QString& message);
+    void getHistoryPage(const QString& chat, quint32 cursor, quint8 limit);
+    void changeStatus(quint8 newStatus);
+
+    // Se puede llamar desde cualquier hilo.
+    CompressionStats compressionStats() const;
+
+private:
+    // Último aviso de presencia por usuario, para descartar repetidos.
+    struct PresenceStamp {
+        quint8 status;
+        qint64 atMs;
+    };
+
+    static constexpr qint64 RosterResyncIntervalMs = 2000;
+    static constexpr qint64 PresenceDedupMs = 1000;
+    static constexpr int OverflowRetryMs = 2;
+    // Envíos sin respuesta que se recuerdan; los más viejos se olvidan.
+    static constexpr int MaxPendingRoundTrips = 256;
+
+    // Mensaje enviado esperando su eco; basta el hash del texto para emparejarlo
+    struct PendingEcho {
+        qint64 sentNs;
+        size_t textHash;
+    };
+
+    // Página de historial pedida; las respuestas llegan en el mismo orden
+    struct PendingPage {
+        QString chat;
+        bool older;
+    };
+
+    // Fragmento del comienzo de una página cuyo índice 0 quedó en la página
+    // anterior (más vieja); se rearma cuando esa página llega.
+    struct HistoryFragment {
+        QByteArray sender;
+        QByteArray text;
+        quint32 position;
+    };
+
+    void send(const QByteArray& frame);
+    void onConnected();
+    void onSocketLost();
+    // Resumen de compressionStats() en el log, al perder la conexión
+    void logCompressionStats() const;
+    void resyncRoster(const Protocol::UserListFrame& frame);
+    void deliverSelfStatus(const Protocol::UserListFrame& frame);
+    void onBinaryMessage(const QByteArray& message);
+    void onStatusChange(const Protocol::StatusChangeFrame& frame);
+    void onHistoryPage(const Protocol::HistoryFrame& frame);
+    void sendFragmented(const QString& recipient, const QByteArray& utf8);
+    void expireFragments();
+    void requestRosterResync();
+    void post(NetworkEvent&& event);
+    void postMessage(const QString& sender, const QString& text);
+    void postNotice(const QString& text);
+    void flushOverflow();
+    void requestUserList();
+    void expectEcho(QByteArrayView text);
+    void matchEcho(QByteArrayView text);
+    void expectReply(QQueue<qint64>& pending);
+    void completeReply(QQueue<qint64>& pending, LatencyTracker::Action action);
+
+    QUrl url;
+    QString username;
+    QByteArray usernameUtf8;
+    Queue* queue;
+    LatencyTracker* latency;
+    std::function<void()> notify;
+    QList<NetworkEvent> overflow;
+
+    // Se crean en open(), ya en el hilo de red
+    QWebSocket* socket = nullptr;
+    QTimer* fragmentTimer = nullptr;
+    QTimer* overflowTimer = nullptr;
+    QTimer* reconnectTimer = nullptr;
+
+    // Reconexión
+    QUrl fullUrl;
+    ReconnectPolicy reconnect;
+    bool online = false;
+    bool closing = false;
+    bool everConnected = false;
+    bool resumed = false;           // la conexión actual es una reconexión
+    bool rosterResync = false;      // reconectado, esperando el 51
+    bool selfStatusPending = false; // el estado propio sale del próximo 51
+    quint8 ownStatus = Roster::Active;
+
+    Protocol::FrameBuilder frames;
+    Fragmentation::Reassembler reassembler;
+    quint16 nextMessageId = 0;
+    Roster roster;
+    QHash<QString, PresenceStamp> presence;
+    QElapsedTimer clock;
+    QElapsedTimer lastRosterResync;
+    QQueue<PendingEcho> pendingEchoes;
+    QQueue<qint64> pendingHistory;
+    QQueue<PendingPage> pendingPages;
+    // Historial del chat que se está paginando. Se descarta con cada página
+    // más reciente o al cambiar de chat.
+    QString historyChat;
+    QList<HistoryFragment> historyCarry;
+    Fragmentation::Reassembler historyReassembler;
+    QQueue<qint64> pendingUserLists;
+
+    mutable QMutex statsMutex;
+    CompressionStats compression;
+};
+
+#endif // NETWORKWORKER_H
@@ -0,0 +1,191 @@
+#include "protocolcodec.h"
+
+#include <cstring>
+
+namespace Protocol {
+
+namespace {
+
+// Salta el opcode y verifica que sea el esperado.
+bool beginFrame(FrameReader &in, quint8 expected) {
+    quint8 opcode;
+    return in.readU8(opcode) && opcode == expected;
+}
+
+// Retrocede hasta el inicio de un code point para no cortar una secuencia
+// UTF-8 a la mitad.
+qsizetype utf8Boundary(const char *text, qsizetype length) {
+    while (length > 0 && (quint8(text[length]) & 0xC0) == 0x80)
+        --length;
+    return length;
+}
+
+} // namespace
+
+bool decodeError(QByteArrayView frame, ErrorFrame &out) {
+    FrameReader in(frame);
+    return beginFrame(in, Error) && in.readU8(out.code);
+}
+
+bool decodeUserList(QByteArrayView frame, UserListFrame &out) {
+    FrameReader in(frame);
+    quint8 numUsers;
+    if (!beginFrame(in, UserList) || !in.readU8(numUsers))
+        return false;
+
+    // Cada entrada ocupa al menos 2 bytes ([len][status]); descartamos
+    // frames truncados antes de recorrerlos.
+    if (in.remaining() < qsizetype(numUsers) * 2)
+        return false;
+
+    out.users.clear();
+    out.users.reserve(numUsers);
+    for (int i = 0; i < numUsers; ++i) {
+        UserEntry entry;
+        if (!in.readString8(entry.name) || !in.readU8(entry.status))
+            return false;
+        out.users.append(entry);
+    }
+    return true;
+}
+
+bool decodeUserInfo(QByteArrayView frame, UserInfoFrame &out) {
+    FrameReader in(frame);
+    return beginFrame(in, UserInfo) && in.readString8(out.name) && in.readU8(out.status);
+}
+
+bool decodeUserConnected(QByteArrayView frame, UserConnectedFrame &out) {
+    FrameReader in(frame);
+    return beginFrame(in, UserConnected) && in.readString8(out.name);
+}
+
+bool decodeStatusChange(QByteArrayView frame, StatusChangeFrame &out) {
+    FrameReader in(frame);
+    return beginFrame(in, StatusChange) && in.readString8(out.name) && in.readU8(out.status);
+}
+
+bool decodeMessage(QByteArrayView frame, MessageFrame &out) {
+    FrameReader in(frame);
+    return beginFrame(in, ChatMessage) && in.readString8(out.sender) && in.readString8(out.text);
+}
+
+bool decodeHistory(QByteArrayView frame, HistoryFrame &out) {
+    FrameReader in(frame);
+    quint8 numMessages;
+    if (!beginFrame(in, ChatHistory) || !in.readU8(numMessages))
+        return false;
+
+    // Cada mensaje ocupa al menos 2 bytes ([len sender][len msg]).
+    if (in.remaining() < qsizetype(numMessages) * 2)
+        return false;
+
+    out.messages.clear();
+    out.messages.reserve(numMessages);
+    for (int i = 0; i < numMessages; ++i) {
+        MessageFrame message;
+        if (!in.readString8(message.sender) || !in.readString8(message.text))
+            return false;
+        out.messages.append(message);
+    }
+
+    out.hasCursor = in.readU32(out.nextCursor);
+    if (!out.hasCursor)
+        out.nextCursor = 0;
+    return true;
+}
+
+bool inflateFrame(QByteArrayView frame, QByteArray &out) {
+    // [57][tamaño u32 BE][flujo zlib]
+    if (opcodeOf(frame) != Compressed || frame.size() < 1 + 4)
+        return false;
+
+    const uchar *data = reinterpret_cast<const uchar *>(frame.data()) + 1;
+    const qsizetype declared = (qsizetype(data[0]) << 24) | (qsizetype(data[1]) << 16)
+                             | (qsizetype(data[2]) << 8) | qsizetype(data[3]);
+    if (declared == 0 || declared > MaxInflatedSize)
+        return false;
+
+    out = qUncompress(data, frame.size() - 1);
+    // Un frame comprimido nunca envuelve a otro frame comprimido.
+    return out.size() == declared && opcodeOf(out) != Compressed;
+}
+
+char *FrameBuilder::begin(quint8 opcode, qsizetype maxSize) {
+    // resize() solo reserva memoria si el frame no cabe en la capacidad ya
+    // obtenida en envíos anteriores.
+    m_buffer.resize(maxSize);
+    char *out = m_buffer.data();
+    *out++ = char(opcode);
+    return out;
+}
+
+const QByteArray &FrameBuilder::finish(const char *end) {
+    m_buffer.resize(end - m_buffer.constData());
+    return m_buffer;
+}
+
+char *FrameBuilder::writeString8(char *out, QStringView text) {
+    // Se codifica justo después del byte de longitud y luego se rellena el
+    // prefijo con la longitud UTF-8 real (no la de UTF-16).
+    char *data = out + 1;
+    m_encoder.resetState();
+    qsizetype length = m_encoder.appendToBuffer(data, text) - data;
+    if (length > MaxString8)
+        length = utf8Boundary(data, MaxString8);
+    *out = char(quint8(length));
+    return data + length;
+}
+
+const QByteArray &FrameBuilder::listUsers() {
+    return finish(begin(ListUsers, 1));
+}
+
+const QByteArray &FrameBuilder::getUser(QStringView username) {
+    char *out = begin(GetUser, 2 + m_encoder.requiredSpace(username.size()));
+    return finish(writeString8(out, username));
+}
+
+const QByteArray &FrameBuilder::changeStatus(QStringView username, quint8 status) {
+    char *out = begin(ChangeStatus, 3 + m_encoder.requiredSpace(username.size()));
+    out = writeString8(out, username);
+    *out++ = char(status);
+    return finish(out);
+}
+
+const QByteArray &FrameBuilder::sendMessage(QStringView recipient, QStringView message) {
+    char *out = begin(SendChatMessage, 3 + m_encoder.requiredSpace(recipient.size())
+                                         + m_encoder.requiredSpace(message.size()));
+    out = writeString8(out, recipient);
+    return finish(writeString8(out, message));
+}
+
+const QByteArray &FrameBuilder::sendMessageUtf8(QStringView recipient, QByteArrayView prefix, QByteArrayView body) {
+    const qsizetype length = prefix.size() + body.size();
+    Q_ASSERT(length <= MaxString8);
+
+    char *out = begin(SendChatMessage, 3 + m_encoder.requiredSpace(recipient.size()) + length);
+    out = writeString8(out, recipient);
+    *out++ = char(quint8(length));
+    std::memcpy(out, prefix.data(), prefix.size());
+    out += prefix.size();
+    std::memcpy(out, body.data(), body.size());
+    return finish(out + body.size());
+}
+
+const QByteArray &FrameBuilder::getHistory(QStringView chatName) {
+    char *out = begin(GetChatHistory, 2 + m_encoder.requiredSpace(chatName.size()));
+    return finish(writeString8(out, chatName));
+}
+
+const QByteArray &FrameBuilder::getHistoryPage(QStringView chatName, quint32 cursor, quint8 limit) {
+    char *out = begin(GetChatHistory, 2 + m_encoder.requiredSpace(chatName.size()) + 5);
+    out = writeString8(out, chatName);
+    *out++ = char(cursor >> 24);
+    *out++ = char(cursor >> 16);
+    *out++ = char(cursor >> 8);
+    *out++ = char(cursor);
+    *out++ = char(limit);
+    return finish(out);
+}
+
+} // namespace Protocol
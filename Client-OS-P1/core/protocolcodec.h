@@ -0,0 +1,223 @@
+#ifndef PROTOCOLCODEC_H
+#define PROTOCOLCODEC_H
+#pragma once
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QString>
+#include <QStringEncoder>
+#include <QStringView>
+#include <QVarLengthArray>
+
+// Codificación y decodificación de los frames binarios del protocolo de chat.
+//
+// Los decodificadores no copian: cada campo de texto es una vista
+// (QByteArrayView) sobre el QByteArray original del frame, por lo que solo
+// son válidos mientras ese buffer siga vivo. Para conservar un texto más allá
+// del frame hay que llamar a Protocol::toString().
+namespace Protocol {
+
+// Opcodes cliente -> servidor
+enum ClientOpcode : quint8 {
+    ListUsers       = 1,
+    GetUser         = 2,
+    ChangeStatus    = 3,
+    SendChatMessage = 4,
+    GetChatHistory  = 5
+};
+
+// Opcodes servidor -> cliente
+enum ServerOpcode : quint8 {
+    Error         = 50,
+    UserList      = 51,
+    UserInfo      = 52,
+    UserConnected = 53,
+    StatusChange  = 54,
+    ChatMessage   = 55,
+    ChatHistory   = 56,
+    Compressed    = 57
+};
+
+// Compresión negociada: si el cliente abre el WebSocket con
+// `compress=zlib` en la URL, el servidor puede enviar los frames grandes
+// (historial 56 y lista de usuarios 51) envueltos como
+//     [57][qCompress(frame original completo)]
+// donde qCompress antepone el tamaño descomprimido en 4 bytes big-endian.
+constexpr char CompressionParam[] = "compress";
+constexpr char CompressionMode[] = "zlib";
+// Límite del tamaño declarado, para no reservar memoria por un frame hostil.
+constexpr qsizetype MaxInflatedSize = 16 * 1024 * 1024;
+
+struct ErrorFrame {
+    quint8 code = 0;
+};
+
+struct UserEntry {
+    QByteArrayView name;
+    quint8 status = 0;
+};
+
+struct UserListFrame {
+    QVarLengthArray<UserEntry, 64> users;
+};
+
+struct UserInfoFrame {
+    QByteArrayView name;
+    quint8 status = 0;
+};
+
+struct UserConnectedFrame {
+    QByteArrayView name;
+};
+
+struct StatusChangeFrame {
+    QByteArrayView name;
+    quint8 status = 0;
+};
+
+struct MessageFrame {
+    QByteArrayView sender;
+    QByteArrayView text;
+};
+
+struct HistoryFrame {
+    QVarLengthArray<MessageFrame, 64> messages;
+    // Historial paginado: posición en el historial del servidor del primer
+    // mensaje de la página; pedirla como cursor trae la página anterior
+    // (0 = no hay más). Los servidores sin paginación no lo envían.
+    bool hasCursor = false;
+    quint32 nextCursor = 0;
+};
+
+// Cursor con verificación de límites sobre un frame. Ninguna lectura pasa
+// de m_end: si faltan bytes la lectura falla y el cursor no avanza.
+class FrameReader {
+public:
+    explicit FrameReader(QByteArrayView frame)
+        : m_pos(frame.data()), m_end(frame.data() + frame.size()) {}
+
+    qsizetype remaining() const { return m_end - m_pos; }
+    bool atEnd() const { return m_pos == m_end; }
+
+    bool readU8(quint8 &out) {
+        if (m_pos == m_end)
+            return false;
+        out = quint8(*m_pos++);
+        return true;
+    }
+
+    // Entero de 32 bits en big-endian
+    bool readU32(quint32 &out) {
+        if (remaining() < 4)
+            return false;
+        const uchar *p = reinterpret_cast<const uchar *>(m_pos);
+        out = (quint32(p[0]) << 24) | (quint32(p[1]) << 16) | (quint32(p[2]) << 8) | quint32(p[3]);
+        m_pos += 4;
+        return true;
+    }
+
+    // Cadena con prefijo de longitud de un byte: [len][bytes...]
+    bool readString8(QByteArrayView &out) {
+        if (m_pos == m_end)
+            return false;
+        const qsizetype length = quint8(*m_pos);
+        if (remaining() < 1 + length)
+            return false;
+        out = QByteArrayView(m_pos + 1, length);
+        m_pos += 1 + length;
+        return true;
+    }
+
+private:
+    const char *m_pos;
+    const char *m_end;
+};
+
+inline QString toString(QByteArrayView utf8) {
+    return QString::fromUtf8(utf8);
+}
+
+// Devuelve el opcode del frame, o 0 si el frame está vacío.
+inline quint8 opcodeOf(QByteArrayView frame) {
+    return frame.isEmpty() ? 0 : quint8(frame.front());
+}
+
+// Cada decodificador recibe el frame completo (incluido el opcode) y
+// devuelve false si el frame está truncado o mal formado.
+bool decodeError(QByteArrayView frame, ErrorFrame &out);
+bool decodeUserList(QByteArrayView frame, UserListFrame &out);
+bool decodeUserInfo(QByteArrayView frame, UserInfoFrame &out);
+bool decodeUserConnected(QByteArrayView frame, UserConnectedFrame &out);
+bool decodeStatusChange(QByteArrayView frame, StatusChangeFrame &out);
+bool decodeMessage(QByteArrayView frame, MessageFrame &out);
+bool decodeHistory(QByteArrayView frame, HistoryFrame &out);
+// Descomprime un frame 57 y devuelve el frame original (con su opcode).
+bool inflateFrame(QByteArrayView frame, QByteArray &out);
+
+// Construye frames cliente -> servidor sobre un buffer reutilizable.
+//
+// Cada frame se dimensiona una sola vez (cota superior de UTF-8) y cada texto
+// se codifica directamente en el buffer, sin QByteArray intermedios; el
+// prefijo de longitud se escribe con los bytes UTF-8 reales. Como el buffer
+// conserva su capacidad entre envíos, en régimen estable no hay reservas de
+// memoria. La referencia devuelta es válida hasta la siguiente llamada.
+class FrameBuilder {
+public:
+    // Máximo de bytes que admite un campo con prefijo de un byte.
+    static constexpr qsizetype MaxString8 = 255;
+
+    const QByteArray &listUsers();
+    const QByteArray &getUser(QStringView username);
+    const QByteArray &changeStatus(QStringView username, quint8 status);
+    const QByteArray &sendMessage(QStringView recipient, QStringView message);
+    // Variante para texto ya codificado: el campo de mensaje es prefix + body
+    // y ambos juntos no deben superar MaxString8 bytes.
+    const QByteArray &sendMessageUtf8(QStringView recipient, QByteArrayView prefix, QByteArrayView body);
+    const QByteArray &getHistory(QStringView chatName);
+    // Página de historial: [5][len][chat][cursor u32 BE][límite]. Cursor 0
+    // pide la página más reciente. Un servidor sin paginación ignora los
+    // bytes extra y responde con todo el historial.
+    const QByteArray &getHistoryPage(QStringView chatName, quint32 cursor, quint8 limit);
+
+private:
+    char *begin(quint8 opcode, qsizetype maxSize);
+    const QByteArray &finish(const char *end);
+    char *writeString8(char *out, QStringView text);
+
+    QByteArray m_buffer;
+    QStringEncoder m_encoder{QStringEncoder::Utf8};
+};
+
+// Escritura secuencial de frames servidor -> cliente. El cliente no los
+// envía nunca; la usan el servidor de prueba y los benchmarks para armar
+// frames 50 a 56.
+class FrameWriter {
+public:
+    explicit FrameWriter(quint8 opcode) { m_data.append(char(opcode)); }
+
+    FrameWriter &u8(quint8 value) {
+        m_data.append(char(value));
+        return *this;
+    }
+    // Entero de 32 bits en big-endian
+    FrameWriter &u32(quint32 value) {
+        const char bytes[4] = {char(value >> 24), char(value >> 16), char(value >> 8), char(value)};
+        m_data.append(bytes, 4);
+        return *this;
+    }
+    // [len][bytes...]; lo que pase de 255 bytes se corta
+    FrameWriter &string8(QByteArrayView text) {
+        const qsizetype length = qMin<qsizetype>(text.size(), FrameBuilder::MaxString8);
+        u8(quint8(length));
+        m_data.append(text.first(length));
+        return *this;
+    }
+    const QByteArray &data() const { return m_data; }
+
+private:
+    QByteArray m_data;
+};
+
+} // namespace Protocol
+
+#endif // PROTOCOLCODEC_H
@@ -0,0 +1,27 @@
+#include "reconnectpolicy.h"
+
+ReconnectPolicy::ReconnectPolicy(quint32 seed)
+    : m_random(seed)
+{
+}
+
+void ReconnectPolicy::connected() {
+    m_connectedAt.start();
+}
+
+qint64 ReconnectPolicy::nextDelayMs() {
+    if (m_connectedAt.isValid() && m_connectedAt.elapsed() >= StableAfterMs)
+        m_attempts = 0;
+    m_connectedAt.invalidate();
+
+    // 2^16 * BaseDelayMs ya supera MaxDelayMs: el exponente no necesita crecer más
+    const int exponent = qMin(m_attempts, 16);
+    const qint64 ceiling = qMin(MaxDelayMs, BaseDelayMs << exponent);
+    ++m_attempts;
+    return qint64(m_random.bounded(quint32(ceiling) + 1));
+}
+
+void ReconnectPolicy::reset() {
+    m_connectedAt.invalidate();
+    m_attempts = 0;
+}
@@ -0,0 +1,39 @@
+#ifndef RECONNECTPOLICY_H
+#define RECONNECTPOLICY_H
+#pragma once
+
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+
+// Espera entre intentos de reconexión.
+//
+// Backoff exponencial con jitter completo: el intento n espera un tiempo
+// uniforme entre 0 y min(MaxDelayMs, BaseDelayMs * 2^n). Un corte breve se
+// recupera en menos de un segundo y, cuando el servidor se reinicia, los
+// clientes que cayeron juntos se reparten en el tiempo en lugar de volver
+// todos a la vez. Una conexión que duró al menos StableAfterMs reinicia la
+// serie; una que se cae enseguida sigue esperando cada vez más.
+class ReconnectPolicy {
+public:
+    static constexpr qint64 BaseDelayMs = 500;
+    static constexpr qint64 MaxDelayMs = 30000;
+    static constexpr qint64 StableAfterMs = 10000;
+
+    explicit ReconnectPolicy(quint32 seed = QRandomGenerator::system()->generate());
+
+    // Se abrió la conexión.
+    void connected();
+    // Se perdió la conexión o falló un intento: devuelve la demora antes del
+    // próximo intento y avanza la serie.
+    qint64 nextDelayMs();
+    // Intentos desde la última conexión estable.
+    int attempts() const { return m_attempts; }
+    void reset();
+
+private:
+    QRandomGenerator m_random;
+    QElapsedTimer m_connectedAt;
+    int m_attempts = 0;
+};
+
+#endif // RECONNECTPOLICY_H
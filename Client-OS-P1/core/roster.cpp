@@ -0,0 +1,35 @@
+#include "roster.h"
+
+void Roster::insert(const QString &username, quint8 status) {
+    if (status == Disconnected)
+        m_status.remove(username);
+    else
+        m_status.insert(username, status);
+}
+
+Roster::Change Roster::connectUser(const QString &username) {
+    auto it = m_status.find(username);
+    if (it == m_status.end()) {
+        m_status.insert(username, Active);
+        return Added;
+    }
+    if (*it == Active)
+        return Unchanged;
+    *it = Active;
+    return Updated;
+}
+
+Roster::Change Roster::changeStatus(const QString &username, quint8 status) {
+    auto it = m_status.find(username);
+    if (it == m_status.end())
+        return status == Disconnected ? Unchanged : Unknown;
+
+    if (status == Disconnected) {
+        m_status.erase(it);
+        return Removed;
+    }
+    if (*it == status)
+        return Unchanged;
+    *it = status;
+    return Updated;
+}
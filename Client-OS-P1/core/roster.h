@@ -0,0 +1,44 @@
+#ifndef ROSTER_H
+#define ROSTER_H
+#pragma once
+
+#include <QHash>
+#include <QString>
+
+// Copia local de la lista de usuarios conectados.
+//
+// Se carga completa con el opcode 51 (al conectar o al detectar
+// desincronización) y después se mantiene con los eventos 53 y 54 como
+// deltas, sin volver a pedir la lista entera.
+class Roster {
+public:
+    enum Change {
+        Unchanged,
+        Added,
+        Updated,
+        Removed,
+        Unknown     // delta sobre un usuario que no conocemos: hay desincronización
+    };
+
+    static constexpr quint8 Disconnected = 0;
+    static constexpr quint8 Active = 1;
+
+    void clear() { m_status.clear(); }
+    void reserve(qsizetype size) { m_status.reserve(size); }
+    void insert(const QString &username, quint8 status);
+
+    // Opcode 53: el usuario entra como activo.
+    Change connectUser(const QString &username);
+    // Opcode 54: un estado 0 significa que el usuario salió.
+    Change changeStatus(const QString &username, quint8 status);
+
+    bool contains(const QString &username) const { return m_status.contains(username); }
+    quint8 status(const QString &username) const { return m_status.value(username, Disconnected); }
+    qsizetype size() const { return m_status.size(); }
+    QList<QString> users() const { return m_status.keys(); }
+
+private:
+    QHash<QString, quint8> m_status;
+};
+
+#endif // ROSTER_H
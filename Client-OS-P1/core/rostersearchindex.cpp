@@ -0,0 +1,232 @@
+#include "rostersearchindex.h"
+
+#include <algorithm>
+
+namespace {
+
+// Rangos de puntaje: un prefijo siempre gana a una subcadena, una subcadena
+// a una subsecuencia y una subsecuencia a un parecido por trigramas.
+constexpr int PrefixBase = 3000;
+constexpr int SubstringBase = 2000;
+constexpr int SubsequenceBase = 1000;
+constexpr int TrigramBase = 500;
+constexpr int RangeWidth = 499;
+
+} // namespace
+
+void RosterSearchIndex::insert(const QString &name) {
+    if (name.isEmpty() || m_ids.contains(name))
+        return;
+
+    const QString folded = name.toCaseFolded();
+    const int id = int(m_entries.size());
+    m_entries.append(Entry{m_buffer.size(), folded.size(), name, true});
+    m_buffer += folded;
+    m_buffer += QChar(0);
+    m_ids.insert(name, id);
+
+    for (qsizetype i = 0; i + 3 <= folded.size(); ++i) {
+        QList<int> &ids = m_trigrams[trigramKey(folded.constData() + i)];
+        if (ids.isEmpty() || ids.last() != id)
+            ids.append(id);
+    }
+    m_sortedDirty = true;
+}
+
+void RosterSearchIndex::remove(const QString &name) {
+    const int id = m_ids.value(name, -1);
+    if (id < 0)
+        return;
+
+    // Se marca como muerta; las listas de trigramas se limpian al compactar
+    m_ids.remove(name);
+    m_entries[id].alive = false;
+    ++m_dead;
+    m_sortedDirty = true;
+
+    if (m_dead > 64 && m_dead > m_ids.size())
+        compact();
+}
+
+void RosterSearchIndex::clear() {
+    m_buffer.clear();
+    m_entries.clear();
+    m_ids.clear();
+    m_trigrams.clear();
+    m_sorted.clear();
+    m_sortedDirty = false;
+    m_dead = 0;
+}
+
+qsizetype RosterSearchIndex::memoryUsage() const {
+    // Los nombres de m_entries y las claves de m_ids comparten datos (QString
+    // implícitamente compartido): se cuentan una vez.
+    qsizetype bytes = m_buffer.capacity() * qsizetype(sizeof(QChar));
+    bytes += m_entries.capacity() * qsizetype(sizeof(Entry));
+    for (const Entry &entry : m_entries)
+        bytes += entry.name.capacity() * qsizetype(sizeof(QChar));
+    bytes += m_ids.size() * qsizetype(sizeof(QString) + sizeof(int));
+    for (const QList<int> &ids : m_trigrams)
+        bytes += qsizetype(sizeof(quint64) + sizeof(QList<int>)) + ids.capacity() * qsizetype(sizeof(int));
+    bytes += m_sorted.capacity() * qsizetype(sizeof(int));
+    return bytes;
+}
+
+QList<RosterSearchIndex::Match> RosterSearchIndex::search(const QString &query, int limit) const {
+    const QString q = query.trimmed().toCaseFolded();
+    if (q.isEmpty() || m_ids.isEmpty())
+        return {};
+
+    QHash<int, int> scores;
+    auto consider = [&scores](int id, int score) {
+        auto it = scores.find(id);
+        if (it == scores.end())
+            scores.insert(id, score);
+        else if (score > *it)
+            *it = score;
+    };
+
+    // 1. Prefijos: bisección sobre los nombres ordenados
+    sortPrefixes();
+    auto it = std::lower_bound(m_sorted.cbegin(), m_sorted.cend(), q, [this](int id, const QString &value) {
+        return folded(id).compare(value) < 0;
+    });
+    for (; it != m_sorted.cend() && folded(*it).startsWith(q); ++it)
+        consider(*it, prefixScore(m_entries.at(*it).length, q.size()));
+
+    // 2. Subcadenas
+    if (q.size() < 3) {
+        // Consulta corta: una pasada por el búfer contiguo
+        const QStringView buffer(m_buffer);
+        for (qsizetype pos = buffer.indexOf(q); pos >= 0; pos = buffer.indexOf(q, pos + 1)) {
+            const int id = entryAt(pos);
+            const Entry &entry = m_entries.at(id);
+            if (entry.alive && pos + q.size() <= entry.offset + entry.length)
+                consider(id, substringScore(folded(id), pos - entry.offset));
+        }
+    } else {
+        // Candidatos por trigramas: los que comparten todos son posibles
+        // subcadenas; los que comparten al menos la mitad, parecidos.
+        const int trigramCount = int(q.size()) - 2;
+        QHash<int, int> shared;
+        for (qsizetype i = 0; i + 3 <= q.size(); ++i) {
+            auto posting = m_trigrams.constFind(trigramKey(q.constData() + i));
+            if (posting == m_trigrams.constEnd())
+                continue;
+            for (int id : *posting)
+                ++shared[id];
+        }
+
+        for (auto entry = shared.cbegin(); entry != shared.cend(); ++entry) {
+            const int id = entry.key();
+            if (!m_entries.at(id).alive)
+                continue;
+            const QStringView name = folded(id);
+            const qsizetype pos = entry.value() >= trigramCount ? name.indexOf(q) : -1;
+            if (pos >= 0)
+                consider(id, substringScore(name, pos));
+            else if (entry.value() * 2 >= trigramCount)
+                consider(id, TrigramBase - RangeWidth + RangeWidth * entry.value() / trigramCount);
+        }
+    }
+
+    // 3. Subsecuencias, solo si todavía faltan resultados
+    if (limit < 0 || scores.size() < limit) {
+        for (int id = 0; id < m_entries.size(); ++id) {
+            if (!m_entries.at(id).alive || scores.contains(id))
+                continue;
+            const int score = subsequenceScore(folded(id), q);
+            if (score > 0)
+                consider(id, score);
+        }
+    }
+
+    QList<Match> matches;
+    matches.reserve(scores.size());
+    for (auto entry = scores.cbegin(); entry != scores.cend(); ++entry)
+        matches.append(Match{m_entries.at(entry.key()).name, entry.value()});
+
+    std::sort(matches.begin(), matches.end(), [](const Match &a, const Match &b) {
+        return a.score != b.score ? a.score > b.score : a.name < b.name;
+    });
+    if (limit >= 0 && matches.size() > limit)
+        matches.resize(limit);
+    return matches;
+}
+
+quint64 RosterSearchIndex::trigramKey(const QChar *chars) {
+    return (quint64(chars[0].unicode()) << 32) | (quint64(chars[1].unicode()) << 16) | chars[2].unicode();
+}
+
+QStringView RosterSearchIndex::folded(int id) const {
+    const Entry &entry = m_entries.at(id);
+    return QStringView(m_buffer).mid(entry.offset, entry.length);
+}
+
+int RosterSearchIndex::entryAt(qsizetype offset) const {
+    // Las entradas están en el orden en que se escribieron en el búfer
+    auto it = std::upper_bound(m_entries.cbegin(), m_entries.cend(), offset, [](qsizetype value, const Entry &entry) {
+        return value < entry.offset;
+    });
+    return int(it - m_entries.cbegin()) - 1;
+}
+
+void RosterSearchIndex::sortPrefixes() const {
+    if (!m_sortedDirty)
+        return;
+
+    m_sorted.clear();
+    m_sorted.reserve(m_ids.size());
+    for (int id = 0; id < m_entries.size(); ++id) {
+        if (m_entries.at(id).alive)
+            m_sorted.append(id);
+    }
+    std::sort(m_sorted.begin(), m_sorted.end(), [this](int a, int b) {
+        return folded(a).compare(folded(b)) < 0;
+    });
+    m_sortedDirty = false;
+}
+
+void RosterSearchIndex::compact() {
+    QList<QString> alive;
+    alive.reserve(m_ids.size());
+    for (const Entry &entry : std::as_const(m_entries)) {
+        if (entry.alive)
+            alive.append(entry.name);
+    }
+    clear();
+    for (const QString &name : std::as_const(alive))
+        insert(name);
+}
+
+int RosterSearchIndex::prefixScore(qsizetype nameLength, qsizetype queryLength) {
+    // Cuanto menos sobra del nombre, mejor
+    return PrefixBase - int(qMin<qsizetype>(nameLength - queryLength, RangeWidth));
+}
+
+int RosterSearchIndex::substringScore(QStringView name, qsizetype position) {
+    // Bonificación si la coincidencia empieza una palabra (juan_perez, "perez")
+    const bool boundary = position > 0 && !name.at(position - 1).isLetterOrNumber();
+    const int penalty = int(qMin<qsizetype>(position * 4 + name.size(), RangeWidth));
+    return SubstringBase - penalty + (boundary ? qMin(200, penalty) : 0);
+}
+
+int RosterSearchIndex::subsequenceScore(QStringView name, QStringView query) {
+    qsizetype first = -1;
+    qsizetype last = -1;
+    qsizetype matched = 0;
+    for (qsizetype i = 0; i < name.size() && matched < query.size(); ++i) {
+        if (name.at(i) == query.at(matched)) {
+            if (first < 0)
+                first = i;
+            last = i;
+            ++matched;
+        }
+    }
+    if (matched < query.size())
+        return 0;
+
+    // Menos huecos entre las letras y un comienzo temprano puntúan mejor
+    const qsizetype gaps = (last - first + 1) - query.size();
+    return SubsequenceBase - int(qMin<qsizetype>(gaps * 10 + first * 2, RangeWidth));
+}
@@ -0,0 +1,65 @@
+#ifndef ROSTERSEARCHINDEX_H
+#define ROSTERSEARCHINDEX_H
+#pragma once
+
+#include <QHash>
+#include <QList>
+#include <QString>
+
+// Índice de búsqueda sobre los nombres del roster.
+//
+// Los nombres se guardan en minúsculas de comparación (casefold) en un solo
+// búfer contiguo, separados por '\0', con una lista de nombres ordenada para
+// buscar prefijos por bisección y un índice de trigramas para subcadenas.
+// Las consultas cortas recorren el búfer una sola vez; las de tres o más
+// caracteres solo revisan los candidatos que comparten trigramas. Si hay
+// pocas coincidencias exactas se completan con coincidencias difusas
+// (subsecuencia o trigramas compartidos, para tolerar errores de tipeo).
+class RosterSearchIndex {
+public:
+    struct Match {
+        QString name;
+        int score;
+    };
+
+    static constexpr int DefaultLimit = 200;
+
+    void insert(const QString &name);
+    void remove(const QString &name);
+    void clear();
+    bool contains(const QString &name) const { return m_ids.contains(name); }
+    int size() const { return int(m_ids.size()); }
+    // Memoria aproximada del índice, en bytes.
+    qsizetype memoryUsage() const;
+
+    // Coincidencias ordenadas de mejor a peor, como mucho `limit`.
+    QList<Match> search(const QString &query, int limit = DefaultLimit) const;
+
+private:
+    struct Entry {
+        qsizetype offset;   // en m_buffer
+        qsizetype length;
+        QString name;
+        bool alive;
+    };
+
+    static quint64 trigramKey(const QChar *chars);
+    QStringView folded(int id) const;
+    int entryAt(qsizetype offset) const;
+    void sortPrefixes() const;
+    void compact();
+
+    static int prefixScore(qsizetype nameLength, qsizetype queryLength);
+    static int substringScore(QStringView name, qsizetype position);
+    static int subsequenceScore(QStringView name, QStringView query);
+
+    QString m_buffer;
+    QList<Entry> m_entries;
+    QHash<QString, int> m_ids;                  // solo entradas vivas
+    QHash<quint64, QList<int>> m_trigrams;
+    mutable QList<int> m_sorted;                // ids vivos por nombre plegado
+    mutable bool m_sortedDirty = false;
+    int m_dead = 0;
+};
+
+#endif // ROSTERSEARCHINDEX_H
@@ -0,0 +1,60 @@
+#ifndef SPSCQUEUE_H
+#define SPSCQUEUE_H
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+// Cola de capacidad fija sin locks para exactamente un productor y un
+// consumidor (cada uno en su hilo).
+//
+// Los índices crecen sin límite y se enmascaran al acceder; cada uno vive en
+// su propia línea de caché para que productor y consumidor no se pisen.
+// push() y pop() nunca bloquean: devuelven false si la cola está llena o
+// vacía.
+template <typename T, std::size_t Capacity>
+class SpscQueue {
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity debe ser potencia de 2");
+
+public:
+    SpscQueue() : m_slots(new T[Capacity]) {}
+    SpscQueue(const SpscQueue &) = delete;
+    SpscQueue &operator=(const SpscQueue &) = delete;
+
+    // Solo desde el hilo productor.
+    bool push(T &&value) {
+        const std::size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_head.load(std::memory_order_acquire) == Capacity)
+            return false;
+        m_slots[tail & Mask] = std::move(value);
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Solo desde el hilo consumidor.
+    bool pop(T &out) {
+        const std::size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_tail.load(std::memory_order_acquire))
+            return false;
+        out = std::move(m_slots[head & Mask]);
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Aproximado si se llama mientras el otro hilo trabaja.
+    std::size_t size() const {
+        return m_tail.load(std::memory_order_acquire) - m_head.load(std::memory_order_acquire);
+    }
+
+    static constexpr std::size_t capacity() { return Capacity; }
+
+private:
+    static constexpr std::size_t Mask = Capacity - 1;
+
+    alignas(64) std::atomic<std::size_t> m_head{0};
+    alignas(64) std::atomic<std::size_t> m_tail{0};
+    std::unique_ptr<T[]> m_slots;
+};
+
+#endif // SPSCQUEUE_H
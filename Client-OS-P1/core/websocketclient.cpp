@@ -0,0 +1,213 @@
+#include "websocketclient.h"
+#include <QElapsedTimer>
+#include "logging.h"
+#include "metrics.h"
+
+WebSocketClient::WebSocketClient(const QUrl& url, const QString& username, QObject* parent)
+    : QObject(parent), username(username)
+{
+    // El hilo de red avisa con una sola llamada encolada por tanda, no por evento
+    worker = new NetworkWorker(url, username, &events, &roundTrips, [this] { scheduleDrain(); });
+    worker->moveToThread(&networkThread);
+    connect(&networkThread, &QThread::finished, worker, &QObject::deleteLater);
+    networkThread.setObjectName("network");
+    networkThread.start();
+
+    QMetaObject::invokeMethod(worker, &NetworkWorker::open, Qt::QueuedConnection);
+}
+
+WebSocketClient::~WebSocketClient() {
+    QMetaObject::invokeMethod(worker, &NetworkWorker::close, Qt::BlockingQueuedConnection);
+    networkThread.quit();
+    networkThread.wait();
+}
+
+void WebSocketClient::scheduleDrain() {
+    // Se llama desde cualquiera de los dos hilos
+    if (!drainScheduled.exchange(true, std::memory_order_acq_rel))
+        QMetaObject::invokeMethod(this, &WebSocketClient::drainEvents, Qt::QueuedConnection);
+}
+
+void WebSocketClient::drainEvents() {
+    // Se baja la bandera antes de leer: un evento que llegue durante la
+    // tanda vuelve a programar otra.
+    drainScheduled.store(false, std::memory_order_release);
+
+    // Eventos que esperaban al empezar la tanda
+    static Metrics::Gauge& depth = Metrics::gauge("queue.networkEvents");
+    depth.set(qint64(events.size()));
+
+    QElapsedTimer slice;
+    slice.start();
+    NetworkEvent event;
+    while (events.pop(event)) {
+        dispatch(event);
+        if (slice.elapsed() >= DrainSliceMs) {
+            // El resto sigue después de que el bucle de eventos atienda la entrada
+            scheduleDrain();
+            return;
+        }
+    }
+}
+
+void WebSocketClient::dispatch(const NetworkEvent& event) {
+    switch (event.type) {
+    case NetworkEvent::Connected:
+        online = true;
+        emit connected();
+        break;
+    case NetworkEvent::Disconnected:
+        if (online) {
+            online = false;
+            emit disconnected();
+        }
+        break;
+    case NetworkEvent::Reconnecting:
+        // Las páginas de historial en camino se perdieron con la conexión
+        online = false;
+        history.clear();
+        emit reconnecting(event.attempt, event.retryMs);
+        break;
+    case NetworkEvent::Resumed:
+        online = true;
+        emit resumed();
+        break;
+    case NetworkEvent::Message:
+        emit messageReceivedWithFlag(event.name, event.text, false);
+        break;
+    case NetworkEvent::Notice:
+        emit messageReceived("~", event.text);
+        break;
+    case NetworkEvent::UserList:
+        emit userListReceived(event.users);
+        break;
+    case NetworkEvent::UserStatus:
+        emit userStatusReceived(event.status);
+        break;
+    case NetworkEvent::UserConnected:
+        emit userConnected(event.name);
+        break;
+    case NetworkEvent::StatusChanged:
+        emit userStatusChanged(event.name, event.status);
+        break;
+    case NetworkEvent::History: {
+        HistoryPager::Request answered;
+        const bool paged = history.complete(event.hasCursor, event.nextCursor, answered);
+        if (paged && !history.isCurrent(answered)) {
+            // Se cambió de chat o se volvió a pedir la primera página antes de
+            // que llegara esta: ya no corresponde a lo que se muestra
+            qCDebug(lcProtocol) << "WebSocketClient: página de historial vieja de" << answered.chat << "descartada";
+            break;
+        }
+        if (paged && answered.older) {
+            // Página anterior: se inserta arriba de lo ya mostrado
+            emit olderHistoryReceived(answered.chat, event.entries, history.hasMore());
+        } else {
+            // Página más reciente: se entrega como un solo lote para que la
+            // UI la concilie con el registro local antes de dibujar
+            emit historyReceived(paged ? answered.chat : history.chat(), event.entries, history.hasMore());
+        }
+        break;
+    }
+    case NetworkEvent::Error:
+        handleError(event.status);
+        break;
+    }
+}
+
+void WebSocketClient::handleError(quint8 errorCode) {
+    QString errorMessage;
+    switch (errorCode) {
+    case 1: // Cambiado de 0x01 a 1
+        errorMessage = "El usuario ya está conectado. Por favor, elige otro nombre.";
+        emit connectionRejected();
+        break;
+    case 2: // Cambiado de 0x02 a 2
+        errorMessage = "Estado inválido.";
+        break;
+    case 3: // Cambiado de 0x03 a 3
+        errorMessage = "Mensaje vacío.";
+        break;
+    case 4: // Cambiado de 0x04 a 4
+        errorMessage = "El destinatario está desconectado.";
+        break;
+    default:
+        errorMessage = "Error desconocido.";
+    }
+
+    qCWarning(lcProtocol) << "❌ Error recibido: " << errorMessage;
+}
+
+void WebSocketClient::sendMessage(const QString& recipient, const QString& message) {
+    qCDebug(lcProtocol) << "sendMessage: Enviando a" << recipient << "- Mensaje:" << message.left(30);
+
+    if (recipient.isEmpty()) {
+        qCWarning(lcProtocol) << "Error en WebSocketClient::sendMessage: destinatario vacío";
+        return;
+    }
+
+    if (message.isEmpty()) {
+        qCWarning(lcProtocol) << "Error en WebSocketClient::sendMessage: mensaje vacío";
+        return;
+    }
+
+    if (!online) {
+        qCWarning(lcProtocol) << "Error en WebSocketClient::sendMessage: socket no conectado";
+        return;
+    }
+
+    QMetaObject::invokeMethod(worker, [worker = worker, recipient, message] {
+        worker->sendMessage(recipient, message);
+    }, Qt::QueuedConnection);
+}
+
+void WebSocketClient::getChatHistory(const QString& chatName) {
+    if (!online)
+        return;
+
+    // Primera página (la más reciente); las anteriores se piden con
+    // loadOlderHistory() a medida que el usuario sube en el chat.
+    const HistoryPager::Request request = history.newest(chatName);
+    QMetaObject::invokeMethod(worker, [worker = worker, request] {
+        worker->getHistoryPage(request.chat, request.cursor, request.limit);
+    }, Qt::QueuedConnection);
+}
+
+bool WebSocketClient::loadOlderHistory() {
+    if (!online)
+        return false;
+
+    HistoryPager::Request request;
+    if (!history.older(request))
+        return false;
+
+    qCDebug(lcProtocol) << "WebSocketClient: solicitando página anterior de" << request.chat
+             << "- cursor" << request.cursor << "- tamaño" << request.limit;
+    QMetaObject::invokeMethod(worker, [worker = worker, request] {
+        worker->getHistoryPage(request.chat, request.cursor, request.limit);
+    }, Qt::QueuedConnection);
+    return true;
+}
+
+void WebSocketClient::changeUserStatus(quint8 newStatus) {
+    if (!online)
+        return;
+
+    QMetaObject::invokeMethod(worker, [worker = worker, newStatus] {
+        worker->changeStatus(newStatus);
+    }, Qt::QueuedConnection);
+    emit statusChanged(newStatus);
+}
+
+WebSocketClient::CompressionStats WebSocketClient::compressionStats() const {
+    return worker->compressionStats();
+}
+
+bool WebSocketClient::isConnected() const {
+    return online;
+}
+
+void WebSocketClient::onDisconnected() {
+    // El cierre lo hace el hilo de red; el evento Disconnected llega después
+    QMetaObject::invokeMethod(worker, &NetworkWorker::close, Qt::QueuedConnection);
+}
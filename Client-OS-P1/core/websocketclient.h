@@ -0,0 +1,80 @@
+#ifndef WEBSOCKETCLIENT_H
+#define WEBSOCKETCLIENT_H
+#pragma once
+
+#include <QObject>
+#include <QThread>
+
+#include <atomic>
+
+#include "historypager.h"
+#include "latencytracker.h"
+#include "networkworker.h"
+
+// Cliente del servidor de chat, del lado de la interfaz.
+//
+// El socket y la decodificación de frames corren en un hilo de red propio
+// (NetworkWorker); los comandos se le pasan como llamadas encoladas y los
+// eventos vuelven por una SpscQueue. La interfaz los vacía por tandas de
+// como mucho DrainSliceMs, así una ráfaga de mensajes no retrasa la entrada
+// del usuario y un repintado lento no retrasa la lectura del socket.
+class WebSocketClient : public QObject {
+    Q_OBJECT
+public:
+    using CompressionStats = NetworkWorker::CompressionStats;
+
+    static constexpr qint64 DrainSliceMs = 4;
+
+    explicit WebSocketClient(const QUrl& url, const QString& username, QObject* parent = nullptr);
+    ~WebSocketClient();
+
+    void sendMessage(const QString& recipient, const QString& message);
+    void getChatHistory(const QString& chatName);
+    // Pide la página anterior del chat actual; false si no hay más o ya hay una en camino
+    bool loadOlderHistory();
+    void changeUserStatus(quint8 newStatus);
+    bool isConnected() const;
+    CompressionStats compressionStats() const;
+    // Ida y vuelta de envíos, historial y lista de usuarios; se puede leer en cualquier momento
+    LatencyTracker& latency() { return roundTrips; }
+    void onDisconnected();
+
+signals:
+    void messageReceived(const QString& sender, const QString& message);
+    // NUEVA SEÑAL que incluye la bandera isHistory
+    void messageReceivedWithFlag(const QString& sender, const QString& message, bool isHistory);
+    void userListReceived(const QStringList& users);
+    void userStatusReceived(quint8 status);
+    void connected();
+    // Desconexión definitiva (pedida o sin haber llegado a conectar)
+    void disconnected();
+    // Se cayó la conexión; el hilo de red reintenta en `delayMs`
+    void reconnecting(int attempt, qint64 delayMs);
+    // Reconectado: el estado de la sesión se conserva y solo llegan deltas
+    void resumed();
+    void statusChanged(quint8 newStatus);
+    void connectionRejected();
+    void userStatusChanged(const QString& username, quint8 newStatus); //signal for status
+    void userConnected(const QString& username);
+    // Página más reciente del historial de un chat
+    void historyReceived(const QString& chatName, const QList<HistoryEntry>& entries, bool hasMore);
+    // Página anterior del historial (más antigua que lo ya mostrado)
+    void olderHistoryReceived(const QString& chatName, const QList<HistoryEntry>& entries, bool hasMore);
+
+private:
+    void scheduleDrain();
+    void drainEvents();
+    void dispatch(const NetworkEvent& event);
+    void handleError(quint8 errorCode);
+
+    QString username;
+    NetworkWorker::Queue events;
+    LatencyTracker roundTrips;
+    std::atomic<bool> drainScheduled{false};
+    QThread networkThread;
+    NetworkWorker* worker;
+    HistoryPager history;
+    bool online = false;
+};
+
+#endif // WEBSOCKETCLIENT_H
@@ -0,0 +1,114 @@
+#ifndef DIAGNOSTICSDOCK_H
+#define DIAGNOSTICSDOCK_H
+
+#include <QDockWidget>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QPushButton>
+#include <QTableWidget>
+#include <QVBoxLayout>
+
+#include "latencytracker.h"
+
+// Panel de diagnóstico con los percentiles de ida y vuelta de cada acción
+// medida por LatencyTracker, comparados con su objetivo de p99.
+class DiagnosticsDock : public QDockWidget
+{
+    Q_OBJECT
+
+public:
+    explicit DiagnosticsDock(QWidget *parent = nullptr)
+        : QDockWidget("Latencia", parent)
+    {
+        setObjectName("diagnosticsDock");
+
+        QWidget *content = new QWidget(this);
+        m_table = new QTableWidget(LatencyTracker::ActionCount, ColumnCount, content);
+        m_table->setHorizontalHeaderLabels({"Acción", "Muestras", "p50", "p90", "p99", "p99.9", "Máx", "Objetivo p99"});
+        m_table->verticalHeader()->hide();
+        m_table->horizontalHeader()->setSectionResizeMode(QHeaderView::ResizeToContents);
+        m_table->horizontalHeader()->setStretchLastSection(true);
+        m_table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+        m_table->setSelectionMode(QAbstractItemView::NoSelection);
+        m_table->setStyleSheet("QTableWidget { border: none; background-color: #ffffff; }");
+        for (int row = 0; row < LatencyTracker::ActionCount; ++row) {
+            const auto action = LatencyTracker::Action(row);
+            m_table->setItem(row, 0, new QTableWidgetItem(LatencyTracker::actionName(action)));
+            for (int column = 1; column < ColumnCount; ++column) {
+                auto *item = new QTableWidgetItem;
+                item->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+                m_table->setItem(row, column, item);
+            }
+        }
+
+        QLabel *note = new QLabel("Medido en el hilo de red: incluye red y servidor, no el dibujado.", content);
+        note->setStyleSheet("QLabel { color: #666666; }");
+
+        QPushButton *resetButton = new QPushButton("Reiniciar", content);
+        connect(resetButton, &QPushButton::clicked, this, [this] {
+            if (m_tracker)
+                m_tracker->reset();
+            refresh();
+        });
+
+        QHBoxLayout *footer = new QHBoxLayout;
+        footer->addWidget(note, 1);
+        footer->addWidget(resetButton);
+
+        QVBoxLayout *layout = new QVBoxLayout(content);
+        layout->setContentsMargins(8, 8, 8, 8);
+        layout->addWidget(m_table);
+        layout->addLayout(footer);
+        setWidget(content);
+
+        refresh();
+    }
+
+    // nullptr al desconectarse; el tracker pertenece al WebSocketClient.
+    void setTracker(LatencyTracker *tracker)
+    {
+        m_tracker = tracker;
+        refresh();
+    }
+
+    void refresh()
+    {
+        for (int row = 0; row < LatencyTracker::ActionCount; ++row) {
+            const auto action = LatencyTracker::Action(row);
+            const LatencyHistogram histogram = m_tracker ? m_tracker->histogram(action) : LatencyHistogram();
+            const bool empty = histogram.count() == 0;
+            auto text = [&](double percent) {
+                return empty ? QString("—") : LatencyHistogram::format(histogram.percentile(percent));
+            };
+
+            m_table->item(row, 1)->setText(QString::number(histogram.count()));
+            m_table->item(row, 2)->setText(text(50.0));
+            m_table->item(row, 3)->setText(text(90.0));
+            m_table->item(row, 4)->setText(text(99.0));
+            m_table->item(row, 5)->setText(text(99.9));
+            m_table->item(row, 6)->setText(empty ? QString("—") : LatencyHistogram::format(histogram.max()));
+
+            const qint64 slo = LatencyTracker::sloNanos(action);
+            QTableWidgetItem *target = m_table->item(row, 7);
+            if (empty) {
+                target->setText("≤ " + LatencyHistogram::format(slo));
+                target->setForeground(QColor("#666666"));
+            } else if (histogram.percentile(99.0) <= slo) {
+                target->setText("✓ ≤ " + LatencyHistogram::format(slo));
+                target->setForeground(QColor("#2e7d32"));
+            } else {
+                target->setText("✗ > " + LatencyHistogram::format(slo));
+                target->setForeground(QColor("#c62828"));
+            }
+        }
+    }
+
+private:
+    static constexpr int ColumnCount = 8;
+
+    QTableWidget *m_table;
+    LatencyTracker *m_tracker = nullptr;
+};
+
+#endif // DIAGNOSTICSDOCK_H
@@ -1,8 +1,10 @@
 #include "mainwindow.h"
+#include "logging.h"
 #include <QApplication>
 
 int main(int argc, char *argv[])
 {
+    Logging::install();
     QApplication app(argc, argv);
     
     app.setApplicationName("Chat Application");
@@ -1,10 +1,15 @@
 #include "mainwindow.h"
 #include "ui_mainwindow.h"
+#include "logging.h"
+#include "metrics.h"
 #include <QNetworkRequest>
 #include <QNetworkInterface>
 #include <QDebug>
 #include <QUrlQuery>
 #include <QDateTime>
+#include <QFileDialog>
+#include <QElapsedTimer>
+#include <QStandardPaths>
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
@@ -17,8 +22,25 @@ MainWindow::MainWindow(QWidget *parent)
     , m_inactivityTimer(new QTimer(this))
     , m_networkManager(new QNetworkAccessManager(this))
     , m_requestedHistoryChat("~") // Inicializar con valor predeterminado
+    , m_olderOverlap(0)
+    , m_messageModel(new MessageListModel(&m_session.store(), this))
+    , m_renderTimer(new QTimer(this))
+    , m_batchRendered(false)
+    , m_avatars(new AvatarCache(this))
+    , m_rosterModel(new RosterModel(this))
+    , m_rosterProxy(new RosterProxyModel(this))
+    , m_searchDebounce(new QTimer(this))
+    , m_diagnostics(new DiagnosticsDock(this))
+    , m_latencyLabel(new QLabel(this))
+    , m_latencyTimer(new QTimer(this))
+    , m_metrics(new MetricsDock(this))
 {
     ui->setupUi(this);
+    ui->messageDisplay->setModel(m_messageModel);
+    ui->messageDisplay->setItemDelegate(new MessageDelegate(ui->messageDisplay));
+    m_rosterProxy->setSourceModel(m_rosterModel);
+    ui->userListView->setModel(m_rosterProxy);
+    ui->userListView->setItemDelegate(new RosterDelegate(m_avatars, ui->userListView));
     ui->userAvatar->setCursor(Qt::PointingHandCursor);
     ui->userAvatar->installEventFilter(this);
     
@@ -34,33 +56,74 @@ MainWindow::MainWindow(QWidget *parent)
     connect(ui->actionExit, &QAction::triggered, this, &QApplication::quit);
     connect(ui->actionAbout, &QAction::triggered, this, &MainWindow::onAboutTriggered);
     connect(ui->actionHelp, &QAction::triggered, this, &MainWindow::onHelpTriggered);
+    connect(ui->actionSaveLog, &QAction::triggered, this, &MainWindow::onSaveLogTriggered);
 
     connect(ui->sendButton, &QPushButton::clicked, this, &MainWindow::onSendButtonClicked);
     connect(ui->messageInput, &QTextEdit::textChanged, this, &MainWindow::onMessageInputChanged);
 
-    connect(ui->userListWidget, &QListWidget::itemClicked, this, &MainWindow::onUserItemClicked);
+    connect(ui->userListView, &QListView::clicked, this, &MainWindow::onUserItemClicked);
     connect(ui->broadcastListWidget, &QListWidget::itemClicked, this, &MainWindow::onBroadcastItemClicked);
     connect(ui->searchUsers, &QLineEdit::textChanged, this, &MainWindow::onSearchTextChanged);
-    
-    // Conexión para limpiar mensajes solicitada por el WebSocketClient
-    connect(m_webSocketClient, &WebSocketClient::clearMessages, this, [=]() {
-        ui->messageDisplay->clear();
-        qDebug() << "MainWindow: Mensajes limpiados por solicitud del WebSocketClient";
-    });
 
+    // El filtro se aplica cuando se deja de escribir, no en cada tecla
+    m_searchDebounce->setSingleShot(true);
+    m_searchDebounce->setInterval(SearchDebounceMs);
+    connect(m_searchDebounce, &QTimer::timeout, this, &MainWindow::applySearchQuery);
+
+    // Los lotes grandes de mensajes se agregan a la vista en tramos cortos
+    m_renderTimer->setSingleShot(true);
+    m_renderTimer->setInterval(0);
+    connect(m_renderTimer, &QTimer::timeout, this, &MainWindow::renderPendingMessages);
+
+    // Al llegar arriba del chat se pide la página anterior del historial
+    connect(ui->messageDisplay->verticalScrollBar(), &QScrollBar::valueChanged,
+            this, &MainWindow::onMessageDisplayScrolled);
+    
     connect(ui->statusComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged),
             this, &MainWindow::onStatusChanged);
 
     connect(ui->infoButton, &QPushButton::clicked, this, &MainWindow::onInfoButtonClicked);
     connect(ui->closeInfoButton, &QPushButton::clicked, this, &MainWindow::onCloseInfoButtonClicked);
     connect(ui->refreshInfoButton, &QPushButton::clicked, this, &MainWindow::onRefreshInfoButtonClicked);
-    connect(m_webSocketClient, &WebSocketClient::userStatusChanged,
-            this, &MainWindow::onExternalUserStatusChanged);
 
     // Create a shortcut for sending messages with Enter
     QShortcut *sendShortcut = new QShortcut(QKeySequence(Qt::Key_Return), this);
     connect(sendShortcut, &QShortcut::activated, this, &MainWindow::onSendButtonClicked);
 
+    // Ctrl+K: saltar a cualquier conversación escribiendo parte del nombre
+    QShortcut *switcherShortcut = new QShortcut(QKeySequence(Qt::CTRL | Qt::Key_K), this);
+    connect(switcherShortcut, &QShortcut::activated, this, &MainWindow::openQuickSwitcher);
+
+    // Ctrl+F: buscar en el texto de todos los mensajes
+    QShortcut *searchShortcut = new QShortcut(QKeySequence::Find, this);
+    connect(searchShortcut, &QShortcut::activated, this, &MainWindow::openMessageSearch);
+
+    // Ctrl+Shift+L: panel de latencia, también desde el menú Help
+    addDockWidget(Qt::RightDockWidgetArea, m_diagnostics);
+    m_diagnostics->hide();
+    QAction *diagnosticsAction = m_diagnostics->toggleViewAction();
+    diagnosticsAction->setText("Latency Diagnostics");
+    diagnosticsAction->setShortcut(QKeySequence(Qt::CTRL | Qt::SHIFT | Qt::Key_L));
+    ui->menuHelp->insertAction(ui->actionSaveLog, diagnosticsAction);
+
+    // Ctrl+Shift+M: métricas del cliente, con exportación a JSON
+    addDockWidget(Qt::RightDockWidgetArea, m_metrics);
+    m_metrics->hide();
+    m_metrics->setSampler([this] { sampleMetrics(); });
+    QAction *metricsAction = m_metrics->toggleViewAction();
+    metricsAction->setText("Client Metrics");
+    metricsAction->setShortcut(QKeySequence(Qt::CTRL | Qt::SHIFT | Qt::Key_M));
+    ui->menuHelp->insertAction(ui->actionSaveLog, metricsAction);
+
+    m_latencyLabel->setStyleSheet("QLabel { color: #ffffff; padding: 0 6px; }");
+    ui->statusbar->addPermanentWidget(m_latencyLabel);
+    m_latencyTimer->setInterval(LatencyRefreshMs);
+    connect(m_latencyTimer, &QTimer::timeout, this, &MainWindow::updateLatencyDisplay);
+
+    // Avatares con imagen: <usuario>.png/.jpg en el directorio de datos
+    m_avatars->setImageDirectory(QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation) + "/avatars");
+    connect(m_avatars, &AvatarCache::avatarChanged, this, &MainWindow::onAvatarChanged);
+
     // Set up the inactivity timer
     connect(m_inactivityTimer, &QTimer::timeout, this, &MainWindow::onInactivityTimeout);
     m_inactivityTimer->setInterval(300000); // 5 minutes por defecto
@@ -90,6 +153,7 @@ void MainWindow::setupInitialUI()
     generalChatItem->setSizeHint(QSize(0, 70));
 
     UserChatItem *generalChat = new UserChatItem("General Chat", "ACTIVO", "Broadcast messages to all users");
+    generalChat->setAvatar(m_avatars->avatar("General Chat", RosterDelegate::AvatarSize));
     ui->broadcastListWidget->setItemWidget(generalChatItem, generalChat);
 
     // Initialize message input
@@ -97,7 +161,7 @@ void MainWindow::setupInitialUI()
     ui->sendButton->setEnabled(false);
 
     // Set placeholder text
-    ui->messageDisplay->setPlaceholderText("Connect to a server to start chatting");
+    addSystemMessage("Connect to a server to start chatting");
 
     // Hide user info sidebar
     ui->userInfoSidebar->hide();
@@ -123,59 +187,126 @@ void MainWindow::onConnectTriggered()
     m_currentUsername = dialog.username();
     QString host = dialog.server();
     int port = dialog.port();
+    m_serverHost = QString("%1:%2").arg(host).arg(port);
 
     if (m_currentUsername.trimmed().isEmpty()) {
         QMessageBox::warning(this, "Input Error", "Username cannot be empty.");
         return;
     }
 
-    // Paso 1: Validación HTTP previa
-    ui->statusbar->showMessage("Verificando usuario...");
+    // Un intento anterior que nunca llegó a conectar se descarta
+    abortConnection();
+
+    // Desde aquí hasta poder escribir: time-to-interactive
+    m_connectClock.start();
+
+    // Registro local de mensajes de este usuario en este servidor. Se abre ya
+    // porque pueden llegar mensajes antes de que termine la verificación.
+    m_session.start(m_serverHost, m_currentUsername);
+
+    // El WebSocket se abre en paralelo con la verificación HTTP en lugar de
+    // esperarla; la interfaz se habilita cuando ConnectGate da las dos por
+    // resueltas. Con una verificación reciente en caché no se repite la
+    // consulta HTTP.
+    const bool cached = m_validations.isValid(m_serverHost, m_currentUsername);
+    m_gate.start(cached);
+    ui->statusbar->showMessage("Conectando a WebSocket...");
+
+    QUrl wsUrl(QString("ws://%1:%2/?name=%3").arg(host).arg(port).arg(m_currentUsername));
+
+    // Crear cliente WebSocket
+    m_webSocketClient = new WebSocketClient(wsUrl, m_currentUsername, this);
+
+    connect(m_webSocketClient, &WebSocketClient::connected, this, &MainWindow::onWebSocketConnected);
+    connect(m_webSocketClient, &WebSocketClient::disconnected, this, &MainWindow::onWebSocketDisconnected);
+    connect(m_webSocketClient, &WebSocketClient::reconnecting, this, &MainWindow::onWebSocketReconnecting);
+    connect(m_webSocketClient, &WebSocketClient::resumed, this, &MainWindow::onWebSocketResumed);
+    connect(m_webSocketClient, &WebSocketClient::messageReceived, this, &MainWindow::onMessageReceived);
+    connect(m_webSocketClient, &WebSocketClient::messageReceivedWithFlag, this, &MainWindow::onMessageReceivedWithFlag);
+    connect(m_webSocketClient, &WebSocketClient::userListReceived, this, &MainWindow::onUserListReceived);
+    connect(m_webSocketClient, &WebSocketClient::userStatusReceived, this, &MainWindow::onUserStatusReceived);
+    connect(m_webSocketClient, &WebSocketClient::userStatusChanged, this, &MainWindow::onExternalUserStatusChanged);
+    connect(m_webSocketClient, &WebSocketClient::userConnected, this, &MainWindow::onUserConnected);
+    connect(m_webSocketClient, &WebSocketClient::historyReceived, this, &MainWindow::onHistoryReceived);
+    connect(m_webSocketClient, &WebSocketClient::olderHistoryReceived, this, &MainWindow::onOlderHistoryReceived);
+    connect(m_webSocketClient, &WebSocketClient::connectionRejected, this, [=]() {
+        QMessageBox::warning(this, "Conexión rechazada", "El nombre de usuario ya está en uso.");
+        m_validations.forget(m_serverHost, m_currentUsername);
+        if (m_connected) {
+            abortConnection();
+            onDisconnectTriggered();
+        } else {
+            abortConnection();
+            ui->statusbar->showMessage("Error: nombre ya en uso.");
+        }
+    });
+
+    if (cached) {
+        qCInfo(lcProtocol) << "Verificación HTTP en caché para usuario:" << m_currentUsername;
+        return;
+    }
+
+    // Paso 1: Validación HTTP previa, en paralelo con el WebSocket
     QUrl httpUrl(QString("http://%1:%2/?name=%3").arg(host).arg(port).arg(m_currentUsername));
     QNetworkRequest request(httpUrl);
 
     QNetworkReply* reply = m_networkManager->get(request);
+    WebSocketClient *client = m_webSocketClient;
 
     connect(reply, &QNetworkReply::finished, this, [=]() {
         int code = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
         reply->deleteLater();
 
-        if (code == 400) {
-            QMessageBox::warning(this, "Usuario no válido", "El nombre ya está en uso o es inválido.");
-            ui->statusbar->showMessage("Error: nombre ya en uso.");
-        }
-        else if (code >= 200 && code < 300) {
-            qDebug() << "✅ Verificación HTTP aceptada (código" << code << ") para usuario:" << m_currentUsername;
-            addSystemMessage("✅ Usuario verificado correctamente. Conectando WebSocket...");
-
-            ui->statusbar->showMessage("Conectando a WebSocket...");
-
-            QUrl wsUrl(QString("ws://%1:%2/?name=%3").arg(host).arg(port).arg(m_currentUsername));
-
-            // Crear cliente WebSocket
-            m_webSocketClient = new WebSocketClient(wsUrl, m_currentUsername, this);
-
-            connect(m_webSocketClient, &WebSocketClient::connected, this, &MainWindow::onWebSocketConnected);
-            connect(m_webSocketClient, &WebSocketClient::disconnected, this, &MainWindow::onWebSocketDisconnected);
-            connect(m_webSocketClient, &WebSocketClient::messageReceived, this, &MainWindow::onMessageReceived);
-            connect(m_webSocketClient, &WebSocketClient::messageReceivedWithFlag, this, &MainWindow::onMessageReceivedWithFlag);
-            connect(m_webSocketClient, &WebSocketClient::userListReceived, this, &MainWindow::onUserListReceived);
-            connect(m_webSocketClient, &WebSocketClient::userStatusReceived, this, &MainWindow::onUserStatusReceived);
-            connect(m_webSocketClient, &WebSocketClient::connectionRejected, this, [=]() {
-                QMessageBox::warning(this, "Conexión rechazada", "El nombre de usuario ya está en uso.");
-                m_webSocketClient->deleteLater();
-                m_webSocketClient = nullptr;
-                onDisconnectTriggered();
-            });
+        // La conexión se canceló (o se reemplazó) mientras se verificaba
+        if (client != m_webSocketClient)
+            return;
+
+        static Metrics::Timer &nameCheckTime = Metrics::timer("connect.nameCheck");
+        nameCheckTime.record(m_connectClock.nsecsElapsed());
 
+        if (code >= 200 && code < 300) {
+            qCInfo(lcProtocol) << "✅ Verificación HTTP aceptada (código" << code << ") para usuario:" << m_currentUsername;
+            m_validations.remember(m_serverHost, m_currentUsername);
+        } else if (code == 400) {
+            // Puede ser nuestro propio WebSocket, ya registrado: decide el servidor
+            qCInfo(lcProtocol) << "Verificación HTTP con 400; se espera la respuesta del WebSocket";
         }
-        else {
+
+        switch (m_gate.nameChecked(code)) {
+        case ConnectGate::Ready:
+            onConnectionReady();
+            break;
+        case ConnectGate::Rejected:
+            rejectName();
+            break;
+        case ConnectGate::Failed:
+            abortConnection();
             QMessageBox::critical(this, "Error HTTP", "Código: " + QString::number(code));
             ui->statusbar->showMessage("Error HTTP: " + QString::number(code));
+            break;
+        case ConnectGate::Waiting:
+            break;
         }
     });
 }
 
+void MainWindow::rejectName()
+{
+    abortConnection();
+    QMessageBox::warning(this, "Usuario no válido", "El nombre ya está en uso o es inválido.");
+    ui->statusbar->showMessage("Error: nombre ya en uso.");
+}
+
+void MainWindow::abortConnection()
+{
+    // Cierra un cliente que todavía no llegó a habilitar la interfaz
+    if (!m_webSocketClient)
+        return;
+    m_diagnostics->setTracker(nullptr);
+    m_webSocketClient->deleteLater();
+    m_webSocketClient = nullptr;
+}
+
 void MainWindow::onDisconnectTriggered()
 {
     if (!m_connected) {
@@ -187,9 +318,12 @@ void MainWindow::onDisconnectTriggered()
     // Close the WebSocket connection
     if (m_webSocketClient) {
         m_webSocketClient->onDisconnected();
+        m_diagnostics->setTracker(nullptr);
         m_webSocketClient->deleteLater();
         m_webSocketClient = nullptr;
     }
+    m_latencyTimer->stop();
+    m_latencyLabel->clear();
 
     // Update UI for disconnected state
     m_connected = false;
@@ -199,10 +333,10 @@ void MainWindow::onDisconnectTriggered()
     ui->sendButton->setEnabled(false);
 
     // Clear user lists
-    ui->userListWidget->clear();
+    m_rosterModel->clear();
 
     // Clear chat area
-    ui->messageDisplay->clear();
+    m_messageModel->clear();
     ui->chatTitle->setText("Select a chat");
     ui->chatStatus->clear();
 
@@ -221,7 +355,24 @@ void MainWindow::onDisconnectTriggered()
 
 void MainWindow::onWebSocketConnected()
 {
-    qDebug() << "WebSocket conectado con éxito";
+    if (m_connected)
+        return;
+
+    // El WebSocket se abrió antes de que termine la verificación HTTP: la
+    // interfaz se habilita cuando llegue (ver onConnectTriggered)
+    if (m_gate.socketConnected() != ConnectGate::Ready) {
+        ui->statusbar->showMessage("Verificando usuario...");
+        return;
+    }
+    onConnectionReady();
+}
+
+void MainWindow::onConnectionReady()
+{
+    if (m_connected)
+        return;
+
+    qCInfo(lcProtocol) << "WebSocket conectado con éxito";
     
     m_connected = true;
 
@@ -239,12 +390,13 @@ void MainWindow::onWebSocketConnected()
     ui->statusComboBox->setCurrentIndex(0); // ACTIVO
     m_currentStatus = "ACTIVO";
 
-    // Update status bar
-    ui->statusbar->showMessage("Connected to server");
-
     // Start inactivity timer
     m_inactivityTimer->start();
 
+    m_diagnostics->setTracker(&m_webSocketClient->latency());
+    m_latencyTimer->start();
+    updateLatencyDisplay();
+
     // Set the current chat to general chat
     m_currentChat = "~";
 
@@ -252,7 +404,7 @@ void MainWindow::onWebSocketConnected()
     ui->chatTabs->setCurrentIndex(1); // Broadcast tab
     
     // Clear the message display first
-    ui->messageDisplay->clear();
+    m_messageModel->setConversation(m_currentChat, m_currentUsername);
     
     // Show the general broadcast chat
     if (ui->broadcastListWidget->count() > 0) {
@@ -265,97 +417,84 @@ void MainWindow::onWebSocketConnected()
     if (ui->userInfoSidebar->isVisible()) {
         showCurrentUserInfo();
     }
+
+    // Time-to-interactive: desde aceptar el diálogo hasta poder escribir
+    static Metrics::Timer &interactiveTime = Metrics::timer("connect.timeToInteractive");
+    const qint64 elapsed = m_connectClock.nsecsElapsed();
+    interactiveTime.record(elapsed);
+    qCInfo(lcProtocol) << "Conexión lista en" << LatencyHistogram::format(elapsed);
+    ui->statusbar->showMessage("Connected to server (" + LatencyHistogram::format(elapsed) + ")");
 }
 
 void MainWindow::onWebSocketDisconnected()
 {
-    // Already handled in onDisconnectTriggered
+    // Desconexión definitiva; las caídas de red se reintentan solas
+    // (onWebSocketReconnecting). Already handled in onDisconnectTriggered
     if (m_connected) {
         onDisconnectTriggered();
     }
 }
 
-// NUEVO MÉTODO: Procesa el mensaje con bandera que indica si es historial o no
+void MainWindow::onWebSocketReconnecting(int attempt, qint64 delayMs)
+{
+    // El servidor cerró la sesión antes de confirmarla tras un 400: el
+    // nombre era de otro
+    if (!m_connected && m_webSocketClient && m_gate.socketLost() == ConnectGate::Rejected) {
+        rejectName();
+        return;
+    }
+
+    // El roster, el chat abierto y la posición en la conversación se
+    // conservan; solo se bloquea el envío hasta volver. El aviso va en la
+    // barra de estado y no en el chat, para no mover la vista.
+    ui->messageInput->setEnabled(false);
+    ui->sendButton->setEnabled(false);
+    ui->statusbar->showMessage(QString("Conexión perdida. Reintento %1 en %2 s...")
+                                   .arg(attempt)
+                                   .arg(delayMs / 1000.0, 0, 'f', 1));
+}
+
+void MainWindow::onWebSocketResumed()
+{
+    qCInfo(lcProtocol) << "WebSocket reconectado";
+
+    ui->messageInput->setEnabled(true);
+    ui->sendButton->setEnabled(true);
+    ui->statusbar->showMessage("Reconectado al servidor", 3000);
+
+    // Solo la página más reciente del chat abierto: se concilia con lo que
+    // ya está en memoria y se agrega lo que llegó durante el corte
+    getChatHistory(m_currentChat);
+}
+
+// Mensaje entrante: ChatSession decide si es un aviso, un duplicado o se
+// guarda en la conversación del remitente; solo se dibuja si está abierta.
 void MainWindow::onMessageReceivedWithFlag(const QString &sender, const QString &message, bool isHistory)
 {
-    qDebug() << "DEBUG - onMessageReceivedWithFlag: Emisor=" << sender 
-             << "Mensaje=" << message.left(30) 
-             << "Es Historial=" << isHistory;
+    qCDebug(lcRender) << "mensaje de" << sender << "- historial:" << isHistory << "-" << message.left(30);
     
     // Restablecer el temporizador de inactividad
     if (m_inactivityTimer->isActive()) {
         m_inactivityTimer->start();
     }
 
-    // CASO 1: Mensaje del sistema (desde ~)
-    if (sender == "~") {
-        qDebug() << "DEBUG - Tipo identificado: MENSAJE DEL SISTEMA";
+    // Las reglas de enrutamiento viven en ChatSession
+    switch (m_session.receive(sender, message, isHistory)) {
+    case ChatSession::Notice:
         addSystemMessage(message);
         return;
+    case ChatSession::Ignored:
+        qCDebug(lcRender) << "Ignorando mensaje, ya está en la conversación";
+        return;
+    case ChatSession::Stored:
+        // Sube al remitente en la lista Direct
+        updateUserLastMessage(sender, message);
+        break;
     }
-    
-    // CASO 2: Es un mensaje que YO he enviado
-    else if (sender == m_currentUsername) {
-        qDebug() << "DEBUG - Tipo identificado: MENSAJE ENVIADO POR MÍ";
-        
-        // Si es un mensaje del historial
-        if (isHistory) {
-            qDebug() << "DEBUG - Procesando mensaje propio del historial";
-            qDebug() << "DEBUG - Chat actual:" << m_currentChat 
-                     << "- Chat solicitado:" << m_requestedHistoryChat;
-            
-            // Para historial de chat general
-            if (m_requestedHistoryChat == "~" && m_currentChat == "~") {
-                addChatMessage("Tú", message, MessageBubble::Sent);
-                return;
-            }
-            
-            // Para historial de chat directo: mostramos nuestros mensajes del historial
-            // solo cuando estamos en el chat correcto
-            if (m_requestedHistoryChat != "~" && m_currentChat == m_requestedHistoryChat) {
-                addChatMessage("Tú", message, MessageBubble::Sent);
-                return;
-            }
-            
-            // Si no corresponde al chat actual, se ignora
-            qDebug() << "DEBUG - Ignorando mensaje, no pertenece al chat actual";
-            return;
-        } 
-        else {
-            // No es mensaje del historial, se ignora para evitar duplicados
-            return;
-        }
-    }
-    
-    // CASO 3: Mensaje recibido de otro usuario
-    else {
-        qDebug() << "DEBUG - Tipo identificado: MENSAJE RECIBIDO DE OTRO";
-        
-        if (isHistory) {
-            // Para historial de chat general
-            if (m_requestedHistoryChat == "~" && m_currentChat == "~") {
-                addChatMessage(sender, message, MessageBubble::Received);
-                return;
-            }
-            
-            // Para historial de chat directo: mostramos solo si el remitente coincide con el chat solicitado
-            if (m_requestedHistoryChat != "~" && sender == m_requestedHistoryChat && 
-                m_currentChat == m_requestedHistoryChat) {
-                addChatMessage(sender, message, MessageBubble::Received);
-                return;
-            }
-            
-            // Si no coincide, se ignora
-            qDebug() << "DEBUG - Ignorando mensaje recibido, no pertenece al chat solicitado";
-            return;
-        }
-        // Mensaje normal (no historial)
-        else {
-            // Mostrar el mensaje solo si es un mensaje para el chat general o si estamos en el chat privado con este remitente
-            if ((sender == "~" && m_currentChat == "~") || m_currentChat == sender) {
-                addChatMessage(sender, message, MessageBubble::Received);
-            }
-        }
+
+    // Mostrar el mensaje solo si estamos en el chat privado con este remitente
+    if (m_currentChat == sender) {
+        showNewMessages();
     }
 }
 
@@ -378,11 +517,11 @@ void MainWindow::onSendButtonClicked()
         return;
     }
 
-    qDebug() << "DEBUG - onSendButtonClicked: Enviando mensaje a:" << m_currentChat << "- Mensaje:" << message;
+    qCDebug(lcProtocol) << "onSendButtonClicked: Enviando mensaje a:" << m_currentChat << "- Mensaje:" << message;
 
     // Validar el destinatario
     if (m_currentChat.isEmpty()) {
-        qDebug() << "Error: destinatario vacío";
+        qCWarning(lcProtocol) << "Error: destinatario vacío";
         QMessageBox::warning(this, "Error", "No se ha seleccionado un destinatario válido.");
         return;
     }
@@ -400,7 +539,9 @@ void MainWindow::onSendButtonClicked()
         m_webSocketClient->sendMessage(m_currentChat, message);
         
         // Mostrar mensaje localmente inmediatamente
-        addChatMessage("Tú", message, MessageBubble::Sent);
+        m_session.sent(m_currentChat, message);
+        updateUserLastMessage(m_currentChat, message);
+        showNewMessages();
 
         // Clear input field
         ui->messageInput->clear();
@@ -409,11 +550,11 @@ void MainWindow::onSendButtonClicked()
         QApplication::restoreOverrideCursor();
     } catch (const std::exception& e) {
         QApplication::restoreOverrideCursor();
-        qDebug() << "Excepción al enviar mensaje:" << e.what();
+        qCWarning(lcProtocol) << "Excepción al enviar mensaje:" << e.what();
         QMessageBox::critical(this, "Error", "Error al enviar mensaje: " + QString(e.what()));
     } catch (...) {
         QApplication::restoreOverrideCursor();
-        qDebug() << "Error desconocido al enviar mensaje";
+        qCWarning(lcProtocol) << "Error desconocido al enviar mensaje";
         QMessageBox::critical(this, "Error", "Error desconocido al enviar mensaje.");
     }
 }
@@ -426,54 +567,48 @@ void MainWindow::onMessageInputChanged()
     }
 }
 
-void MainWindow::onUserItemClicked(QListWidgetItem *item)
+void MainWindow::onUserItemClicked(const QModelIndex &index)
 {
-    if (!item) {
-        qDebug() << "Error: item nulo seleccionado";
+    if (!index.isValid()) {
+        qCWarning(lcRender) << "Error: item nulo seleccionado";
         return;
     }
 
-    // Get the username from the item
-    UserChatItem *chatItem = qobject_cast<UserChatItem*>(ui->userListWidget->itemWidget(item));
-    if (!chatItem) {
-        qDebug() << "Error: no se pudo obtener UserChatItem del item";
-        return;
-    }
-
-    QString username = chatItem->username();
+    // Get the username from the row
+    QString username = index.data(RosterModel::NameRole).toString();
     
-    qDebug() << "DEBUG - onUserItemClicked: Usuario seleccionado=" << username;
+    qCDebug(lcRender) << "onUserItemClicked: Usuario seleccionado=" << username;
     
     if (m_currentChat == username) {
-        qDebug() << "Ya estamos en el chat con" << username;
+        qCDebug(lcRender) << "Ya estamos en el chat con" << username;
         return;
     }
 
     if (username.contains("(")) {
         int startPos = username.indexOf("(");
         username = username.left(startPos).trimmed();
-        qDebug() << "DEBUG - Nombre de usuario extraído sin estado:" << username;
+        qCDebug(lcRender) << "Nombre de usuario extraído sin estado:" << username;
     }
 
     if (username.isEmpty()) {
-        qDebug() << "Error: nombre de usuario vacío";
+        qCWarning(lcRender) << "Error: nombre de usuario vacío";
         QMessageBox::warning(this, "Error", "No se pudo determinar el usuario seleccionado.");
         return;
     }
 
     if (m_currentChat == username) {
-        qDebug() << "Ya estamos en el chat con" << username;
+        qCDebug(lcRender) << "Ya estamos en el chat con" << username;
         return;
     }
 
-    ui->userListWidget->blockSignals(true);
+    ui->userListView->blockSignals(true);
     m_currentChat = username;
-    qDebug() << "DEBUG - Cambiando chat actual a: " << m_currentChat;
+    qCDebug(lcRender) << "Cambiando chat actual a: " << m_currentChat;
     ui->chatTitle->setText(username);
-    ui->chatStatus->setText(chatItem->status());
+    ui->chatStatus->setText(index.data(RosterModel::StatusRole).toString());
     
     // Limpiar el área de chat ANTES de solicitar historial
-    ui->messageDisplay->clear();
+    m_messageModel->setConversation(username, m_currentUsername);
     
     // Agregar mensaje de sistema indicando chat privado
     addSystemMessage("Chat privado con " + username);
@@ -482,10 +617,10 @@ void MainWindow::onUserItemClicked(QListWidgetItem *item)
     if (m_connected && m_webSocketClient) {
         getChatHistory(username);
     } else {
-        qDebug() << "Advertencia: No se puede obtener historial, no conectado";
+        qCWarning(lcRender) << "Advertencia: No se puede obtener historial, no conectado";
     }
     
-    ui->userListWidget->blockSignals(false);
+    ui->userListView->blockSignals(false);
     ui->messageInput->setEnabled(true);
     ui->sendButton->setEnabled(true);
     ui->messageInput->setFocus();
@@ -493,21 +628,21 @@ void MainWindow::onUserItemClicked(QListWidgetItem *item)
 
 void MainWindow::clearMessageDisplay()
 {
-    ui->messageDisplay->clear();
-    qDebug() << "MainWindow: Mensajes limpiados";
+    m_messageModel->clear();
+    qCDebug(lcRender) << "MainWindow: Mensajes limpiados";
 }
 
 void MainWindow::onBroadcastItemClicked(QListWidgetItem *item)
 {
     if (!item) return;
 
-    qDebug() << "Cambiando a chat general";
+    qCDebug(lcRender) << "Cambiando a chat general";
 
     ui->broadcastListWidget->blockSignals(true);
     m_currentChat = "~";
     ui->chatTitle->setText("General Chat");
     ui->chatStatus->clear();
-    ui->messageDisplay->clear();
+    m_messageModel->setConversation(m_currentChat, m_currentUsername);
     addSystemMessage("General Chat - Messages here are sent to all connected users");
     
     if (m_connected && m_webSocketClient) {
@@ -523,7 +658,7 @@ void MainWindow::onBroadcastItemClicked(QListWidgetItem *item)
 void MainWindow::onStatusChanged(int index)
 {
     if (!m_connected || !m_webSocketClient) {
-        qDebug() << "No se puede cambiar el estado: no conectado o cliente no inicializado";
+        qCWarning(lcPresence) << "No se puede cambiar el estado: no conectado o cliente no inicializado";
         return;
     }
 
@@ -535,7 +670,7 @@ void MainWindow::onStatusChanged(int index)
     default: newStatus = 0x01; m_currentStatus = "ACTIVO"; break;
     }
 
-    qDebug() << "Intentando cambiar el estado a:" << m_currentStatus << "(" << newStatus << ")";
+    qCDebug(lcPresence) << "Intentando cambiar el estado a:" << m_currentStatus << "(" << newStatus << ")";
 
     if (newStatus != 0x03 && m_inactivityTimer->isActive()) {
         m_inactivityTimer->start();
@@ -564,55 +699,25 @@ void MainWindow::onInfoButtonClicked()
     if (ui->userInfoSidebar->isVisible()) {
         ui->userInfoName->setText(currentChatTitle);
         
-        QString firstLetter = currentChatTitle.isEmpty() ? 
-                             QString("?") : 
-                             QString(currentChatTitle.at(0).toUpper());
-        ui->userInfoAvatar->setText(firstLetter);
-        
-        int hash = 0;
-        for (const QChar &c : currentChatTitle) {
-            hash = ((hash << 5) - hash) + c.unicode();
-        }
+        ui->userInfoAvatar->setPixmap(m_avatars->avatar(currentChatTitle, InfoAvatarSize));
         
-        QColor avatarColor;
-        if (currentChatTitle.isEmpty()) {
-            avatarColor = QColor("#128C7E");
-        } else {
-            int hue = qAbs(hash) % 360;
-            avatarColor = QColor::fromHsv(hue, 200, 200);
-        }
-        
-        ui->userInfoAvatar->setStyleSheet(QString("QLabel {"
-                                                 "background-color: %1;"
-                                                 "border-radius: 50px;"
-                                                 "color: white;"
-                                                 "font-weight: bold;"
-                                                 "font-size: 36px;"
-                                                 "}").arg(avatarColor.name()));
-        
-        for (int i = 0; i < ui->userListWidget->count(); ++i) {
-            QListWidgetItem *item = ui->userListWidget->item(i);
-            UserChatItem *chatItem = qobject_cast<UserChatItem*>(ui->userListWidget->itemWidget(item));
+        const int row = m_rosterModel->find(currentChatTitle);
+        if (row >= 0) {
+            QString status = RosterModel::statusText(m_rosterModel->status(row));
+            ui->userInfoStatusValue->setText(status);
             
-            if (chatItem && chatItem->username() == currentChatTitle) {
-                QString status = chatItem->status();
-                ui->userInfoStatusValue->setText(status);
-                
-                if (status == "ACTIVO") {
-                    ui->userInfoStatus->setText("Active");
-                    ui->userInfoStatus->setStyleSheet("color: #2ecc71;");
-                } else if (status == "OCUPADO") {
-                    ui->userInfoStatus->setText("Busy");
-                    ui->userInfoStatus->setStyleSheet("color: #e74c3c;");
-                } else if (status == "INACTIVO") {
-                    ui->userInfoStatus->setText("Inactive");
-                    ui->userInfoStatus->setStyleSheet("color: #f1c40f;");
-                } else {
-                    ui->userInfoStatus->setText(status);
-                    ui->userInfoStatus->setStyleSheet("color: #95a5a6;");
-                }
-                
-                break;
+            if (status == "ACTIVO") {
+                ui->userInfoStatus->setText("Active");
+                ui->userInfoStatus->setStyleSheet("color: #2ecc71;");
+            } else if (status == "OCUPADO") {
+                ui->userInfoStatus->setText("Busy");
+                ui->userInfoStatus->setStyleSheet("color: #e74c3c;");
+            } else if (status == "INACTIVO") {
+                ui->userInfoStatus->setText("Inactive");
+                ui->userInfoStatus->setStyleSheet("color: #f1c40f;");
+            } else {
+                ui->userInfoStatus->setText(status);
+                ui->userInfoStatus->setStyleSheet("color: #95a5a6;");
             }
         }
         
@@ -625,31 +730,7 @@ void MainWindow::showCurrentUserInfo()
     ui->userInfoSidebar->setVisible(true);
     ui->userInfoName->setText(m_currentUsername);
     
-    QString firstLetter = m_currentUsername.isEmpty() ? 
-                         QString("?") : 
-                         QString(m_currentUsername.at(0).toUpper());
-    ui->userInfoAvatar->setText(firstLetter);
-    
-    int hash = 0;
-    for (const QChar &c : m_currentUsername) {
-        hash = ((hash << 5) - hash) + c.unicode();
-    }
-    
-    QColor avatarColor;
-    if (m_currentUsername.isEmpty()) {
-        avatarColor = QColor("#128C7E");
-    } else {
-        int hue = qAbs(hash) % 360;
-        avatarColor = QColor::fromHsv(hue, 200, 200);
-    }
-    
-    ui->userInfoAvatar->setStyleSheet(QString("QLabel {"
-                                             "background-color: %1;"
-                                             "border-radius: 50px;"
-                                             "color: white;"
-                                             "font-weight: bold;"
-                                             "font-size: 36px;"
-                                             "}").arg(avatarColor.name()));
+    ui->userInfoAvatar->setPixmap(m_avatars->avatar(m_currentUsername, InfoAvatarSize));
     
     ui->userInfoStatusValue->setText(m_currentStatus);
     
@@ -709,6 +790,62 @@ void MainWindow::onHelpTriggered()
                              "- Disconnect using File -> Disconnect\n");
 }
 
+void MainWindow::onSaveLogTriggered()
+{
+    const QString path = QFileDialog::getSaveFileName(this, "Save Diagnostic Log",
+                                                      "chat-" + QDateTime::currentDateTime().toString("yyyyMMdd-hhmmss") + ".log",
+                                                      "Log files (*.log *.txt)");
+    if (path.isEmpty())
+        return;
+
+    if (Logging::dumpToFile(path))
+        ui->statusbar->showMessage("Registro guardado en " + path, 3000);
+    else
+        QMessageBox::warning(this, "Error", "No se pudo guardar el registro en " + path);
+}
+
+void MainWindow::updateLatencyDisplay()
+{
+    if (!m_webSocketClient)
+        return;
+
+    // La barra muestra el envío de mensajes, la acción más visible; el
+    // tooltip y el panel tienen el resto.
+    const LatencyTracker &latency = m_webSocketClient->latency();
+    const LatencyTracker::Summary echo = latency.summary(LatencyTracker::MessageEcho);
+    m_latencyLabel->setText(echo.count == 0
+        ? QString("Envío: —")
+        : QString("Envío p50 %1 · p99 %2 · máx %3").arg(LatencyHistogram::format(echo.p50),
+                                                      LatencyHistogram::format(echo.p99),
+                                                      LatencyHistogram::format(echo.max)));
+
+    QStringList lines;
+    for (int i = 0; i < LatencyTracker::ActionCount; ++i) {
+        const auto action = LatencyTracker::Action(i);
+        const LatencyTracker::Summary summary = latency.summary(action);
+        lines << QString("%1: p50 %2, p99 %3, máx %4 (%5 muestras)")
+                     .arg(LatencyTracker::actionName(action), LatencyHistogram::format(summary.p50),
+                          LatencyHistogram::format(summary.p99), LatencyHistogram::format(summary.max))
+                     .arg(summary.count);
+    }
+    m_latencyLabel->setToolTip(lines.join('\n'));
+
+    if (m_diagnostics->isVisible())
+        m_diagnostics->refresh();
+}
+
+void MainWindow::sampleMetrics()
+{
+    Metrics::gauge("memory.conversations").set(m_session.store().memoryUsage());
+    Metrics::gauge("memory.messageIndex").set(m_session.search().memoryUsage());
+    Metrics::gauge("memory.rosterIndex").set(m_rosterModel->searchIndex().memoryUsage());
+    Metrics::gauge("memory.avatars").set(m_avatars->memoryUsage());
+    Metrics::gauge("memory.log").set(Logging::memoryUsage());
+    Metrics::gauge("queue.messageIndex").set(m_session.search().pendingCount());
+    Metrics::gauge("roster.users").set(m_rosterModel->rowCount());
+    Metrics::gauge("conversations.messages").set(m_session.store().messageCount());
+}
+
 void MainWindow::onInactivityTimeout()
 {
     if (m_connected && m_webSocketClient && m_currentStatus != "INACTIVO") {
@@ -718,8 +855,13 @@ void MainWindow::onInactivityTimeout()
 
 void MainWindow::onUserListReceived(const QStringList &users)
 {
-    qDebug() << "Lista de usuarios recibida:" << users;
-    ui->userListWidget->clear();
+    static Metrics::Timer &rebuildTime = Metrics::timer("roster.rebuild");
+    Metrics::ScopedTimer timing(rebuildTime);
+
+    qCDebug(lcRoster) << "Lista de usuarios recibida:" << users.size() << "usuarios";
+
+    QList<RosterModel::Entry> entries;
+    entries.reserve(users.size());
 
     for (const QString &userWithStatus : users) {
         QString username = userWithStatus;
@@ -738,21 +880,34 @@ void MainWindow::onUserListReceived(const QStringList &users)
         if (username == m_currentUsername)
             continue;
 
-        QString upperStatus = statusText.toUpper();
-        if (upperStatus == "DESCONECTADO" || upperStatus == "DISCONNECTED" || upperStatus == "OFFLINE")
+        const quint8 status = RosterModel::statusCode(statusText);
+        if (status == 0x00)
             continue;
 
-        QListWidgetItem *item = new QListWidgetItem(ui->userListWidget);
-        item->setSizeHint(QSize(0, 70));
-
-        UserChatItem *chatItem = new UserChatItem(username, statusText, "No messages yet");
-        ui->userListWidget->setItemWidget(item, chatItem);
+        entries.append(RosterModel::Entry{username, QStringLiteral("No messages yet"), status});
     }
+
+    // Un solo reset: la vista crea y pinta solo las filas visibles
+    m_rosterModel->reset(entries);
+
+    // La lista responde al pedido que se hace al conectar: el servidor
+    // registró la sesión, aunque la verificación haya dicho 400
+    if (!m_connected && m_webSocketClient && m_gate.sessionConfirmed() == ConnectGate::Ready)
+        onConnectionReady();
+}
+
+void MainWindow::onUserConnected(const QString &username)
+{
+    if (username == m_currentUsername)
+        return;
+
+    // Delta del roster: solo se toca la fila de este usuario
+    m_rosterModel->upsert(username, 0x01);
 }
 
 void MainWindow::onUserStatusReceived(quint8 status)
 {
-    qDebug() << "Estado de usuario recibido:" << status;
+    qCDebug(lcPresence) << "Estado de usuario recibido:" << status;
     
     switch (status) {
     case 0x01:
@@ -776,65 +931,53 @@ void MainWindow::onUserStatusReceived(quint8 status)
     }
 }
 
-void MainWindow::updateUserAvatar()
+void MainWindow::onAvatarChanged(const QString &username)
 {
-    QString firstLetter = m_currentUsername.isEmpty() ? 
-                         QString("?") : 
-                         QString(m_currentUsername.at(0).toUpper());
-    ui->userAvatar->setText(firstLetter);
-
-    int hash = 0;
-    for (const QChar &c : m_currentUsername) {
-        hash = ((hash << 5) - hash) + c.unicode();
-    }
-
-    QColor avatarColor;
-    if (m_currentUsername.isEmpty()) {
-        avatarColor = QColor("#128C7E");
-    } else {
-        int hue = qAbs(hash) % 360;
-        avatarColor = QColor::fromHsv(hue, 200, 200);
-    }
+    // Solo se vuelve a pintar donde aparece ese usuario
+    if (username == m_currentUsername)
+        updateUserAvatar();
+    if (ui->userInfoSidebar->isVisible() && ui->userInfoName->text() == username)
+        ui->userInfoAvatar->setPixmap(m_avatars->avatar(username, InfoAvatarSize));
+    ui->userListView->viewport()->update();
+}
 
-    ui->userAvatar->setStyleSheet(QString("QLabel {"
-                                          "background-color: %1;"
-                                          "border-radius: 30px;"
-                                          "color: white;"
-                                          "font-weight: bold;"
-                                          "font-size: 24px;"
-                                          "}").arg(avatarColor.name()));
+void MainWindow::updateUserAvatar()
+{
+    ui->userAvatar->setPixmap(m_avatars->avatar(m_currentUsername, HeaderAvatarSize));
 }
 
 void MainWindow::getChatHistory(const QString &chatName)
 {
-    qDebug() << "DEBUG - Solicitando historial de chat para:" << chatName;
+    qCDebug(lcProtocol) << "Solicitando historial de chat para:" << chatName;
     
     if (!m_connected || !m_webSocketClient) {
-        qDebug() << "No se puede obtener historial: no conectado o cliente no inicializado";
+        qCWarning(lcProtocol) << "No se puede obtener historial: no conectado o cliente no inicializado";
         return;
     }
     
     if (chatName.isEmpty()) {
-        qDebug() << "Error: nombre de chat vacío";
+        qCWarning(lcProtocol) << "Error: nombre de chat vacío";
         return;
     }
     
     // Guardar para qué chat se está solicitando el historial
     m_requestedHistoryChat = chatName;
-    qDebug() << "DEBUG - Guardando chat solicitado para historial:" << m_requestedHistoryChat;
-    
-    // Mostrar mensaje de carga y limpiar el área de mensajes
-    addSystemMessage("Cargando historial de mensajes...");
-    ui->messageDisplay->clear();
-    
+    qCDebug(lcProtocol) << "Guardando chat solicitado para historial:" << m_requestedHistoryChat;
+
+    // Mostrar de inmediato lo que ya tenemos en memoria (o en disco la
+    // primera vez); el servidor solo completa lo que falte cuando responda.
+    m_olderOverlap = 0;
+    m_session.ensureConversation(chatName);
+    showNewMessages();
+
     try {
         // Solicitar el historial al WebSocketClient
         m_webSocketClient->getChatHistory(chatName);
     } catch (const std::exception& e) {
-        qDebug() << "Excepción al obtener historial:" << e.what();
+        qCWarning(lcProtocol) << "Excepción al obtener historial:" << e.what();
         addSystemMessage("Error al obtener historial: " + QString(e.what()));
     } catch (...) {
-        qDebug() << "Error desconocido al obtener historial";
+        qCWarning(lcProtocol) << "Error desconocido al obtener historial";
         addSystemMessage("Error desconocido al obtener historial del chat.");
     }
 }
@@ -856,121 +999,140 @@ QString MainWindow::getLocalIPAddress() {
     return "127.0.0.1";
 }
 
-void MainWindow::addChatMessage(const QString &sender, const QString &message, MessageBubble::MessageType type)
+void MainWindow::showNewMessages()
 {
-    qDebug() << "DEBUG - addChatMessage: Emisor=" << sender 
-             << "Tipo=" << (type == MessageBubble::System ? "Sistema" : 
-                           (type == MessageBubble::Sent ? "Enviado" : "Recibido"));
-    
-    QTextBrowser *display = ui->messageDisplay;
-    QDateTime timestamp = QDateTime::currentDateTime();
-    
-    QString html;
-    
-    switch (type) {
-        case MessageBubble::System:
-            html = QString(
-                "<table width='100%' cellspacing='0' cellpadding='0' border='0'>"
-                "<tr><td align='center'>"
-                "<div style='display:inline-block; background-color:#e1f3fb; color:#555; "
-                "border-radius:5px; padding:8px; margin:5px; max-width:80%;'>"
-                "<b>Sistema:</b> %1"
-                "</div>"
-                "</td></tr>"
-                "</table>"
-            ).arg(message.toHtmlEscaped());
-            break;
-            
-        case MessageBubble::Sent:
-            html = QString(
-                "<table width='100%' cellspacing='0' cellpadding='0' border='0'>"
-                "<tr><td align='right'>"
-                "<div style='display:inline-block; background-color:#dcf8c6; color:#000; "
-                "border-radius:10px; padding:8px; margin:5px; max-width:80%;'>"
-                "<b>%1:</b> %2<br>"
-                "<span style='font-size:10px; color:#888;'>%3</span>"
-                "</div>"
-                "</td></tr>"
-                "</table>"
-            ).arg(sender).arg(message.toHtmlEscaped()).arg(timestamp.toString("hh:mm AP"));
-            break;
-            
-        case MessageBubble::Received:
-        default:
-            html = QString(
-                "<table width='100%' cellspacing='0' cellpadding='0' border='0'>"
-                "<tr><td align='left'>"
-                "<div style='display:inline-block; background-color:#ffffff; color:#000; "
-                "border:1px solid #ddd; border-radius:10px; padding:8px; margin:5px; max-width:80%;'>"
-                "<b>%1:</b> %2<br>"
-                "<span style='font-size:10px; color:#888;'>%3</span>"
-                "</div>"
-                "</td></tr>"
-                "</table>"
-            ).arg(sender).arg(message.toHtmlEscaped()).arg(timestamp.toString("hh:mm AP"));
-            break;
+    // Si ya hay un lote en curso, el próximo tramo también toma estos mensajes
+    if (m_renderTimer->isActive())
+        return;
+    m_batchRendered = false;
+    renderPendingMessages();
+}
+
+void MainWindow::renderPendingMessages()
+{
+    // Agrega filas y mide su alto (queda en la caché del modelo) durante
+    // como mucho RenderSliceMs; lo que falte sigue después de que el bucle de
+    // eventos procese la entrada y pinte.
+    static Metrics::Timer &sliceTime = Metrics::timer("render.slice");
+    static Metrics::Counter &rendered = Metrics::counter("render.messages");
+
+    QElapsedTimer slice;
+    slice.start();
+    while (m_messageModel->hasPending() && slice.elapsed() < RenderSliceMs) {
+        const int first = m_messageModel->rowCount();
+        const int added = m_messageModel->syncTail(RenderSliceMessages);
+        for (int row = first; row < first + added; ++row)
+            ui->messageDisplay->sizeHintForIndex(m_messageModel->index(row));
+        m_batchRendered = m_batchRendered || added > 0;
+        rendered.add(quint64(added));
     }
-    
-    qDebug() << "DEBUG - HTML generado:" << html.left(150) << "...";
-    display->append(html);
-    display->verticalScrollBar()->setValue(display->verticalScrollBar()->maximum());
+    sliceTime.record(slice.nsecsElapsed());
+
+    if (m_messageModel->hasPending()) {
+        m_renderTimer->start();
+        return;
+    }
+
+    // Un solo desplazamiento por lote
+    if (m_batchRendered)
+        ui->messageDisplay->scrollToBottom();
+    m_batchRendered = false;
 }
 
 void MainWindow::addSystemMessage(const QString &message)
 {
-    qDebug() << "DEBUG - addSystemMessage:" << message.left(50);
-    
-    QString html = QString(
-        "<table width='100%' cellspacing='0' cellpadding='0' border='0'>"
-        "<tr><td align='center'>"
-        "<div style='display:inline-block; background-color:#e1f3fb; color:#555; "
-        "border-radius:5px; padding:8px; margin:5px; max-width:80%;'>"
-        "<b>Sistema:</b> %1"
-        "</div>"
-        "</td></tr>"
-        "</table>"
-    ).arg(message.toHtmlEscaped());
-    
-    ui->messageDisplay->append(html);
-    ui->messageDisplay->verticalScrollBar()->setValue(ui->messageDisplay->verticalScrollBar()->maximum());
+    qCDebug(lcRender) << "addSystemMessage:" << message.left(50);
+
+    // El aviso va después de los mensajes que ya llegaron aunque el lote
+    // todavía se esté agregando por tramos
+    if (m_renderTimer->isActive())
+        m_messageModel->syncTail();
+    m_messageModel->appendNotice(message);
+    ui->messageDisplay->scrollToBottom();
 }
 
-void MainWindow::updateUserLastMessage(const QString &username, const QString &message)
+void MainWindow::onHistoryReceived(const QString &chatName, const QList<HistoryEntry> &entries, bool hasMore)
 {
-    for (int i = 0; i < ui->userListWidget->count(); ++i) {
-        QListWidgetItem *item = ui->userListWidget->item(i);
-        UserChatItem *chatItem = qobject_cast<UserChatItem*>(ui->userListWidget->itemWidget(item));
-
-        if (chatItem && chatItem->username() == username) {
-            chatItem->setLastMessage(message);
-            QListWidgetItem *topItem = ui->userListWidget->takeItem(i);
-            ui->userListWidget->insertItem(0, topItem);
-            ui->userListWidget->setItemWidget(topItem, chatItem);
-            break;
-        }
+    Q_UNUSED(hasMore);
+
+    // Persistir lo nuevo en disco y en memoria; solo se dibuja lo que la
+    // conversación en memoria todavía no tenía.
+    qsizetype older = 0;
+    const qsizetype added = m_session.syncHistory(chatName, entries, &older);
+    const qsizetype count = m_session.store().count(chatName);
+
+    qCDebug(lcRender) << "ConversationStore:" << m_session.store().messageCount() << "mensajes,"
+             << m_session.store().memoryUsage() << "bytes";
+
+    if (chatName != m_currentChat || chatName != m_requestedHistoryChat)
+        return;
+
+    // La página empieza antes que todo lo que había en memoria (por ejemplo,
+    // solo mensajes recibidos en vivo): lo anterior va arriba
+    if (older > 0 && m_messageModel->prependOlder(older, QString()) > 0 && added == 0)
+        ui->messageDisplay->scrollToBottom();
+    if (added > 0)
+        showNewMessages();
+
+    // Mensajes en pantalla más antiguos que la página del servidor: las
+    // primeras páginas anteriores los repetirían.
+    m_olderOverlap = qMax(0, int(count) - int(entries.size()));
+}
+
+void MainWindow::onMessageDisplayScrolled(int value)
+{
+    QScrollBar *bar = ui->messageDisplay->verticalScrollBar();
+    if (value != bar->minimum() || bar->maximum() == bar->minimum())
+        return;
+
+    if (m_connected && m_webSocketClient && m_webSocketClient->loadOlderHistory()) {
+        ui->statusbar->showMessage("Cargando mensajes anteriores...", 2000);
     }
 }
 
+void MainWindow::onOlderHistoryReceived(const QString &chatName, const QList<HistoryEntry> &entries, bool hasMore)
+{
+    // Página de un chat que ya no está abierto
+    if (chatName != m_currentChat)
+        return;
+
+    // Descartar lo que ya se mostró desde el registro local
+    const int skip = qMin(m_olderOverlap, int(entries.size()));
+    m_olderOverlap -= skip;
+    const QList<HistoryEntry> older = entries.mid(0, entries.size() - skip);
+
+    m_session.prependOlder(chatName, older);
+
+    // Insertar arriba conservando la fila que el usuario está viendo
+    QListView *view = ui->messageDisplay;
+    const QModelIndex anchor = view->indexAt(QPoint(0, 0));
+    const int anchorOffset = anchor.isValid() ? view->visualRect(anchor).top() : 0;
+
+    const int inserted = m_messageModel->prependOlder(older.size(),
+                                                      hasMore ? QString() : QString("Inicio de la conversación"));
+    if (inserted == 0 || !anchor.isValid())
+        return;
+
+    view->scrollTo(m_messageModel->index(anchor.row() + inserted), QAbstractItemView::PositionAtTop);
+    view->verticalScrollBar()->setValue(view->verticalScrollBar()->value() - anchorOffset);
+}
+
+void MainWindow::updateUserLastMessage(const QString &username, const QString &message)
+{
+    m_rosterModel->setLastMessage(username, message);
+}
+
 void MainWindow::onExternalUserStatusChanged(const QString& username, quint8 newStatus)
 {
-    qDebug() << "Cambio de estado detectado: " << username << " -> " << newStatus;
-
-    QString newStatusText;
-    switch (newStatus) {
-    case 0x01: newStatusText = "ACTIVO"; break;
-    case 0x02: newStatusText = "OCUPADO"; break;
-    case 0x03: newStatusText = "INACTIVO"; break;
-    default: newStatusText = "DESCONOCIDO"; break;
-    }
+    qCDebug(lcPresence) << "Cambio de estado detectado: " << username << " -> " << newStatus;
 
-    for (int i = 0; i < ui->userListWidget->count(); ++i) {
-        QListWidgetItem *item = ui->userListWidget->item(i);
-        UserChatItem *chatItem = qobject_cast<UserChatItem*>(ui->userListWidget->itemWidget(item));
+    const QString newStatusText = RosterModel::statusText(newStatus);
 
-        if (chatItem && chatItem->username() == username) {
-            chatItem->setStatus(newStatusText);
-            break;
-        }
+    // Delta del roster: se actualiza, agrega o quita solo la fila afectada
+    if (newStatus == 0x00) {
+        m_rosterModel->remove(username);
+    } else if (username != m_currentUsername) {
+        m_rosterModel->upsert(username, newStatus);
     }
 
     // Si el sidebar está mostrando a ese usuario, actualiza también ahí
@@ -995,18 +1157,111 @@ void MainWindow::onExternalUserStatusChanged(const QString& username, quint8 new
 
 void MainWindow::onSearchTextChanged(const QString &text)
 {
-    QString searchText = text.trimmed().toLower();
+    // Borrar la búsqueda devuelve la lista completa sin esperar
+    if (text.trimmed().isEmpty()) {
+        m_searchDebounce->stop();
+        applySearchQuery();
+        return;
+    }
+    m_searchDebounce->start();
+}
 
-    for (int i = 0; i < ui->userListWidget->count(); ++i) {
-        QListWidgetItem *item = ui->userListWidget->item(i);
-        UserChatItem *chatItem = qobject_cast<UserChatItem*>(ui->userListWidget->itemWidget(item));
+void MainWindow::applySearchQuery()
+{
+    m_rosterProxy->setQuery(ui->searchUsers->text());
+}
 
-        if (chatItem) {
-            bool match = searchText.isEmpty() ||
-                         chatItem->username().toLower().contains(searchText);
-            item->setHidden(!match);
+void MainWindow::openQuickSwitcher()
+{
+    QuickSwitcher switcher([this](const QString &text, int limit) {
+        // El chat general va primero cuando no hay texto o si su nombre coincide
+        QList<RosterSearchIndex::Match> matches;
+        const QString query = text.trimmed();
+        if (query.isEmpty() || QString("General Chat").contains(query, Qt::CaseInsensitive))
+            matches.append(RosterSearchIndex::Match{"~", 0});
+        if (query.isEmpty()) {
+            for (int row = 0; row < m_rosterProxy->rowCount() && matches.size() < limit; ++row)
+                matches.append(RosterSearchIndex::Match{
+                    m_rosterProxy->index(row, 0).data(RosterModel::NameRole).toString(), 0});
+            return matches;
         }
+        matches.append(m_rosterModel->searchIndex().search(query, limit - int(matches.size())));
+        return matches;
+    }, this);
+
+    switcher.move(mapToGlobal(QPoint((width() - switcher.width()) / 2, height() / 6)));
+    if (switcher.exec() != QDialog::Accepted)
+        return;
+
+    openConversation(switcher.selectedChat());
+}
+
+void MainWindow::openMessageSearch()
+{
+    MessageSearchDialog dialog(
+        [this](const QString &query, bool currentOnly) {
+            return m_session.search().search(query, currentOnly ? m_currentChat : QString());
+        },
+        [this](const MessageSearchIndex::Hit &hit) {
+            const qsizetype index = m_session.store().indexOf(hit.conversation, hit.sequence);
+            if (index < 0)
+                return QString();
+            const LogRecord record = m_session.store().message(hit.conversation, index);
+            const QString chat = hit.conversation == "~" ? QString("General Chat") : hit.conversation;
+            return QString("%1 · %2 · %3\n%4")
+                .arg(chat, record.sender,
+                     record.timestamp > 0 ? QDateTime::fromMSecsSinceEpoch(record.timestamp).toString("dd/MM hh:mm")
+                                          : QString("--/-- --:--"),
+                     record.text.left(200));
+        },
+        this);
+    if (dialog.exec() != QDialog::Accepted)
+        return;
+
+    const MessageSearchIndex::Hit hit = dialog.selectedHit();
+    openConversation(hit.conversation);
+    if (m_messageModel->conversation() != hit.conversation)
+        return;
+
+    // Todo lo que ya está en el store pasa a ser fila para poder ubicarlo;
+    // el lote en curso ya no debe bajar la vista al final
+    const qsizetype message = m_session.store().indexOf(hit.conversation, hit.sequence);
+    m_renderTimer->stop();
+    m_batchRendered = false;
+    m_messageModel->syncTail();
+    const int row = message >= 0 ? m_messageModel->rowOf(message) : -1;
+    if (row < 0) {
+        ui->statusbar->showMessage("El mensaje no se muestra en esta conversación", 2000);
+        return;
     }
+
+    ui->messageDisplay->scrollTo(m_messageModel->index(row), QAbstractItemView::PositionAtCenter);
+    m_messageModel->setHighlightedMessage(message);
+    QTimer::singleShot(HighlightMs, this, [this] {
+        m_messageModel->setHighlightedMessage(-1);
+    });
+}
+
+void MainWindow::openConversation(const QString &chat)
+{
+    if (chat == "~") {
+        ui->chatTabs->setCurrentIndex(1); // Broadcast tab
+        if (m_currentChat != "~" && ui->broadcastListWidget->count() > 0)
+            onBroadcastItemClicked(ui->broadcastListWidget->item(0));
+        return;
+    }
+
+    const int row = m_rosterModel->find(chat);
+    if (row < 0)
+        return;
+
+    // Un filtro activo podría ocultar al usuario elegido
+    ui->searchUsers->clear();
+    ui->chatTabs->setCurrentIndex(0); // Direct tab
+    const QModelIndex index = m_rosterProxy->mapFromSource(m_rosterModel->index(row));
+    ui->userListView->setCurrentIndex(index);
+    ui->userListView->scrollTo(index);
+    onUserItemClicked(index);
 }
 
 void MainWindow::loadDirectChatHistory(const QString &username)
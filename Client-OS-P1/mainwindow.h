@@ -6,6 +6,7 @@
 #include <QWebSocket>
 #include <QListWidgetItem>
 #include <QTimer>
+#include <QElapsedTimer>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
@@ -19,7 +20,19 @@
 #include <QNetworkReply>
 #include <QCloseEvent>
 
+#include "avatarcache.h"
+#include "chatsession.h"
+#include "connectgate.h"
 #include "connectiondialog.h"
+#include "diagnosticsdock.h"
+#include "messagedelegate.h"
+#include "messagelistmodel.h"
+#include "messagesearchdialog.h"
+#include "metricsdock.h"
+#include "namevalidationcache.h"
+#include "quickswitcher.h"
+#include "rosterdelegate.h"
+#include "rostermodel.h"
 #include "userchatitem.h"
 #include "messagebubble.h"
 #include "websocketclient.h"
@@ -49,16 +62,18 @@ private slots:
     // WebSocket events
     void onWebSocketConnected();
     void onWebSocketDisconnected();
+    void onWebSocketReconnecting(int attempt, qint64 delayMs);
+    void onWebSocketResumed();
     
     // Message handling
     void onMessageReceived(const QString &sender, const QString &message);
-    // NUEVO SLOT para procesar mensajes con bandera de historial
+    // isHistory: el mensaje vino dentro de un historial y no se vuelve a guardar
     void onMessageReceivedWithFlag(const QString &sender, const QString &message, bool isHistory);
     void onSendButtonClicked();
     void onMessageInputChanged();
     
     // User interaction
-    void onUserItemClicked(QListWidgetItem *item);
+    void onUserItemClicked(const QModelIndex &index);
     void onBroadcastItemClicked(QListWidgetItem *item);
     void onStatusChanged(int index);
     void onExternalUserStatusChanged(const QString &username, quint8 newStatus);
@@ -73,10 +88,23 @@ private slots:
     // Menu actions
     void onAboutTriggered();
     void onHelpTriggered();
+    void onSaveLogTriggered();
     
     // User list and status
     void onUserListReceived(const QStringList &users);
+    void onUserConnected(const QString &username);
+
+    // Paginated history
+    void onMessageDisplayScrolled(int value);
+    void onHistoryReceived(const QString &chatName, const QList<HistoryEntry> &entries, bool hasMore);
+    void onOlderHistoryReceived(const QString &chatName, const QList<HistoryEntry> &entries, bool hasMore);
     void onUserStatusReceived(quint8 status);
+    void renderPendingMessages();
+    void onAvatarChanged(const QString &username);
+    void applySearchQuery();
+    void openQuickSwitcher();
+    void openMessageSearch();
+    void updateLatencyDisplay();
     
     // Timer events
     void onInactivityTimeout();
@@ -95,13 +123,20 @@ private:
     QString getLocalIPAddress();
     
     // Chat message handling
-    void addChatMessage(const QString &sender, const QString &message, MessageBubble::MessageType type);
+    void showNewMessages();
     void addSystemMessage(const QString &message);
     void updateUserLastMessage(const QString &username, const QString &message);
     
     // Chat history
     void loadDirectChatHistory(const QString &username);
     void loadBroadcastChatHistory();
+    void openConversation(const QString &chat);
+    void abortConnection();
+    // Verificación y WebSocket resueltos (ver ConnectGate)
+    void onConnectionReady();
+    void rejectName();
+    // Medidores que se leen a pedido, antes de cada instantánea de Metrics
+    void sampleMetrics();
 
     Ui::MainWindow *ui;
     WebSocketClient *m_webSocketClient;
@@ -112,8 +147,48 @@ private:
     QTimer *m_inactivityTimer;
     QNetworkAccessManager *m_networkManager;
 
-    // NUEVA VARIABLE: Almacena para qué chat se está solicitando el historial
+    // Chat cuyo historial se pidió por última vez
     QString m_requestedHistoryChat;
+
+    // Conversaciones, registro local y búsqueda (sin interfaz, en core/)
+    QString m_serverHost;
+    ChatSession m_session;
+    int m_olderOverlap;
+
+    // Vista del chat abierto
+    static constexpr qint64 RenderSliceMs = 8;
+    static constexpr int RenderSliceMessages = 64;
+    MessageListModel *m_messageModel;
+    QTimer *m_renderTimer;
+    bool m_batchRendered;
+
+    // Avatares compartidos por el roster, el encabezado y el panel de info
+    static constexpr int HeaderAvatarSize = 60;
+    static constexpr int InfoAvatarSize = 100;
+    AvatarCache *m_avatars;
+
+    // Pestaña Direct
+    RosterModel *m_rosterModel;
+    RosterProxyModel *m_rosterProxy;
+    static constexpr int SearchDebounceMs = 120;
+    QTimer *m_searchDebounce;
+
+    // Búsqueda en el historial
+    static constexpr int HighlightMs = 2000;
+
+    // Latencia de ida y vuelta: resumen en la barra de estado y panel de detalle
+    static constexpr int LatencyRefreshMs = 1000;
+    DiagnosticsDock *m_diagnostics;
+    QLabel *m_latencyLabel;
+    QTimer *m_latencyTimer;
+
+    // Métricas del cliente (tráfico, tiempos, colas, memoria) y su exportación
+    MetricsDock *m_metrics;
+
+    // Conexión: el WebSocket se abre en paralelo con la verificación HTTP
+    NameValidationCache m_validations;
+    QElapsedTimer m_connectClock;
+    ConnectGate m_gate;
 };
 
 #endif // MAINWINDOW_H
@@ -0,0 +1,206 @@
+#include "messagedelegate.h"
+#include "messagelistmodel.h"
+
+#include <QAbstractScrollArea>
+#include <QDateTime>
+#include <QPainter>
+#include <QPainterPath>
+#include <QTextLayout>
+#include <QtMath>
+
+namespace {
+
+// Reparte el texto en líneas de como mucho `width` px (cortando palabras
+// demasiado largas) y devuelve el tamaño que ocupa.
+QSize wrapText(QTextLayout &layout, int width) {
+    QTextOption option;
+    option.setWrapMode(QTextOption::WrapAtWordBoundaryOrAnywhere);
+    layout.setTextOption(option);
+
+    qreal height = 0;
+    qreal widest = 0;
+    layout.beginLayout();
+    forever {
+        QTextLine line = layout.createLine();
+        if (!line.isValid())
+            break;
+        line.setLineWidth(width);
+        line.setPosition(QPointF(0, height));
+        height += line.height();
+        widest = qMax(widest, line.naturalTextWidth());
+    }
+    layout.endLayout();
+    return QSize(qCeil(widest), qCeil(height));
+}
+
+QColor bubbleColor(MessageBubble::MessageType type) {
+    switch (type) {
+    case MessageBubble::Sent:     return QColor("#DCF8C6"); // Light green
+    case MessageBubble::System:   return QColor("#E1F3FB"); // Light blue
+    case MessageBubble::Received:
+    default:                      return QColor("#FFFFFF"); // White
+    }
+}
+
+} // namespace
+
+MessageDelegate::MessageDelegate(QObject *parent)
+    : QStyledItemDelegate(parent)
+{
+}
+
+void MessageDelegate::paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const
+{
+    QTextLayout text;
+    const Layout bubble = layout(option, index, text);
+
+    painter->save();
+    painter->setRenderHint(QPainter::Antialiasing);
+
+    QPainterPath path;
+    path.addRoundedRect(QRectF(bubble.bubble).adjusted(0.5, 0.5, -0.5, -0.5), Radius, Radius);
+    if (index.data(MessageListModel::HighlightRole).toBool())
+        painter->setPen(QPen(QColor("#ff9c08"), 2));
+    else
+        painter->setPen(bubble.type == MessageBubble::Received ? QPen(QColor("#DDDDDD")) : QPen(Qt::NoPen));
+    painter->setBrush(bubbleColor(bubble.type));
+    painter->drawPath(path);
+
+    if (!bubble.senderText.isEmpty()) {
+        const QFont font = senderFont(option.font);
+        painter->setFont(font);
+        painter->setPen(QColor("#075E54"));
+        painter->drawText(bubble.sender, Qt::AlignLeft | Qt::AlignVCenter,
+                          QFontMetrics(font).elidedText(bubble.senderText, Qt::ElideRight, bubble.sender.width()));
+    }
+
+    painter->setPen(bubble.type == MessageBubble::System ? QColor("#555555") : QColor("#000000"));
+    text.draw(painter, bubble.text.topLeft());
+
+    if (!bubble.timeText.isEmpty()) {
+        painter->setFont(timeFont(option.font));
+        painter->setPen(QColor("#666666"));
+        painter->drawText(bubble.time, Qt::AlignRight | Qt::AlignVCenter, bubble.timeText);
+    }
+
+    painter->restore();
+}
+
+QSize MessageDelegate::sizeHint(const QStyleOptionViewItem &option, const QModelIndex &index) const
+{
+    const int width = textWidth(option);
+    const auto *model = qobject_cast<const MessageListModel *>(index.model());
+
+    int height = model ? model->cachedHeight(index.row(), width) : -1;
+    if (height < 0) {
+        QTextLayout text;
+        height = layout(option, index, text).bubble.height() + 2 * Margin;
+        if (model)
+            model->setCachedHeight(index.row(), width, height);
+    }
+    return QSize(viewportWidth(option), height);
+}
+
+int MessageDelegate::viewportWidth(const QStyleOptionViewItem &option) const
+{
+    const auto *view = qobject_cast<const QAbstractScrollArea *>(option.widget);
+    return view ? view->viewport()->width() : option.rect.width();
+}
+
+int MessageDelegate::textWidth(const QStyleOptionViewItem &option) const
+{
+    // Como la burbuja HTML anterior: hasta el 80% del ancho, con tope fijo
+    return qMax(4 * Padding, qMin(MaxBubbleWidth, viewportWidth(option) * 4 / 5) - 2 * Padding);
+}
+
+MessageDelegate::Layout MessageDelegate::layout(const QStyleOptionViewItem &option, const QModelIndex &index,
+                                                QTextLayout &text) const
+{
+    Layout result;
+    result.type = MessageBubble::MessageType(index.data(MessageListModel::TypeRole).toInt());
+    const int width = textWidth(option);
+
+    QSize senderSize;
+    if (result.type == MessageBubble::Received) {
+        result.senderText = index.data(MessageListModel::SenderRole).toString();
+        const QFontMetrics metrics(senderFont(option.font));
+        senderSize = QSize(qMin(metrics.horizontalAdvance(result.senderText), width), metrics.height());
+    }
+
+    text.setText(index.data(MessageListModel::TextRole).toString());
+    text.setFont(option.font);
+    const QSize textSize = wrapText(text, width);
+
+    QSize timeSize;
+    const qint64 timestamp = index.data(MessageListModel::TimestampRole).toLongLong();
+    if (timestamp > 0) {
+        result.timeText = timeText(timestamp);
+        const QFontMetrics metrics(timeFont(option.font));
+        timeSize = QSize(metrics.horizontalAdvance(result.timeText), metrics.height());
+    }
+
+    const int inner = qMax(textSize.width(), qMax(senderSize.width(), timeSize.width()));
+    int height = textSize.height();
+    if (!senderSize.isEmpty())
+        height += senderSize.height() + Spacing;
+    if (!timeSize.isEmpty())
+        height += Spacing + timeSize.height();
+
+    // Alineación como en MessageBubble: enviados a la derecha, recibidos a
+    // la izquierda y avisos del sistema al centro.
+    const QSize bubbleSize(inner + 2 * Padding, height + 2 * VerticalPadding);
+    int x;
+    switch (result.type) {
+    case MessageBubble::Sent:
+        x = option.rect.right() + 1 - Margin - bubbleSize.width();
+        break;
+    case MessageBubble::System:
+        x = option.rect.left() + (option.rect.width() - bubbleSize.width()) / 2;
+        break;
+    case MessageBubble::Received:
+    default:
+        x = option.rect.left() + Margin;
+        break;
+    }
+    result.bubble = QRect(QPoint(x, option.rect.top() + Margin), bubbleSize);
+
+    int y = result.bubble.top() + VerticalPadding;
+    const int left = result.bubble.left() + Padding;
+    if (!senderSize.isEmpty()) {
+        result.sender = QRect(left, y, inner, senderSize.height());
+        y += senderSize.height() + Spacing;
+    }
+    result.text = QRect(left, y, inner, textSize.height());
+    y += textSize.height() + Spacing;
+    if (!timeSize.isEmpty())
+        result.time = QRect(left, y, inner, timeSize.height());
+    return result;
+}
+
+QFont MessageDelegate::senderFont(const QFont &base) const
+{
+    QFont font = base;
+    font.setBold(true);
+    return font;
+}
+
+QFont MessageDelegate::timeFont(const QFont &base) const
+{
+    QFont font = base;
+    font.setPixelSize(10);
+    return font;
+}
+
+QString MessageDelegate::timeText(qint64 timestamp) const
+{
+    const qint64 minute = timestamp / 60000;
+    auto it = m_timeCache.constFind(minute);
+    if (it != m_timeCache.constEnd())
+        return *it;
+
+    if (m_timeCache.size() >= TimeCacheSize)
+        m_timeCache.clear();
+    const QString text = QDateTime::fromMSecsSinceEpoch(minute * 60000).toString("hh:mm AP");
+    m_timeCache.insert(minute, text);
+    return text;
+}
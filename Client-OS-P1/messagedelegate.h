@@ -0,0 +1,60 @@
+#ifndef MESSAGEDELEGATE_H
+#define MESSAGEDELEGATE_H
+#pragma once
+
+#include <QHash>
+#include <QStyledItemDelegate>
+
+#include "messagebubble.h"
+
+class QTextLayout;
+
+// Pinta las filas de MessageListModel como burbujas, con los mismos colores,
+// márgenes y alineación que MessageBubble, sin crear un widget por mensaje.
+//
+// El alto de cada fila se calcula una vez por ancho de texto y queda en la
+// caché del modelo, así que volver a ordenar la vista (por ejemplo al
+// insertar páginas antiguas) no vuelve a medir el texto.
+class MessageDelegate : public QStyledItemDelegate
+{
+    Q_OBJECT
+
+public:
+    static constexpr int MaxBubbleWidth = 400;
+    static constexpr int Padding = 12;        // horizontal, dentro de la burbuja
+    static constexpr int VerticalPadding = 8;
+    static constexpr int Spacing = 2;
+    static constexpr int Margin = 6;          // alrededor de la burbuja
+    static constexpr int Radius = 10;
+    static constexpr int TimeCacheSize = 1024;
+
+    explicit MessageDelegate(QObject *parent = nullptr);
+
+    void paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const override;
+    QSize sizeHint(const QStyleOptionViewItem &option, const QModelIndex &index) const override;
+
+private:
+    struct Layout {
+        MessageBubble::MessageType type;
+        QRect bubble;
+        QRect sender;
+        QRect text;
+        QRect time;
+        QString senderText;
+        QString timeText;
+    };
+
+    int viewportWidth(const QStyleOptionViewItem &option) const;
+    int textWidth(const QStyleOptionViewItem &option) const;
+    Layout layout(const QStyleOptionViewItem &option, const QModelIndex &index, QTextLayout &text) const;
+
+    QFont senderFont(const QFont &base) const;
+    QFont timeFont(const QFont &base) const;
+    QString timeText(qint64 timestamp) const;
+
+    // Hora ya formateada por minuto: los mensajes de una ráfaga comparten
+    // casi siempre el mismo minuto.
+    mutable QHash<qint64, QString> m_timeCache;
+};
+
+#endif // MESSAGEDELEGATE_H
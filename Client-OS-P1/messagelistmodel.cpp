@@ -0,0 +1,180 @@
+#include "messagelistmodel.h"
+
+MessageListModel::MessageListModel(const ConversationStore *store, QObject *parent)
+    : QAbstractListModel(parent)
+    , m_store(store)
+{
+}
+
+void MessageListModel::setConversation(const QString &conversation, const QString &self) {
+    beginResetModel();
+    m_conversation = conversation;
+    m_self = self;
+    m_storeCount = 0;
+    m_highlight = -1;
+    m_rows.clear();
+    m_notices.clear();
+    endResetModel();
+}
+
+int MessageListModel::syncTail(qsizetype maxMessages) {
+    qsizetype count = m_store->count(m_conversation);
+    if (count <= m_storeCount)
+        return 0;
+    if (maxMessages >= 0)
+        count = qMin(count, m_storeCount + maxMessages);
+
+    QList<Row> fresh;
+    fresh.reserve(count - m_storeCount);
+    for (qsizetype i = m_storeCount; i < count; ++i) {
+        const QString sender = m_store->sender(m_conversation, i);
+        if (belongs(sender))
+            fresh.append(messageRow(i, sender));
+    }
+    m_storeCount = count;
+
+    if (fresh.isEmpty())
+        return 0;
+
+    beginInsertRows(QModelIndex(), int(m_rows.size()), int(m_rows.size() + fresh.size() - 1));
+    m_rows.append(fresh);
+    endInsertRows();
+    return int(fresh.size());
+}
+
+int MessageListModel::prependOlder(qsizetype count, const QString &banner) {
+    QList<Row> older;
+    older.reserve(count + 1);
+    if (!banner.isEmpty())
+        older.append(noticeRow(banner));
+    for (qsizetype i = 0; i < count; ++i) {
+        const QString sender = m_store->sender(m_conversation, i);
+        if (belongs(sender))
+            older.append(messageRow(i, sender));
+    }
+
+    // Los mensajes que ya estaban se corrieron `count` posiciones en el store
+    for (Row &row : m_rows) {
+        if (row.message >= 0)
+            row.message += qint32(count);
+    }
+    m_storeCount += count;
+    if (m_highlight >= 0)
+        m_highlight += count;
+
+    if (older.isEmpty())
+        return 0;
+
+    const int inserted = int(older.size());
+    beginInsertRows(QModelIndex(), 0, inserted - 1);
+    older.append(m_rows);
+    m_rows.swap(older);
+    endInsertRows();
+    return inserted;
+}
+
+void MessageListModel::appendNotice(const QString &text) {
+    beginInsertRows(QModelIndex(), int(m_rows.size()), int(m_rows.size()));
+    m_rows.append(noticeRow(text));
+    endInsertRows();
+}
+
+void MessageListModel::clear() {
+    beginResetModel();
+    m_rows.clear();
+    m_notices.clear();
+    m_storeCount = m_store->count(m_conversation);
+    endResetModel();
+}
+
+int MessageListModel::rowOf(qsizetype message) const {
+    // Los mensajes van en orden pero hay avisos intercalados; se busca desde
+    // el final, que es donde suelen estar los resultados recientes
+    for (qsizetype row = m_rows.size() - 1; row >= 0; --row) {
+        if (m_rows.at(row).message == message)
+            return int(row);
+    }
+    return -1;
+}
+
+void MessageListModel::setHighlightedMessage(qsizetype message) {
+    if (message == m_highlight)
+        return;
+    const int previous = rowOf(m_highlight);
+    m_highlight = message;
+    const int current = message >= 0 ? rowOf(message) : -1;
+    if (previous >= 0)
+        emit dataChanged(index(previous), index(previous), {HighlightRole});
+    if (current >= 0)
+        emit dataChanged(index(current), index(current), {HighlightRole});
+}
+
+int MessageListModel::rowCount(const QModelIndex &parent) const {
+    return parent.isValid() ? 0 : int(m_rows.size());
+}
+
+QVariant MessageListModel::data(const QModelIndex &index, int role) const {
+    if (!index.isValid() || index.row() >= m_rows.size())
+        return QVariant();
+
+    const Row &row = m_rows.at(index.row());
+    if (role == TypeRole)
+        return int(row.type);
+    if (role == HighlightRole)
+        return row.message >= 0 && row.message == m_highlight;
+
+    if (row.message < 0) {
+        switch (role) {
+        case Qt::DisplayRole:
+        case TextRole:
+            return m_notices.at(~row.message);
+        case TimestampRole:
+            return qint64(0);
+        default:
+            return QVariant();
+        }
+    }
+
+    switch (role) {
+    case Qt::DisplayRole:
+    case TextRole:
+        return m_store->message(m_conversation, row.message).text;
+    case SenderRole:
+        return m_store->sender(m_conversation, row.message);
+    case TimestampRole:
+        return m_store->timestamp(m_conversation, row.message);
+    default:
+        return QVariant();
+    }
+}
+
+int MessageListModel::cachedHeight(int row, int textWidth) const {
+    if (textWidth != m_heightWidth || row < 0 || row >= m_rows.size())
+        return -1;
+    return m_rows.at(row).height;
+}
+
+void MessageListModel::setCachedHeight(int row, int textWidth, int height) const {
+    if (row < 0 || row >= m_rows.size())
+        return;
+    if (textWidth != m_heightWidth) {
+        for (const Row &r : m_rows)
+            r.height = -1;
+        m_heightWidth = textWidth;
+    }
+    m_rows.at(row).height = height;
+}
+
+bool MessageListModel::belongs(const QString &sender) const {
+    // En un chat directo solo se muestran los mensajes entre los dos
+    return m_conversation == "~" || sender == m_self || sender == m_conversation;
+}
+
+MessageListModel::Row MessageListModel::messageRow(qsizetype message, const QString &sender) const {
+    return Row{qint32(message), -1, sender == m_self ? MessageBubble::Sent : MessageBubble::Received};
+}
+
+MessageListModel::Row MessageListModel::noticeRow(const QString &text) {
+    m_notices.append(text);
+    return Row{~qint32(m_notices.size() - 1), -1, MessageBubble::System};
+}
@@ -0,0 +1,84 @@
+#ifndef MESSAGELISTMODEL_H
+#define MESSAGELISTMODEL_H
+#pragma once
+
+#include <QAbstractListModel>
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+#include "conversationstore.h"
+#include "messagebubble.h"
+
+// Filas del chat abierto, respaldadas por el ConversationStore.
+//
+// Cada fila solo guarda el índice del mensaje dentro de la conversación (o de
+// un aviso del sistema), su tipo y el alto que calculó el delegate; el texto
+// se lee del store cuando la vista pinta la fila. Así el costo de memoria no
+// crece con el largo del texto y la vista solo dibuja lo visible.
+class MessageListModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    enum Roles {
+        SenderRole = Qt::UserRole + 1,
+        TextRole,
+        TimestampRole,
+        TypeRole,
+        HighlightRole       // mensaje al que llevó una búsqueda
+    };
+
+    explicit MessageListModel(const ConversationStore *store, QObject *parent = nullptr);
+
+    // Cambia de conversación y vacía la lista; las filas llegan con syncTail().
+    void setConversation(const QString &conversation, const QString &self);
+    QString conversation() const { return m_conversation; }
+
+    // Agrega las filas de los mensajes que el store tiene al final de la
+    // conversación y la lista todavía no, revisando como mucho `maxMessages`
+    // (todos si es negativo). Devuelve cuántas filas agregó.
+    int syncTail(qsizetype maxMessages = -1);
+    // Hay mensajes en el store que todavía no son filas.
+    bool hasPending() const { return m_store->count(m_conversation) > m_storeCount; }
+    // El store recibió `count` mensajes más antiguos al inicio de la
+    // conversación. Un `banner` no vacío se muestra arriba de todo.
+    int prependOlder(qsizetype count, const QString &banner);
+    void appendNotice(const QString &text);
+    void clear();
+
+    // Fila del mensaje `message` del store, o -1 si no es una fila.
+    int rowOf(qsizetype message) const;
+    // Resalta un mensaje (índice del store); -1 quita el resaltado.
+    void setHighlightedMessage(qsizetype message);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+    // Alto de una fila calculado para un ancho de texto dado; -1 si no está
+    // en caché. Cambiar de ancho invalida todos los altos.
+    int cachedHeight(int row, int textWidth) const;
+    void setCachedHeight(int row, int textWidth, int height) const;
+
+private:
+    struct Row {
+        qint32 message;      // índice en el store; negativo: ~índice del aviso
+        mutable qint32 height;
+        MessageBubble::MessageType type;
+    };
+
+    bool belongs(const QString &sender) const;
+    Row messageRow(qsizetype message, const QString &sender) const;
+    Row noticeRow(const QString &text);
+
+    const ConversationStore *m_store;
+    QString m_conversation;
+    QString m_self;
+    qsizetype m_storeCount = 0;     // mensajes del store ya convertidos en filas
+    QList<Row> m_rows;
+    QStringList m_notices;
+    mutable int m_heightWidth = -1;
+    qsizetype m_highlight = -1;
+};
+
+#endif // MESSAGELISTMODEL_H
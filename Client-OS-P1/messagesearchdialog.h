@@ -0,0 +1,126 @@
+#ifndef MESSAGESEARCHDIALOG_H
+#define MESSAGESEARCHDIALOG_H
+
+#include <QCheckBox>
+#include <QDialog>
+#include <QKeyEvent>
+#include <QLabel>
+#include <QLineEdit>
+#include <QListWidget>
+#include <QVBoxLayout>
+
+#include <functional>
+
+#include "messagesearchindex.h"
+
+// Búsqueda en el historial de mensajes (Ctrl+F).
+//
+// Cada tecla consulta el MessageSearchIndex a través de `search`; `describe`
+// arma el texto de cada resultado. Enter lleva al mensaje seleccionado.
+class MessageSearchDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    using SearchFunction = std::function<QList<MessageSearchIndex::Hit>(const QString &, bool)>;
+    using DescribeFunction = std::function<QString(const MessageSearchIndex::Hit &)>;
+
+    MessageSearchDialog(SearchFunction search, DescribeFunction describe, QWidget *parent = nullptr)
+        : QDialog(parent), m_search(std::move(search)), m_describe(std::move(describe))
+    {
+        setWindowTitle("Buscar mensajes");
+        resize(480, 420);
+
+        m_queryEdit = new QLineEdit(this);
+        m_queryEdit->setPlaceholderText("Palabras o \"una frase exacta\"");
+        m_queryEdit->setStyleSheet("QLineEdit {"
+                                   "border: 1px solid #dddddd;"
+                                   "border-radius: 4px;"
+                                   "padding: 6px;"
+                                   "}");
+        m_queryEdit->installEventFilter(this);
+
+        m_currentOnly = new QCheckBox("Solo en esta conversación", this);
+
+        m_results = new QListWidget(this);
+        m_results->setWordWrap(true);
+        m_results->setStyleSheet("QListWidget { border: none; }"
+                                 "QListWidget::item { padding: 6px; border-bottom: 1px solid #f0f0f0; }"
+                                 "QListWidget::item:selected { background-color: #fff3e0; color: #333333; }");
+
+        m_summary = new QLabel(this);
+        m_summary->setStyleSheet("color: #666666;");
+
+        QVBoxLayout *mainLayout = new QVBoxLayout(this);
+        mainLayout->addWidget(m_queryEdit);
+        mainLayout->addWidget(m_currentOnly);
+        mainLayout->addWidget(m_results);
+        mainLayout->addWidget(m_summary);
+
+        connect(m_queryEdit, &QLineEdit::textChanged, this, &MessageSearchDialog::updateResults);
+        connect(m_currentOnly, &QCheckBox::toggled, this, &MessageSearchDialog::updateResults);
+        connect(m_queryEdit, &QLineEdit::returnPressed, this, &MessageSearchDialog::acceptCurrent);
+        connect(m_results, &QListWidget::itemActivated, this, &MessageSearchDialog::acceptCurrent);
+
+        m_queryEdit->setFocus();
+    }
+
+    MessageSearchIndex::Hit selectedHit() const {
+        return m_selected;
+    }
+
+protected:
+    bool eventFilter(QObject *obj, QEvent *event) override {
+        // Las flechas mueven la selección sin sacar el foco del campo de texto
+        if (obj == m_queryEdit && event->type() == QEvent::KeyPress) {
+            QKeyEvent *keyEvent = static_cast<QKeyEvent *>(event);
+            const int row = m_results->currentRow();
+            if (keyEvent->key() == Qt::Key_Down && row + 1 < m_results->count()) {
+                m_results->setCurrentRow(row + 1);
+                return true;
+            }
+            if (keyEvent->key() == Qt::Key_Up && row > 0) {
+                m_results->setCurrentRow(row - 1);
+                return true;
+            }
+        }
+        return QDialog::eventFilter(obj, event);
+    }
+
+private slots:
+    void updateResults() {
+        m_results->clear();
+        m_hits = m_search(m_queryEdit->text(), m_currentOnly->isChecked());
+        for (const MessageSearchIndex::Hit &hit : std::as_const(m_hits))
+            new QListWidgetItem(m_describe(hit), m_results);
+        if (m_results->count() > 0)
+            m_results->setCurrentRow(0);
+
+        if (m_queryEdit->text().trimmed().isEmpty())
+            m_summary->clear();
+        else if (m_hits.size() >= MessageSearchIndex::DefaultLimit)
+            m_summary->setText(QString("Los %1 mensajes más recientes").arg(m_hits.size()));
+        else
+            m_summary->setText(QString("%1 mensajes").arg(m_hits.size()));
+    }
+
+    void acceptCurrent() {
+        const int row = m_results->currentRow();
+        if (row < 0 || row >= m_hits.size())
+            return;
+        m_selected = m_hits.at(row);
+        accept();
+    }
+
+private:
+    SearchFunction m_search;
+    DescribeFunction m_describe;
+    QLineEdit *m_queryEdit;
+    QCheckBox *m_currentOnly;
+    QListWidget *m_results;
+    QLabel *m_summary;
+    QList<MessageSearchIndex::Hit> m_hits;
+    MessageSearchIndex::Hit m_selected{QString(), -1};
+};
+
+#endif // MESSAGESEARCHDIALOG_H
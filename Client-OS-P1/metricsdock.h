@@ -0,0 +1,249 @@
+#ifndef METRICSDOCK_H
+#define METRICSDOCK_H
+
+#include <QCheckBox>
+#include <QDateTime>
+#include <QDockWidget>
+#include <QFileDialog>
+#include <QHBoxLayout>
+#include <QHash>
+#include <QHeaderView>
+#include <QJsonObject>
+#include <QLabel>
+#include <QLocale>
+#include <QPushButton>
+#include <QSpinBox>
+#include <QTimer>
+#include <QTreeWidget>
+#include <QVBoxLayout>
+
+#include <functional>
+
+#include "latencyhistogram.h"
+#include "metrics.h"
+
+// Panel con todas las métricas del registro de Metrics, agrupadas por tipo,
+// y exportación de la instantánea a JSON: a pedido (un documento) o cada N
+// segundos (una línea por instantánea en un archivo .jsonl).
+class MetricsDock : public QDockWidget
+{
+    Q_OBJECT
+
+public:
+    static constexpr int RefreshMs = 1000;
+    static constexpr int DefaultExportSeconds = 60;
+
+    explicit MetricsDock(QWidget *parent = nullptr)
+        : QDockWidget("Métricas", parent)
+        , m_refreshTimer(new QTimer(this))
+        , m_exportTimer(new QTimer(this))
+    {
+        setObjectName("metricsDock");
+
+        QWidget *content = new QWidget(this);
+        m_tree = new QTreeWidget(content);
+        m_tree->setColumnCount(2);
+        m_tree->setHeaderLabels({"Métrica", "Valor"});
+        m_tree->header()->setSectionResizeMode(0, QHeaderView::ResizeToContents);
+        m_tree->header()->setStretchLastSection(true);
+        m_tree->setSelectionMode(QAbstractItemView::NoSelection);
+        m_tree->setStyleSheet("QTreeWidget { border: none; background-color: #ffffff; }");
+
+        QPushButton *resetButton = new QPushButton("Reiniciar", content);
+        connect(resetButton, &QPushButton::clicked, this, [this] {
+            Metrics::reset();
+            refresh();
+        });
+
+        QPushButton *exportButton = new QPushButton("Exportar JSON…", content);
+        connect(exportButton, &QPushButton::clicked, this, &MetricsDock::exportNow);
+
+        m_autoExport = new QCheckBox("Exportar cada", content);
+        m_interval = new QSpinBox(content);
+        m_interval->setRange(1, 3600);
+        m_interval->setValue(DefaultExportSeconds);
+        m_interval->setSuffix(" s");
+        connect(m_autoExport, &QCheckBox::toggled, this, &MetricsDock::setAutoExport);
+        connect(m_interval, &QSpinBox::valueChanged, this, [this](int seconds) {
+            m_exportTimer->setInterval(seconds * 1000);
+        });
+        connect(m_exportTimer, &QTimer::timeout, this, &MetricsDock::exportTick);
+
+        m_status = new QLabel(content);
+        m_status->setStyleSheet("QLabel { color: #666666; }");
+        m_status->setWordWrap(true);
+
+        QHBoxLayout *footer = new QHBoxLayout;
+        footer->addWidget(m_autoExport);
+        footer->addWidget(m_interval);
+        footer->addStretch(1);
+        footer->addWidget(resetButton);
+        footer->addWidget(exportButton);
+
+        QVBoxLayout *layout = new QVBoxLayout(content);
+        layout->setContentsMargins(8, 8, 8, 8);
+        layout->addWidget(m_tree);
+        layout->addLayout(footer);
+        layout->addWidget(m_status);
+        setWidget(content);
+
+        // Solo se refresca mientras está a la vista; la exportación sigue igual
+        m_refreshTimer->setInterval(RefreshMs);
+        connect(m_refreshTimer, &QTimer::timeout, this, &MetricsDock::refresh);
+        connect(this, &QDockWidget::visibilityChanged, this, [this](bool visible) {
+            if (visible) {
+                refresh();
+                m_refreshTimer->start();
+            } else {
+                m_refreshTimer->stop();
+            }
+        });
+    }
+
+    // Se llama antes de cada instantánea para actualizar los medidores que
+    // no se mantienen solos (memoria por subsistema, colas de la interfaz).
+    void setSampler(std::function<void()> sampler)
+    {
+        m_sampler = std::move(sampler);
+    }
+
+    void refresh()
+    {
+        const QJsonObject snapshot = takeSnapshot();
+        const QLocale locale;
+
+        const QJsonObject counters = snapshot.value("counters").toObject();
+        for (auto it = counters.begin(); it != counters.end(); ++it)
+            setRow("Contadores", it.key(), locale.toString(it.value().toInteger()));
+
+        const QJsonObject gauges = snapshot.value("gauges").toObject();
+        for (auto it = gauges.begin(); it != gauges.end(); ++it) {
+            const qint64 value = it.value().toInteger();
+            setRow("Medidores", it.key(), it.key().startsWith("memory.")
+                   ? locale.formattedDataSize(value) : locale.toString(value));
+        }
+
+        const QJsonObject timers = snapshot.value("timers").toObject();
+        for (auto it = timers.begin(); it != timers.end(); ++it) {
+            const QJsonObject timer = it.value().toObject();
+            const qint64 count = timer.value("count").toInteger();
+            setRow("Tiempos", it.key(), count == 0 ? QString("—")
+                   : QString("p50 %1 · p99 %2 · máx %3 (%4)")
+                         .arg(LatencyHistogram::format(timer.value("p50Ns").toInteger()),
+                              LatencyHistogram::format(timer.value("p99Ns").toInteger()),
+                              LatencyHistogram::format(timer.value("maxNs").toInteger()),
+                              locale.toString(count)));
+        }
+
+        const QJsonObject traffic = snapshot.value("traffic").toObject();
+        setTraffic("Recibido", traffic.value("received").toObject(), locale);
+        setTraffic("Enviado", traffic.value("sent").toObject(), locale);
+    }
+
+private slots:
+    void exportNow()
+    {
+        const QString path = QFileDialog::getSaveFileName(this, "Exportar métricas",
+                                                          "chat-metrics-" + QDateTime::currentDateTime().toString("yyyyMMdd-hhmmss") + ".json",
+                                                          "JSON (*.json)");
+        if (path.isEmpty())
+            return;
+
+        sample();
+        m_status->setText(Metrics::writeSnapshot(path)
+                          ? "Métricas guardadas en " + path
+                          : "No se pudo escribir " + path);
+    }
+
+    void setAutoExport(bool enabled)
+    {
+        if (!enabled) {
+            m_exportTimer->stop();
+            m_status->setText(m_exportPath.isEmpty() ? QString() : "Exportación periódica detenida");
+            return;
+        }
+
+        const QString path = QFileDialog::getSaveFileName(this, "Exportar métricas periódicamente",
+                                                          m_exportPath.isEmpty() ? QString("chat-metrics.jsonl") : m_exportPath,
+                                                          "JSON Lines (*.jsonl)");
+        if (path.isEmpty()) {
+            // Sin archivo no hay exportación: se desmarca sin volver a preguntar
+            QSignalBlocker blocker(m_autoExport);
+            m_autoExport->setChecked(false);
+            return;
+        }
+
+        m_exportPath = path;
+        m_exportTimer->setInterval(m_interval->value() * 1000);
+        m_exportTimer->start();
+        exportTick();
+    }
+
+    void exportTick()
+    {
+        sample();
+        if (Metrics::appendSnapshot(m_exportPath)) {
+            m_status->setText("Última exportación a " + m_exportPath + ": "
+                              + QDateTime::currentDateTime().toString("hh:mm:ss"));
+        } else {
+            m_autoExport->setChecked(false);
+            m_status->setText("No se pudo escribir " + m_exportPath + "; exportación detenida");
+        }
+    }
+
+private:
+    void sample()
+    {
+        if (m_sampler)
+            m_sampler();
+    }
+
+    QJsonObject takeSnapshot()
+    {
+        sample();
+        return Metrics::snapshot();
+    }
+
+    void setTraffic(const QString &group, const QJsonObject &opcodes, const QLocale &locale)
+    {
+        for (auto it = opcodes.begin(); it != opcodes.end(); ++it) {
+            const QJsonObject entry = it.value().toObject();
+            setRow(group, "opcode " + it.key(),
+                   QString("%1 frames · %2").arg(locale.toString(entry.value("frames").toInteger()),
+                                                 locale.formattedDataSize(entry.value("bytes").toInteger())));
+        }
+    }
+
+    // Fila de `name` dentro de `group`; se crea la primera vez y después solo
+    // se actualiza el valor, así el árbol no pierde el desplazamiento.
+    void setRow(const QString &group, const QString &name, const QString &value)
+    {
+        const QString key = group + '/' + name;
+        QTreeWidgetItem *row = m_rows.value(key);
+        if (!row) {
+            QTreeWidgetItem *parent = m_rows.value(group);
+            if (!parent) {
+                parent = new QTreeWidgetItem(m_tree, {group});
+                parent->setFirstColumnSpanned(true);
+                parent->setExpanded(true);
+                m_rows.insert(group, parent);
+            }
+            row = new QTreeWidgetItem(parent, {name});
+            row->setTextAlignment(1, Qt::AlignRight | Qt::AlignVCenter);
+            m_rows.insert(key, row);
+        }
+        row->setText(1, value);
+    }
+
+    QTreeWidget *m_tree;
+    QHash<QString, QTreeWidgetItem *> m_rows;
+    QCheckBox *m_autoExport;
+    QSpinBox *m_interval;
+    QLabel *m_status;
+    QTimer *m_refreshTimer;
+    QTimer *m_exportTimer;
+    QString m_exportPath;
+    std::function<void()> m_sampler;
+};
+
+#endif // METRICSDOCK_H
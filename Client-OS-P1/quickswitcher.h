@@ -0,0 +1,115 @@
+#ifndef QUICKSWITCHER_H
+#define QUICKSWITCHER_H
+
+#include <QDialog>
+#include <QKeyEvent>
+#include <QLineEdit>
+#include <QListWidget>
+#include <QVBoxLayout>
+
+#include <functional>
+
+#include "rostersearchindex.h"
+
+// Selector rápido de conversaciones (Ctrl+K).
+//
+// Cada tecla consulta el índice de búsqueda a través de `search`; Enter abre
+// la conversación seleccionada (la primera, si no se movió la selección).
+class QuickSwitcher : public QDialog
+{
+    Q_OBJECT
+
+public:
+    static constexpr int MaxResults = 20;
+
+    using SearchFunction = std::function<QList<RosterSearchIndex::Match>(const QString &, int)>;
+
+    explicit QuickSwitcher(SearchFunction search, QWidget *parent = nullptr)
+        : QDialog(parent, Qt::Popup | Qt::FramelessWindowHint), m_search(std::move(search))
+    {
+        resize(360, 320);
+        setStyleSheet("QDialog {"
+                      "background-color: #ffffff;"
+                      "border: 1px solid #dddddd;"
+                      "border-radius: 6px;"
+                      "}");
+
+        m_queryEdit = new QLineEdit(this);
+        m_queryEdit->setPlaceholderText("Ir a una conversación...");
+        m_queryEdit->setStyleSheet("QLineEdit {"
+                                   "border: 1px solid #dddddd;"
+                                   "border-radius: 4px;"
+                                   "padding: 6px;"
+                                   "}");
+        m_queryEdit->installEventFilter(this);
+
+        m_results = new QListWidget(this);
+        m_results->setStyleSheet("QListWidget { border: none; }"
+                                 "QListWidget::item { padding: 6px; }"
+                                 "QListWidget::item:selected { background-color: #fff3e0; color: #333333; }");
+
+        QVBoxLayout *mainLayout = new QVBoxLayout(this);
+        mainLayout->setContentsMargins(8, 8, 8, 8);
+        mainLayout->addWidget(m_queryEdit);
+        mainLayout->addWidget(m_results);
+
+        connect(m_queryEdit, &QLineEdit::textChanged, this, &QuickSwitcher::updateResults);
+        connect(m_queryEdit, &QLineEdit::returnPressed, this, &QuickSwitcher::acceptCurrent);
+        connect(m_results, &QListWidget::itemActivated, this, &QuickSwitcher::acceptCurrent);
+
+        updateResults(QString());
+        m_queryEdit->setFocus();
+    }
+
+    // Conversación elegida: "~" para el chat general o el nombre del usuario
+    QString selectedChat() const {
+        return m_selected;
+    }
+
+protected:
+    bool eventFilter(QObject *obj, QEvent *event) override {
+        // Las flechas mueven la selección sin sacar el foco del campo de texto
+        if (obj == m_queryEdit && event->type() == QEvent::KeyPress) {
+            QKeyEvent *keyEvent = static_cast<QKeyEvent *>(event);
+            const int row = m_results->currentRow();
+            if (keyEvent->key() == Qt::Key_Down && row + 1 < m_results->count()) {
+                m_results->setCurrentRow(row + 1);
+                return true;
+            }
+            if (keyEvent->key() == Qt::Key_Up && row > 0) {
+                m_results->setCurrentRow(row - 1);
+                return true;
+            }
+        }
+        return QDialog::eventFilter(obj, event);
+    }
+
+private slots:
+    void updateResults(const QString &text) {
+        m_results->clear();
+        const QList<RosterSearchIndex::Match> matches = m_search(text, MaxResults);
+        for (const RosterSearchIndex::Match &match : matches) {
+            QListWidgetItem *item = new QListWidgetItem(match.name == "~" ? QString("General Chat") : match.name,
+                                                        m_results);
+            item->setData(Qt::UserRole, match.name);
+        }
+        if (m_results->count() > 0)
+            m_results->setCurrentRow(0);
+    }
+
+    void acceptCurrent() {
+        QListWidgetItem *item = m_results->currentItem();
+        if (!item)
+            return;
+        m_selected = item->data(Qt::UserRole).toString();
+        accept();
+    }
+
+private:
+    SearchFunction m_search;
+    QLineEdit *m_queryEdit;
+    QListWidget *m_results;
+    QString m_selected;
+};
+
+#endif // QUICKSWITCHER_H
@@ -0,0 +1,85 @@
+#include "rosterdelegate.h"
+#include "avatarcache.h"
+#include "rostermodel.h"
+
+#include <QPainter>
+
+RosterDelegate::RosterDelegate(AvatarCache *avatars, QObject *parent)
+    : QStyledItemDelegate(parent)
+    , m_avatars(avatars)
+{
+}
+
+void RosterDelegate::paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const
+{
+    const QString name = index.data(RosterModel::NameRole).toString();
+    const QString status = index.data(RosterModel::StatusRole).toString();
+    const QString lastMessage = index.data(RosterModel::LastMessageRole).toString();
+    const QRect rect = option.rect;
+
+    painter->save();
+    painter->setRenderHint(QPainter::Antialiasing);
+
+    // Fondo: los mismos colores que la hoja de estilo de la lista
+    if (option.state & QStyle::State_Selected) {
+        painter->fillRect(rect, QColor("#fff3e0"));
+        painter->fillRect(QRect(rect.left(), rect.top(), 3, rect.height()), QColor("#ff9c08"));
+    } else if (option.state & QStyle::State_MouseOver) {
+        painter->fillRect(rect, QColor("#f9f9f9"));
+    }
+
+    // Avatar
+    const QRect avatar(rect.left() + 10, rect.top() + (rect.height() - AvatarSize) / 2, AvatarSize, AvatarSize);
+    painter->drawPixmap(avatar.topLeft(), m_avatars->avatar(name, AvatarSize));
+
+    // Nombre e indicador de estado
+    const int left = avatar.right() + 12;
+    const int width = qMax(0, rect.right() - 5 - left);
+    QFont nameFont = option.font;
+    nameFont.setBold(true);
+    const QFontMetrics nameMetrics(nameFont);
+    const QString shownName = nameMetrics.elidedText(name, Qt::ElideRight, qMax(0, width - 20));
+    const QRect nameRect(left, rect.top() + 10, nameMetrics.horizontalAdvance(shownName), nameMetrics.height());
+    painter->setFont(nameFont);
+    painter->setPen(QColor("#333333"));
+    painter->drawText(nameRect, Qt::AlignLeft | Qt::AlignVCenter, shownName);
+
+    QFont statusFont = option.font;
+    statusFont.setPixelSize(12);
+    painter->setFont(statusFont);
+    painter->setPen(statusColor(status));
+    const bool known = status == "ACTIVO" || status == "OCUPADO" || status == "INACTIVO";
+    painter->drawText(QRect(nameRect.right() + 6, nameRect.top(), 14, nameRect.height()),
+                      Qt::AlignLeft | Qt::AlignVCenter, known ? QString("●") : QString("○"));
+
+    // Último mensaje, hasta dos líneas
+    QFont messageFont = option.font;
+    messageFont.setPixelSize(12);
+    painter->setFont(messageFont);
+    painter->setPen(QColor("#333333"));
+    const QRect messageRect(left, nameRect.bottom() + 3, width, rect.bottom() - 6 - nameRect.bottom());
+    painter->drawText(messageRect, Qt::AlignLeft | Qt::AlignTop | Qt::TextWordWrap, lastMessage);
+
+    // Borde inferior
+    painter->setPen(QColor("#f0f0f0"));
+    painter->drawLine(rect.left() + 10, rect.bottom(), rect.right() - 10, rect.bottom());
+
+    painter->restore();
+}
+
+QSize RosterDelegate::sizeHint(const QStyleOptionViewItem &option, const QModelIndex &index) const
+{
+    Q_UNUSED(index);
+    return QSize(option.rect.width(), RowHeight);
+}
+
+QColor RosterDelegate::statusColor(const QString &status)
+{
+    if (status == "ACTIVO")
+        return QColor("#2ecc71"); // Green
+    if (status == "OCUPADO")
+        return QColor("#e74c3c"); // Red
+    if (status == "INACTIVO")
+        return QColor("#f1c40f"); // Yellow
+    return QColor("#95a5a6");     // Gray
+}
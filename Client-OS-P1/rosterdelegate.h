@@ -0,0 +1,33 @@
+#ifndef ROSTERDELEGATE_H
+#define ROSTERDELEGATE_H
+#pragma once
+
+#include <QStyledItemDelegate>
+
+class AvatarCache;
+
+// Pinta una fila de RosterModel con el mismo aspecto que UserChatItem:
+// avatar circular con la inicial, nombre, indicador de estado y último
+// mensaje. Todas las filas miden lo mismo, así que la vista puede usar
+// uniformItemSizes y solo se pintan las visibles; el avatar sale ya pintado
+// de AvatarCache.
+class RosterDelegate : public QStyledItemDelegate
+{
+    Q_OBJECT
+
+public:
+    static constexpr int RowHeight = 70;
+    static constexpr int AvatarSize = 50;
+
+    explicit RosterDelegate(AvatarCache *avatars, QObject *parent = nullptr);
+
+    void paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const override;
+    QSize sizeHint(const QStyleOptionViewItem &option, const QModelIndex &index) const override;
+
+    static QColor statusColor(const QString &status);
+
+private:
+    AvatarCache *m_avatars;
+};
+
+#endif // ROSTERDELEGATE_H
@@ -0,0 +1,206 @@
+#include "rostermodel.h"
+
+#include <utility>
+
+RosterModel::RosterModel(QObject *parent)
+    : QAbstractListModel(parent)
+{
+}
+
+QString RosterModel::statusText(quint8 status) {
+    switch (status) {
+    case 0x00: return QStringLiteral("DESCONECTADO");
+    case 0x01: return QStringLiteral("ACTIVO");
+    case 0x02: return QStringLiteral("OCUPADO");
+    case 0x03: return QStringLiteral("INACTIVO");
+    default:   return QStringLiteral("DESCONOCIDO");
+    }
+}
+
+quint8 RosterModel::statusCode(const QString &text) {
+    const QString upper = text.trimmed().toUpper();
+    if (upper == "ACTIVO" || upper == "ACTIVE")
+        return 0x01;
+    if (upper == "OCUPADO" || upper == "BUSY")
+        return 0x02;
+    if (upper == "INACTIVO" || upper == "INACTIVE")
+        return 0x03;
+    if (upper == "DESCONECTADO" || upper == "DISCONNECTED" || upper == "OFFLINE")
+        return 0x00;
+    return 0xFF;
+}
+
+void RosterModel::reset(const QList<Entry> &entries) {
+    beginResetModel();
+    QList<Entry> previous;
+    previous.swap(m_entries);
+    const QHash<QString, int> previousIndex = std::exchange(m_index, {});
+
+    m_entries.reserve(entries.size());
+    m_index.reserve(entries.size());
+    for (const Entry &entry : entries) {
+        Entry added = entry;
+        added.serial = ++m_serial;
+        // Una resincronización no borra lo que ya se había hablado
+        const int old = previousIndex.value(entry.name, -1);
+        if (old >= 0) {
+            added.lastMessage = previous.at(old).lastMessage;
+            added.activity = previous.at(old).activity;
+        }
+        m_index.insert(added.name, int(m_entries.size()));
+        m_entries.append(added);
+    }
+
+    m_search.clear();
+    for (const Entry &entry : std::as_const(m_entries))
+        m_search.insert(entry.name);
+    endResetModel();
+}
+
+void RosterModel::upsert(const QString &name, quint8 status) {
+    const int row = find(name);
+    if (row >= 0) {
+        if (m_entries[row].status == status)
+            return;
+        m_entries[row].status = status;
+        const QModelIndex changed = index(row);
+        emit dataChanged(changed, changed, {StatusRole, StatusCodeRole});
+        return;
+    }
+
+    const int last = int(m_entries.size());
+    beginInsertRows(QModelIndex(), last, last);
+    m_entries.append(Entry{name, QStringLiteral("No messages yet"), status, 0, ++m_serial});
+    m_index.insert(name, last);
+    m_search.insert(name);
+    endInsertRows();
+}
+
+void RosterModel::remove(const QString &name) {
+    const int row = find(name);
+    if (row < 0)
+        return;
+
+    // Se quita la fila real, así las vistas y el proxy conservan la selección
+    // y los índices persistentes de las demás; las que siguen bajan una
+    // posición y se reindexan.
+    beginRemoveRows(QModelIndex(), row, row);
+    m_entries.removeAt(row);
+    m_index.remove(name);
+    m_search.remove(name);
+    for (int i = row; i < int(m_entries.size()); ++i)
+        m_index[m_entries.at(i).name] = i;
+    endRemoveRows();
+}
+
+void RosterModel::setLastMessage(const QString &name, const QString &message) {
+    const int row = find(name);
+    if (row < 0)
+        return;
+
+    m_entries[row].lastMessage = message;
+    m_entries[row].activity = ++m_clock;
+    const QModelIndex changed = index(row);
+    emit dataChanged(changed, changed, {LastMessageRole, ActivityRole});
+}
+
+void RosterModel::clear() {
+    beginResetModel();
+    m_entries.clear();
+    m_index.clear();
+    m_search.clear();
+    endResetModel();
+}
+
+int RosterModel::rowCount(const QModelIndex &parent) const {
+    return parent.isValid() ? 0 : int(m_entries.size());
+}
+
+QVariant RosterModel::data(const QModelIndex &index, int role) const {
+    if (!index.isValid() || index.row() >= m_entries.size())
+        return QVariant();
+
+    const Entry &entry = m_entries.at(index.row());
+    switch (role) {
+    case Qt::DisplayRole:
+    case NameRole:
+        return entry.name;
+    case StatusRole:
+        return statusText(entry.status);
+    case StatusCodeRole:
+        return entry.status;
+    case LastMessageRole:
+        return entry.lastMessage;
+    case ActivityRole:
+        return entry.activity;
+    case SerialRole:
+        return entry.serial;
+    default:
+        return QVariant();
+    }
+}
+
+RosterProxyModel::RosterProxyModel(QObject *parent)
+    : QSortFilterProxyModel(parent)
+{
+    setDynamicSortFilter(true);
+    sort(0);
+}
+
+void RosterProxyModel::setSourceModel(QAbstractItemModel *model) {
+    QSortFilterProxyModel::setSourceModel(model);
+
+    // Usuarios que llegan con una búsqueda activa: se vuelve a consultar
+    // el índice para saber si entran en el filtro.
+    connect(model, &QAbstractItemModel::rowsInserted, this, [this] {
+        if (!m_query.isEmpty()) {
+            refreshMatches();
+            invalidateFilter();
+        }
+    });
+    connect(model, &QAbstractItemModel::modelReset, this, [this] {
+        if (!m_query.isEmpty()) {
+            refreshMatches();
+            invalidateFilter();
+        }
+    });
+}
+
+void RosterProxyModel::setQuery(const QString &query) {
+    const QString trimmed = query.trimmed();
+    if (trimmed == m_query)
+        return;
+    m_query = trimmed;
+    refreshMatches();
+    invalidate();
+}
+
+bool RosterProxyModel::filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const {
+    Q_UNUSED(sourceParent);
+    return m_query.isEmpty() || m_scores.contains(roster()->entry(sourceRow).name);
+}
+
+bool RosterProxyModel::lessThan(const QModelIndex &left, const QModelIndex &right) const {
+    // Se lee directo del modelo: ordenar 10k filas son cientos de miles de comparaciones
+    const RosterModel::Entry &a = roster()->entry(left.row());
+    const RosterModel::Entry &b = roster()->entry(right.row());
+    if (!m_query.isEmpty()) {
+        const int scoreA = m_scores.value(a.name);
+        const int scoreB = m_scores.value(b.name);
+        if (scoreA != scoreB)
+            return scoreA > scoreB;
+    }
+    if (a.activity != b.activity)
+        return a.activity > b.activity;
+    return a.serial < b.serial;
+}
+
+void RosterProxyModel::refreshMatches() {
+    m_scores.clear();
+    if (m_query.isEmpty() || !sourceModel())
+        return;
+    const QList<RosterSearchIndex::Match> matches = roster()->searchIndex().search(m_query);
+    m_scores.reserve(matches.size());
+    for (const RosterSearchIndex::Match &match : matches)
+        m_scores.insert(match.name, match.score);
+}
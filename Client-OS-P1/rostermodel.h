@@ -0,0 +1,105 @@
+#ifndef ROSTERMODEL_H
+#define ROSTERMODEL_H
+#pragma once
+
+#include <QAbstractListModel>
+#include <QHash>
+#include <QList>
+#include <QSortFilterProxyModel>
+#include <QString>
+
+#include "rostersearchindex.h"
+
+// Usuarios de la pestaña Direct.
+//
+// Cada fila es solo el nombre, el estado (como número de protocolo) y el
+// último mensaje; RosterDelegate las pinta al vuelo, así que el costo por
+// usuario no depende de widgets ni hojas de estilo.
+//
+// Un índice nombre -> fila hace que cada evento de presencia o mensaje toque
+// solo la fila afectada. Las filas no se reordenan (una baja solo corre las
+// que la siguen); el orden por actividad lo da RosterProxyModel.
+class RosterModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    enum Roles {
+        NameRole = Qt::UserRole + 1,
+        StatusRole,         // texto: ACTIVO, OCUPADO, ...
+        StatusCodeRole,     // quint8 del protocolo
+        LastMessageRole,
+        ActivityRole,       // reloj del último mensaje, 0 si no hubo
+        SerialRole          // orden de llegada al roster
+    };
+
+    struct Entry {
+        QString name;
+        QString lastMessage;
+        quint8 status = 1;
+        quint64 activity = 0;
+        quint64 serial = 0;
+    };
+
+    explicit RosterModel(QObject *parent = nullptr);
+
+    static QString statusText(quint8 status);
+    static quint8 statusCode(const QString &text);
+
+    // Reemplaza todo el roster de una vez (respuesta del opcode 51).
+    void reset(const QList<Entry> &entries);
+    // Agrega el usuario al final o actualiza su estado en su lugar.
+    void upsert(const QString &name, quint8 status);
+    void remove(const QString &name);
+    // Guarda el último mensaje del usuario y lo marca como el más reciente.
+    void setLastMessage(const QString &name, const QString &message);
+    void clear();
+
+    // Fila del usuario, o -1.
+    int find(const QString &name) const { return m_index.value(name, -1); }
+    const Entry &entry(int row) const { return m_entries.at(row); }
+    QString name(int row) const { return m_entries.at(row).name; }
+    const RosterSearchIndex &searchIndex() const { return m_search; }
+    quint8 status(int row) const { return m_entries.at(row).status; }
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+private:
+    QList<Entry> m_entries;
+    QHash<QString, int> m_index;
+    RosterSearchIndex m_search;
+    quint64 m_clock = 0;
+    quint64 m_serial = 0;
+};
+
+// Orden de la lista Direct: primero quien habló más recientemente y, entre
+// los que no hablaron, el orden de llegada. Solo reubica las filas que
+// cambian; el modelo de origen no se reordena.
+//
+// Con una búsqueda activa solo quedan las filas que encontró el
+// RosterSearchIndex del modelo, ordenadas por puntaje.
+class RosterProxyModel : public QSortFilterProxyModel
+{
+    Q_OBJECT
+
+public:
+    explicit RosterProxyModel(QObject *parent = nullptr);
+
+    void setSourceModel(QAbstractItemModel *model) override;
+    void setQuery(const QString &query);
+    QString query() const { return m_query; }
+
+protected:
+    bool filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const override;
+    bool lessThan(const QModelIndex &left, const QModelIndex &right) const override;
+
+private:
+    const RosterModel *roster() const { return static_cast<const RosterModel *>(sourceModel()); }
+    void refreshMatches();
+
+    QString m_query;
+    QHash<QString, int> m_scores;
+};
+
+#endif // ROSTERMODEL_H
@@ -0,0 +1,13 @@
+# ConnectGate: verificación HTTP y WebSocket en cualquier orden.
+
+TEMPLATE = app
+TARGET = tst_connectgate
+CONFIG += console c++17 testcase
+CONFIG -= app_bundle
+
+QT = core network websockets testlib
+
+include(../../core/core.pri)
+
+SOURCES += \
+    tst_connectgate.cpp
@@ -0,0 +1,99 @@
+#include <QtTest>
+
+#include "connectgate.h"
+
+class TestConnectGate : public QObject {
+    Q_OBJECT
+
+private slots:
+    void cachedWaitsOnlyForSocket();
+    void checkBeforeSocket();
+    void socketBeforeCheck();
+    void confirmedBeforeCheck();
+    void takenNameIsRejected();
+    void lostBeforeCheckIsRejected();
+    void otherCodesFail();
+    void startResets();
+};
+
+void TestConnectGate::cachedWaitsOnlyForSocket() {
+    ConnectGate gate;
+    gate.start(true);
+    QCOMPARE(gate.state(), ConnectGate::Waiting);
+    QCOMPARE(gate.socketConnected(), ConnectGate::Ready);
+}
+
+void TestConnectGate::checkBeforeSocket() {
+    ConnectGate gate;
+    gate.start(false);
+    QCOMPARE(gate.nameChecked(200), ConnectGate::Waiting);
+    QCOMPARE(gate.socketConnected(), ConnectGate::Ready);
+}
+
+void TestConnectGate::socketBeforeCheck() {
+    // El servidor registró nuestro WebSocket antes de verificar: 400 por
+    // nuestra propia sesión, que la lista de usuarios confirma después
+    ConnectGate gate;
+    gate.start(false);
+    QCOMPARE(gate.socketConnected(), ConnectGate::Waiting);
+    QCOMPARE(gate.nameChecked(400), ConnectGate::Waiting);
+    QCOMPARE(gate.sessionConfirmed(), ConnectGate::Ready);
+
+    // Con 200 alcanza con el WebSocket
+    gate.start(false);
+    gate.socketConnected();
+    QCOMPARE(gate.nameChecked(204), ConnectGate::Ready);
+}
+
+void TestConnectGate::confirmedBeforeCheck() {
+    ConnectGate gate;
+    gate.start(false);
+    gate.socketConnected();
+    QCOMPARE(gate.sessionConfirmed(), ConnectGate::Waiting);
+    QCOMPARE(gate.nameChecked(400), ConnectGate::Ready);
+}
+
+void TestConnectGate::takenNameIsRejected() {
+    ConnectGate gate;
+    gate.start(false);
+    gate.socketConnected();
+    QCOMPARE(gate.nameChecked(400), ConnectGate::Waiting);
+    QCOMPARE(gate.socketLost(), ConnectGate::Rejected);
+    // Un estado final no cambia
+    QCOMPARE(gate.socketConnected(), ConnectGate::Rejected);
+    QCOMPARE(gate.sessionConfirmed(), ConnectGate::Rejected);
+}
+
+void TestConnectGate::lostBeforeCheckIsRejected() {
+    ConnectGate gate;
+    gate.start(false);
+    gate.socketConnected();
+    QCOMPARE(gate.socketLost(), ConnectGate::Waiting);
+    QCOMPARE(gate.nameChecked(400), ConnectGate::Rejected);
+
+    // Sin 400 una caída solo espera la reconexión
+    gate.start(false);
+    QCOMPARE(gate.nameChecked(200), ConnectGate::Waiting);
+    QCOMPARE(gate.socketLost(), ConnectGate::Waiting);
+    QCOMPARE(gate.socketConnected(), ConnectGate::Ready);
+}
+
+void TestConnectGate::otherCodesFail() {
+    ConnectGate gate;
+    gate.start(false);
+    gate.socketConnected();
+    QCOMPARE(gate.nameChecked(500), ConnectGate::Failed);
+    QCOMPARE(gate.sessionConfirmed(), ConnectGate::Failed);
+}
+
+void TestConnectGate::startResets() {
+    ConnectGate gate;
+    gate.start(false);
+    gate.nameChecked(500);
+    gate.start(false);
+    QCOMPARE(gate.state(), ConnectGate::Waiting);
+    QCOMPARE(gate.socketConnected(), ConnectGate::Waiting);
+}
+
+QTEST_GUILESS_MAIN(TestConnectGate)
+#include "tst_connectgate.moc"
@@ -0,0 +1,13 @@
+# ConversationStore: registros, números estables y conciliación de páginas.
+
+TEMPLATE = app
+TARGET = tst_conversationstore
+CONFIG += console c++17 testcase
+CONFIG -= app_bundle
+
+QT = core network websockets testlib
+
+include(../../core/core.pri)
+
+SOURCES += \
+    tst_conversationstore.cpp
@@ -0,0 +1,119 @@
+#include <QtTest>
+
+#include "conversationstore.h"
+
+class TestConversationStore : public QObject {
+    Q_OBJECT
+
+private slots:
+    void storesUtf8Text();
+    void sequencesSurvivePrepend();
+    void syncAppendsOnlyTheTail();
+    void syncPrependsWhenStoreIsShorter();
+    void syncKeepsUnknownTimestamps();
+    void oversizedMessageGetsOwnChunk();
+    void clearReleasesEverything();
+};
+
+void TestConversationStore::storesUtf8Text() {
+    ConversationStore store;
+    store.append("ana", LogRecord{"ana", "hola ñandú 🦜", 1000});
+    store.append("ana", LogRecord{"yo", "qué tal", 2000});
+    store.append("beto", LogRecord{"ana", "otro chat", 3000});
+
+    QCOMPARE(store.count("ana"), qsizetype(2));
+    QCOMPARE(store.count("nadie"), qsizetype(0));
+    QVERIFY(!store.contains("nadie"));
+    QCOMPARE(store.messageCount(), qsizetype(3));
+
+    const LogRecord first = store.message("ana", 0);
+    QCOMPARE(first.sender, QString("ana"));
+    QCOMPARE(first.text, QString("hola ñandú 🦜"));
+    QCOMPARE(first.timestamp, qint64(1000));
+    QCOMPARE(store.sender("ana", 1), QString("yo"));
+    QCOMPARE(store.timestamp("beto", 0), qint64(3000));
+}
+
+void TestConversationStore::sequencesSurvivePrepend() {
+    ConversationStore store;
+    store.append("ana", LogRecord{"ana", "c", 3});
+    store.append("ana", LogRecord{"ana", "d", 4});
+    const qint64 c = store.sequence("ana", 0);
+
+    store.prepend("ana", {LogRecord{"ana", "a", 1}, LogRecord{"ana", "b", 2}});
+    QCOMPARE(store.count("ana"), qsizetype(4));
+    QCOMPARE(store.indexOf("ana", c), qsizetype(2));
+    QCOMPARE(store.message("ana", 2).text, QString("c"));
+    QCOMPARE(store.message("ana", 0).text, QString("a"));
+    QCOMPARE(store.sequence("ana", 0), c - 2);
+    QCOMPARE(store.indexOf("ana", c + 10), qsizetype(-1));
+}
+
+void TestConversationStore::syncAppendsOnlyTheTail() {
+    ConversationStore store;
+    store.append("ana", LogRecord{"ana", "uno", 1});
+    store.append("ana", LogRecord{"yo", "dos", 2});
+
+    // La página repite los dos últimos y trae uno nuevo
+    const QList<LogRecord> page = {LogRecord{"ana", "uno", 0}, LogRecord{"yo", "dos", 0},
+                                   LogRecord{"ana", "tres", 0}};
+    QCOMPARE(store.sync("ana", page), qsizetype(1));
+    QCOMPARE(store.count("ana"), qsizetype(3));
+    QCOMPARE(store.message("ana", 2).text, QString("tres"));
+    QCOMPARE(store.sync("ana", {}), qsizetype(0));
+}
+
+void TestConversationStore::syncPrependsWhenStoreIsShorter() {
+    // Solo llegaron mensajes en vivo; la página trae también los anteriores
+    ConversationStore store;
+    store.append("ana", LogRecord{"ana", "a", 1});
+    store.append("ana", LogRecord{"ana", "b", 2});
+    const qint64 a = store.sequence("ana", 0);
+
+    const QList<LogRecord> page = {LogRecord{"ana", "x", 0}, LogRecord{"yo", "y", 0},
+                                   LogRecord{"ana", "a", 0}, LogRecord{"ana", "b", 0},
+                                   LogRecord{"ana", "c", 0}};
+    qsizetype prepended = -1;
+    QCOMPARE(store.sync("ana", page, &prepended), qsizetype(1));
+    QCOMPARE(prepended, qsizetype(2));
+    QCOMPARE(store.count("ana"), qsizetype(5));
+    for (qsizetype i = 0; i < page.size(); ++i)
+        QCOMPARE(store.message("ana", i).text, page[i].text);
+    QCOMPARE(store.indexOf("ana", a), qsizetype(2));
+
+    // La misma página otra vez no agrega nada en ningún extremo
+    QCOMPARE(store.sync("ana", page, &prepended), qsizetype(0));
+    QCOMPARE(prepended, qsizetype(0));
+    QCOMPARE(store.count("ana"), qsizetype(5));
+}
+
+void TestConversationStore::syncKeepsUnknownTimestamps() {
+    ConversationStore store;
+    store.sync("ana", {LogRecord{"ana", "sin hora", 0}});
+    QCOMPARE(store.timestamp("ana", 0), qint64(0));
+}
+
+void TestConversationStore::oversizedMessageGetsOwnChunk() {
+    ConversationStore store;
+    const QString big(ConversationStore::ChunkSize + 100, QChar('x'));
+    store.append("ana", LogRecord{"ana", "corto", 1});
+    store.append("ana", LogRecord{"ana", big, 2});
+    store.append("ana", LogRecord{"ana", "después", 3});
+
+    QCOMPARE(store.message("ana", 1).text, big);
+    QCOMPARE(store.message("ana", 0).text, QString("corto"));
+    QCOMPARE(store.message("ana", 2).text, QString("después"));
+    QVERIFY(store.memoryUsage() >= big.size());
+}
+
+void TestConversationStore::clearReleasesEverything() {
+    ConversationStore store;
+    store.append("ana", LogRecord{"ana", "hola", 1});
+    store.clear();
+    QCOMPARE(store.messageCount(), qsizetype(0));
+    QVERIFY(!store.contains("ana"));
+    QCOMPARE(store.memoryUsage(), qsizetype(0));
+}
+
+QTEST_GUILESS_MAIN(TestConversationStore)
+#include "tst_conversationstore.moc"
@@ -0,0 +1,13 @@
+# Fragmentation: cortes del Splitter y rearmado, orden y plazos del Reassembler.
+
+TEMPLATE = app
+TARGET = tst_fragmentation
+CONFIG += console c++17 testcase
+CONFIG -= app_bundle
+
+QT = core network websockets testlib
+
+include(../../core/core.pri)
+
+SOURCES += \
+    tst_fragmentation.cpp
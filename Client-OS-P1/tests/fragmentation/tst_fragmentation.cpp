@@ -0,0 +1,141 @@
+#include <QtTest>
+
+#include "fragmentation.h"
+
+using Fragmentation::Reassembler;
+using Fragmentation::Splitter;
+
+class TestFragmentation : public QObject {
+    Q_OBJECT
+
+private slots:
+    void splitsAtCodePoints();
+    void truncatesOversizedMessages();
+    void reassemblesInOrder();
+    void keepsSendersApart();
+    void dropsGapsAndOrphans();
+    void passesPlainText();
+    void expiresPartials();
+};
+
+namespace {
+
+// Texto de cada fragmento tal como viaja en el campo de mensaje
+QList<QByteArray> fragments(const QByteArray &utf8, quint16 id) {
+    Splitter splitter(utf8, id);
+    QList<QByteArray> out;
+    for (int i = 0; i < splitter.count(); ++i)
+        out.append(splitter.header(i).toByteArray() + splitter.chunk(i).toByteArray());
+    return out;
+}
+
+} // namespace
+
+void TestFragmentation::splitsAtCodePoints() {
+    // Con "ñ€" (5 bytes) un corte cada MaxChunk (246) cae a mitad de un carácter
+    const QByteArray text = QString("ñ€").repeated(150).toUtf8();
+    Splitter splitter(text, 7);
+    QVERIFY(splitter.count() > 1);
+    QVERIFY(!splitter.truncated());
+
+    QByteArray joined;
+    for (int i = 0; i < splitter.count(); ++i) {
+        const QByteArrayView chunk = splitter.chunk(i);
+        QVERIFY(chunk.size() <= Fragmentation::MaxChunk);
+        // Cada fragmento es UTF-8 válido por sí mismo
+        QVERIFY((quint8(chunk.front()) & 0xC0) != 0x80);
+        QCOMPARE(QString::fromUtf8(chunk).toUtf8(), chunk.toByteArray());
+        QVERIFY(Fragmentation::isFragment(splitter.header(i).toByteArray() + chunk.toByteArray()));
+        joined += chunk.toByteArray();
+    }
+    QCOMPARE(joined, text);
+}
+
+void TestFragmentation::truncatesOversizedMessages() {
+    const QByteArray text(Fragmentation::MaxMessageSize + 10, 'x');
+    Splitter splitter(text, 1);
+    QVERIFY(splitter.truncated());
+    QCOMPARE(splitter.count(), Fragmentation::MaxFragments);
+}
+
+void TestFragmentation::reassemblesInOrder() {
+    const QByteArray text = QByteArray("inicio ") + QByteArray(1000, 'a') + " fin";
+    const QList<QByteArray> parts = fragments(text, 42);
+    QCOMPARE(parts.size(), qsizetype(5));
+
+    Reassembler reassembler;
+    QByteArray message;
+    for (int i = 0; i < parts.size() - 1; ++i)
+        QCOMPARE(reassembler.feed("ana", parts[i], 0, message), Reassembler::Incomplete);
+    QCOMPARE(reassembler.pendingCount(), 1);
+    QCOMPARE(reassembler.feed("ana", parts.last(), 0, message), Reassembler::Complete);
+    QCOMPARE(message, text);
+    QCOMPARE(reassembler.pendingCount(), 0);
+    QCOMPARE(reassembler.bufferedBytes(), qsizetype(0));
+}
+
+void TestFragmentation::keepsSendersApart() {
+    // Mismo id desde dos remitentes, intercalados
+    const QByteArray a(600, 'a');
+    const QByteArray b(600, 'b');
+    const QList<QByteArray> partsA = fragments(a, 5);
+    const QList<QByteArray> partsB = fragments(b, 5);
+    QCOMPARE(partsA.size(), partsB.size());
+
+    Reassembler reassembler;
+    QByteArray message;
+    for (int i = 0; i < partsA.size() - 1; ++i) {
+        QCOMPARE(reassembler.feed("ana", partsA[i], 0, message), Reassembler::Incomplete);
+        QCOMPARE(reassembler.feed("beto", partsB[i], 0, message), Reassembler::Incomplete);
+    }
+    QCOMPARE(reassembler.feed("beto", partsB.last(), 0, message), Reassembler::Complete);
+    QCOMPARE(message, b);
+    QCOMPARE(reassembler.feed("ana", partsA.last(), 0, message), Reassembler::Complete);
+    QCOMPARE(message, a);
+}
+
+void TestFragmentation::dropsGapsAndOrphans() {
+    const QList<QByteArray> parts = fragments(QByteArray(800, 'z'), 9);
+    QCOMPARE(parts.size(), qsizetype(4));
+
+    Reassembler reassembler;
+    QByteArray message;
+    // Sin el índice 0 no hay con qué empezar
+    QCOMPARE(reassembler.feed("ana", parts[1], 0, message), Reassembler::Dropped);
+
+    // Un hueco descarta el mensaje a medias
+    QCOMPARE(reassembler.feed("ana", parts[0], 0, message), Reassembler::Incomplete);
+    QCOMPARE(reassembler.feed("ana", parts[2], 0, message), Reassembler::Dropped);
+    QCOMPARE(reassembler.pendingCount(), 0);
+    QCOMPARE(reassembler.feed("ana", parts[3], 0, message), Reassembler::Dropped);
+
+    // Cabecera con dígitos inválidos
+    QByteArray broken = parts[0];
+    broken[2] = 'G';
+    QCOMPARE(reassembler.feed("ana", broken, 0, message), Reassembler::Dropped);
+}
+
+void TestFragmentation::passesPlainText() {
+    Reassembler reassembler;
+    QByteArray message;
+    QCOMPARE(reassembler.feed("ana", "hola", 0, message), Reassembler::NotFragment);
+    // El marcador solo no alcanza: hace falta la cabecera completa
+    QCOMPARE(reassembler.feed("ana", "\x1E" "0001", 0, message), Reassembler::NotFragment);
+}
+
+void TestFragmentation::expiresPartials() {
+    const QList<QByteArray> parts = fragments(QByteArray(500, 'q'), 3);
+    Reassembler reassembler;
+    QByteArray message;
+    QCOMPARE(reassembler.feed("ana", parts[0], 1000, message), Reassembler::Incomplete);
+    QVERIFY(reassembler.bufferedBytes() > 0);
+
+    QCOMPARE(reassembler.expire(1000 + Reassembler::TimeoutMs - 1), 0);
+    QCOMPARE(reassembler.expire(1000 + Reassembler::TimeoutMs), 1);
+    QCOMPARE(reassembler.pendingCount(), 0);
+    QCOMPARE(reassembler.bufferedBytes(), qsizetype(0));
+    QCOMPARE(reassembler.feed("ana", parts[1], 1000, message), Reassembler::Dropped);
+}
+
+QTEST_GUILESS_MAIN(TestFragmentation)
+#include "tst_fragmentation.moc"
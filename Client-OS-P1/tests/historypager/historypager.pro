@@ -0,0 +1,13 @@
+# HistoryPager: cursores, generaciones y ajuste del tamaño de página.
+
+TEMPLATE = app
+TARGET = tst_historypager
+CONFIG += console c++17 testcase
+CONFIG -= app_bundle
+
+QT = core network websockets testlib
+
+include(../../core/core.pri)
+
+SOURCES += \
+    tst_historypager.cpp
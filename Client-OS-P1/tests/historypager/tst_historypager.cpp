@@ -0,0 +1,122 @@
+#include <QtTest>
+
+#include "historypager.h"
+
+class TestHistoryPager : public QObject {
+    Q_OBJECT
+
+private slots:
+    void pagesBackwardsWithCursor();
+    void oneOlderPageInFlight();
+    void ignoresStaleGenerations();
+    void clearDropsPending();
+    void growsWhenFast();
+    void shrinksWhenSlow();
+};
+
+void TestHistoryPager::pagesBackwardsWithCursor() {
+    HistoryPager pager;
+    const HistoryPager::Request first = pager.newest("ana");
+    QCOMPARE(first.chat, QString("ana"));
+    QCOMPARE(first.cursor, 0u);
+    QVERIFY(!first.older);
+
+    HistoryPager::Request request;
+    QVERIFY(!pager.older(request));   // todavía no hay cursor
+
+    HistoryPager::Request answered;
+    QVERIFY(pager.complete(true, 40, answered));
+    QVERIFY(pager.isCurrent(answered));
+    QVERIFY(pager.hasMore());
+
+    QVERIFY(pager.older(request));
+    QCOMPARE(request.cursor, 40u);
+    QVERIFY(request.older);
+    QVERIFY(pager.complete(true, 0, answered));
+    QVERIFY(answered.older);
+    QVERIFY(!pager.hasMore());
+    QVERIFY(!pager.older(request));
+}
+
+void TestHistoryPager::oneOlderPageInFlight() {
+    HistoryPager pager;
+    pager.newest("ana");
+    HistoryPager::Request answered;
+    pager.complete(true, 100, answered);
+
+    HistoryPager::Request request;
+    QVERIFY(pager.older(request));
+    QVERIFY(pager.olderInFlight());
+    QVERIFY(!pager.older(request));
+    pager.complete(true, 50, answered);
+    QVERIFY(!pager.olderInFlight());
+    QVERIFY(pager.older(request));
+    QCOMPARE(request.cursor, 50u);
+}
+
+void TestHistoryPager::ignoresStaleGenerations() {
+    HistoryPager pager;
+    pager.newest("ana");
+    pager.newest("ana");   // el usuario volvió a abrir el mismo chat
+
+    // La primera respuesta contesta la solicitud vieja: no mueve el cursor
+    HistoryPager::Request answered;
+    QVERIFY(pager.complete(true, 30, answered));
+    QVERIFY(!pager.isCurrent(answered));
+    QVERIFY(!pager.hasMore());
+
+    QVERIFY(pager.complete(true, 80, answered));
+    QVERIFY(pager.isCurrent(answered));
+    QVERIFY(pager.hasMore());
+
+    // Una página anterior pedida antes de cambiar de chat tampoco cuenta
+    HistoryPager::Request request;
+    QVERIFY(pager.older(request));
+    pager.newest("beto");
+    QVERIFY(pager.complete(true, 10, answered));
+    QCOMPARE(answered.chat, QString("ana"));
+    QVERIFY(!pager.isCurrent(answered));
+    QCOMPARE(pager.chat(), QString("beto"));
+}
+
+void TestHistoryPager::clearDropsPending() {
+    HistoryPager pager;
+    const HistoryPager::Request before = pager.newest("ana");
+    pager.clear();
+    QVERIFY(!pager.isCurrent(before));
+
+    HistoryPager::Request answered;
+    QVERIFY(!pager.complete(true, 10, answered));
+    QVERIFY(pager.chat().isEmpty());
+}
+
+void TestHistoryPager::growsWhenFast() {
+    // Una respuesta inmediata está muy por debajo de TargetRttMs / 2
+    HistoryPager pager;
+    HistoryPager::Request answered;
+    QCOMPARE(pager.pageSize(), HistoryPager::InitialPageSize);
+    QCOMPARE(int(pager.newest("ana").limit), HistoryPager::InitialPageSize);
+    pager.complete(true, 0, answered);
+    QCOMPARE(pager.pageSize(), HistoryPager::InitialPageSize * 2);
+
+    for (int i = 0; i < 4; ++i) {
+        pager.newest("ana");
+        pager.complete(true, 0, answered);
+    }
+    QCOMPARE(pager.pageSize(), HistoryPager::MaxPageSize);
+}
+
+void TestHistoryPager::shrinksWhenSlow() {
+    HistoryPager pager;
+    HistoryPager::Request answered;
+    for (int i = 0; i < 2; ++i) {
+        pager.newest("ana");
+        QTest::qSleep(int(HistoryPager::TargetRttMs) + 30);
+        pager.complete(true, 0, answered);
+    }
+    // 50 -> 25 -> 20: nunca por debajo de MinPageSize
+    QCOMPARE(pager.pageSize(), HistoryPager::MinPageSize);
+}
+
+QTEST_GUILESS_MAIN(TestHistoryPager)
+#include "tst_historypager.moc"
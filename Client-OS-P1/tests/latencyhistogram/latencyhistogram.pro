@@ -0,0 +1,13 @@
+# LatencyHistogram: cubetas, percentiles y combinación.
+
+TEMPLATE = app
+TARGET = tst_latencyhistogram
+CONFIG += console c++17 testcase
+CONFIG -= app_bundle
+
+QT = core network websockets testlib
+
+include(../../core/core.pri)
+
+SOURCES += \
+    tst_latencyhistogram.cpp
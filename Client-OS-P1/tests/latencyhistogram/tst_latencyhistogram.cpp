@@ -0,0 +1,108 @@
+#include <QtTest>
+
+#include "latencyhistogram.h"
+
+class TestLatencyHistogram : public QObject {
+    Q_OBJECT
+
+private slots:
+    void smallValuesAreExact();
+    void bucketErrorIsBounded_data();
+    void bucketErrorIsBounded();
+    void percentileEdges();
+    void clampsNegativeValues();
+    void mergeAddsCounts();
+    void formatsUnits();
+};
+
+void TestLatencyHistogram::smallValuesAreExact() {
+    // Por debajo de 2 * SubBuckets cada valor tiene su propia cubeta
+    LatencyHistogram histogram;
+    for (int value = 0; value < 2 * LatencyHistogram::SubBuckets; ++value)
+        histogram.record(value);
+
+    QCOMPARE(histogram.count(), quint64(64));
+    QCOMPARE(histogram.min(), qint64(0));
+    QCOMPARE(histogram.max(), qint64(63));
+    QCOMPARE(histogram.mean(), qint64(31));
+    QCOMPARE(histogram.percentile(50), qint64(31));
+    QCOMPARE(histogram.percentile(1), qint64(0));
+}
+
+void TestLatencyHistogram::bucketErrorIsBounded_data() {
+    QTest::addColumn<qint64>("value");
+    const qint64 values[] = {63, 64, 65, 127, 128, 129, 1000, 4095, 4096, 123456,
+                             1000000, (qint64(1) << 33) + 12345, (qint64(1) << 50) - 1};
+    for (qint64 value : values)
+        QTest::newRow(qPrintable(QString::number(value))) << value;
+}
+
+void TestLatencyHistogram::bucketErrorIsBounded() {
+    QFETCH(qint64, value);
+
+    // Con un máximo mucho mayor, el percentil devuelve el límite de la cubeta
+    LatencyHistogram histogram;
+    histogram.record(value);
+    histogram.record(qint64(1) << 60);
+    const qint64 reported = histogram.percentile(50);
+    QVERIFY2(reported >= value, qPrintable(QString::number(reported)));
+    QVERIFY2(reported <= value + value / LatencyHistogram::SubBuckets, qPrintable(QString::number(reported)));
+}
+
+void TestLatencyHistogram::percentileEdges() {
+    LatencyHistogram histogram;
+    QCOMPARE(histogram.percentile(99), qint64(0));
+
+    for (int i = 1; i <= 1000; ++i)
+        histogram.record(i * 1000);
+    QCOMPARE(histogram.percentile(100), qint64(1000000));
+    QCOMPARE(histogram.percentile(0), histogram.percentile(0.001));
+    // El percentil nunca supera el máximo registrado
+    QVERIFY(histogram.percentile(99.99) <= histogram.max());
+    const qint64 p99 = histogram.percentile(99);
+    QVERIFY(p99 >= 990000 && p99 <= 990000 + 990000 / LatencyHistogram::SubBuckets);
+}
+
+void TestLatencyHistogram::clampsNegativeValues() {
+    LatencyHistogram histogram;
+    histogram.record(-5);
+    QCOMPARE(histogram.min(), qint64(0));
+    QCOMPARE(histogram.max(), qint64(0));
+    QCOMPARE(histogram.count(), quint64(1));
+}
+
+void TestLatencyHistogram::mergeAddsCounts() {
+    LatencyHistogram a;
+    LatencyHistogram b;
+    LatencyHistogram empty;
+    a.record(10);
+    a.record(20);
+    b.record(5);
+    b.record(1000);
+
+    a.merge(empty);
+    QCOMPARE(a.count(), quint64(2));
+    a.merge(b);
+    QCOMPARE(a.count(), quint64(4));
+    QCOMPARE(a.min(), qint64(5));
+    QCOMPARE(a.max(), qint64(1000));
+    QCOMPARE(a.mean(), qint64(258));
+
+    // Combinar en uno vacío copia el mínimo del otro
+    empty.merge(b);
+    QCOMPARE(empty.min(), qint64(5));
+
+    a.reset();
+    QCOMPARE(a.count(), quint64(0));
+    QCOMPARE(a.max(), qint64(0));
+}
+
+void TestLatencyHistogram::formatsUnits() {
+    QCOMPARE(LatencyHistogram::format(850), QString("850 ns"));
+    QCOMPARE(LatencyHistogram::format(12400), QString("12.4 µs"));
+    QCOMPARE(LatencyHistogram::format(3070000), QString("3.07 ms"));
+    QCOMPARE(LatencyHistogram::format(1200000000), QString("1.20 s"));
+}
+
+QTEST_GUILESS_MAIN(TestLatencyHistogram)
+#include "tst_latencyhistogram.moc"
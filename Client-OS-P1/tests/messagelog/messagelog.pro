@@ -0,0 +1,13 @@
+# MessageLog: anexado por posición, persistencia y recuperación de segmentos.
+
+TEMPLATE = app
+TARGET = tst_messagelog
+CONFIG += console c++17 testcase
+CONFIG -= app_bundle
+
+QT = core network websockets testlib
+
+include(../../core/core.pri)
+
+SOURCES += \
+    tst_messagelog.cpp
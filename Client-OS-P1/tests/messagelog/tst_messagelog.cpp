@@ -0,0 +1,190 @@
+#include <QtTest>
+
+#include "messagelog.h"
+
+class TestMessageLog : public QObject {
+    Q_OBJECT
+
+private slots:
+    void syncAppendsByPosition();
+    void keepsRepeatedMessages();
+    void splitMessagesUseLastPosition();
+    void skipsOldPagesAndGaps();
+    void alignsUncursoredWindowByContent();
+    void keepsUnknownTimestamps();
+    void persistsRecordsAndPosition();
+    void recoversTruncatedSegment();
+    void tailReadsAcrossIndex();
+};
+
+namespace {
+
+QList<LogRecord> page(const QStringList &texts) {
+    QList<LogRecord> out;
+    for (const QString &text : texts)
+        out.append(LogRecord{"ana", text, 0});
+    return out;
+}
+
+// Posiciones consecutivas en el historial del servidor desde `first`
+QList<quint64> positions(quint64 first, qsizetype count) {
+    QList<quint64> out;
+    for (qsizetype i = 0; i < count; ++i)
+        out.append(first + quint64(i));
+    return out;
+}
+
+QStringList texts(const QList<LogRecord> &records) {
+    QStringList out;
+    for (const LogRecord &record : records)
+        out.append(record.text);
+    return out;
+}
+
+QString segmentPath(const QString &directory, const QString &conversation) {
+    return directory + '/' + QString::fromLatin1(conversation.toUtf8().toHex()) + "/00000000.log";
+}
+
+} // namespace
+
+void TestMessageLog::syncAppendsByPosition() {
+    QTemporaryDir dir;
+    MessageLog log(dir.path());
+
+    QCOMPARE(texts(log.sync("ana", page({"a", "b", "c"}), positions(0, 3))), QStringList({"a", "b", "c"}));
+    // La página más reciente se corrió uno: solo "d" es nuevo
+    QCOMPARE(texts(log.sync("ana", page({"b", "c", "d"}), positions(1, 3))), QStringList({"d"}));
+    QCOMPARE(texts(log.tail("ana", 10)), QStringList({"a", "b", "c", "d"}));
+}
+
+void TestMessageLog::keepsRepeatedMessages() {
+    // Dos mensajes iguales seguidos son dos registros, aunque coincidan
+    // con la cola del registro
+    QTemporaryDir dir;
+    MessageLog log(dir.path());
+    log.sync("ana", page({"ok"}), positions(0, 1));
+    QCOMPARE(texts(log.sync("ana", page({"ok", "ok", "ok"}), positions(0, 3))), QStringList({"ok", "ok"}));
+    QCOMPARE(log.tail("ana", 10).size(), qsizetype(3));
+}
+
+void TestMessageLog::splitMessagesUseLastPosition() {
+    // "largo" ocupó las posiciones 2 a 4 del servidor en tres fragmentos
+    QTemporaryDir dir;
+    MessageLog log(dir.path());
+    QCOMPARE(texts(log.sync("ana", page({"a", "b", "largo"}), {0, 1, 4})), QStringList({"a", "b", "largo"}));
+    QCOMPARE(texts(log.sync("ana", page({"largo", "c"}), {4, 5})), QStringList({"c"}));
+    QCOMPARE(log.tail("ana", 10).size(), qsizetype(4));
+}
+
+void TestMessageLog::skipsOldPagesAndGaps() {
+    QTemporaryDir dir;
+    MessageLog log(dir.path());
+    log.sync("ana", page({"a", "b", "c", "d"}), positions(0, 4));
+
+    // Una página que termina antes de lo registrado no agrega nada
+    QVERIFY(log.sync("ana", page({"b", "c"}), positions(1, 2)).isEmpty());
+
+    // Con un hueco se agrega todo lo que llegó
+    QCOMPARE(texts(log.sync("ana", page({"x", "y"}), positions(10, 2))), QStringList({"x", "y"}));
+    QCOMPARE(texts(log.sync("ana", page({"y", "z"}), positions(11, 2))), QStringList({"z"}));
+}
+
+void TestMessageLog::alignsUncursoredWindowByContent() {
+    // Sin cursor el servidor manda siempre los últimos 255: la ventana se
+    // corre aunque las posiciones de la página sigan siendo 0..254
+    QStringList all;
+    for (int i = 0; i < 300; ++i)
+        all.append(QString::number(i));
+
+    QTemporaryDir dir;
+    {
+        MessageLog log(dir.path());
+        QCOMPARE(log.sync("ana", page(all.mid(0, 255))).size(), qsizetype(255));
+        QCOMPARE(texts(log.sync("ana", page(all.mid(10, 255)))), all.mid(255, 10));
+        QVERIFY(log.sync("ana", page(all.mid(10, 255))).isEmpty());
+        QCOMPARE(texts(log.sync("ana", page(all.mid(45, 255)))), all.mid(265));
+    }
+
+    MessageLog reopened(dir.path());
+    QCOMPARE(texts(reopened.tail("ana", 3)), all.mid(297));
+    QVERIFY(reopened.sync("ana", page(all.mid(45, 255))).isEmpty());
+    QCOMPARE(texts(reopened.sync("ana", page({"299", "nuevo"}))), QStringList({"nuevo"}));
+}
+
+void TestMessageLog::keepsUnknownTimestamps() {
+    QTemporaryDir dir;
+    {
+        MessageLog log(dir.path());
+        log.sync("ana", {LogRecord{"ana", "sin hora", 0}, LogRecord{"ana", "con hora", 1234}}, positions(0, 2));
+        log.flush();
+    }
+    MessageLog reopened(dir.path());
+    const QList<LogRecord> tail = reopened.tail("ana", 10);
+    QCOMPARE(tail.size(), qsizetype(2));
+    QCOMPARE(tail[0].timestamp, qint64(0));
+    QCOMPARE(tail[1].timestamp, qint64(1234));
+}
+
+void TestMessageLog::persistsRecordsAndPosition() {
+    QTemporaryDir dir;
+    {
+        MessageLog log(dir.path());
+        log.sync("ana", page({"a", "b"}), positions(0, 2));
+        log.sync("~", page({"general"}), positions(40, 1));
+    }   // el destructor vacía la cola
+
+    MessageLog reopened(dir.path());
+    QCOMPARE(texts(reopened.tail("ana", 10)), QStringList({"a", "b"}));
+    QCOMPARE(texts(reopened.tail("~", 10)), QStringList({"general"}));
+    // La posición se recuerda entre sesiones
+    QCOMPARE(texts(reopened.sync("ana", page({"a", "b", "c"}), positions(0, 3))), QStringList({"c"}));
+    QVERIFY(reopened.sync("~", page({"general"}), positions(40, 1)).isEmpty());
+}
+
+void TestMessageLog::recoversTruncatedSegment() {
+    QTemporaryDir dir;
+    {
+        MessageLog log(dir.path());
+        log.sync("ana", page({"a", "b"}), positions(0, 2));
+    }
+
+    // Un cierre abrupto dejó medio registro al final del segmento
+    QFile segment(segmentPath(dir.path(), "ana"));
+    QVERIFY(segment.open(QIODevice::Append));
+    segment.write(QByteArray("\x40\x00\x00\x00\x01\x02", 6));
+    segment.close();
+
+    {
+        MessageLog log(dir.path());
+        QCOMPARE(texts(log.tail("ana", 10)), QStringList({"a", "b"}));
+        log.sync("ana", page({"a", "b", "c"}), positions(0, 3));
+    }
+
+    // El registro nuevo reemplazó los bytes truncados
+    MessageLog reopened(dir.path());
+    QCOMPARE(texts(reopened.tail("ana", 10)), QStringList({"a", "b", "c"}));
+}
+
+void TestMessageLog::tailReadsAcrossIndex() {
+    // Más registros que CacheSize y que varias entradas del índice disperso
+    const int total = MessageLog::CacheSize + 3 * MessageLog::IndexInterval + 5;
+    QStringList all;
+    for (int i = 0; i < total; ++i)
+        all.append(QString::number(i));
+
+    QTemporaryDir dir;
+    {
+        MessageLog log(dir.path());
+        log.sync("ana", page(all.mid(0, 100)), positions(0, 100));
+        log.sync("ana", page(all.mid(100)), positions(100, total - 100));
+    }
+
+    MessageLog reopened(dir.path());
+    QCOMPARE(texts(reopened.tail("ana", 3)), all.mid(total - 3));
+    QCOMPARE(texts(reopened.tail("ana", MessageLog::CacheSize)), all.mid(total - MessageLog::CacheSize));
+    QCOMPARE(reopened.sync("ana", page({QString::number(total - 1), "nuevo"}),
+                              positions(quint64(total - 1), 2)).size(), qsizetype(1));
+}
+
+QTEST_GUILESS_MAIN(TestMessageLog)
+#include "tst_messagelog.moc"
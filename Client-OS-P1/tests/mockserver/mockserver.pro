@@ -0,0 +1,13 @@
+# Integración: WebSocketClient contra un MockChatServer local.
+
+TEMPLATE = app
+TARGET = tst_mockserver
+CONFIG += console c++17 testcase
+CONFIG -= app_bundle
+
+QT = core network websockets testlib
+
+include(../../core/core.pri)
+
+SOURCES += \
+    tst_mockserver.cpp
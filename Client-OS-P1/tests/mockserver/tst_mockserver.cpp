@@ -0,0 +1,284 @@
+#include <QtTest>
+
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+
+#include "connectgate.h"
+#include "metrics.h"
+#include "mockserver.h"
+#include "websocketclient.h"
+
+class TestMockServer : public QObject {
+    Q_OBJECT
+
+private slots:
+    void deliversDirectMessages();
+    void fragmentsLongMessages();
+    void pagesHistoryAcrossSplitMessage();
+    void ignoresStaleHistoryReplies();
+    void nameCheckBeforeHandshake();
+    void nameCheckAfterHandshake();
+    void takenNameIsRejected();
+    void inflatesCompressedRosterAndHistory();
+};
+
+namespace {
+
+constexpr int TimeoutMs = 10000;
+
+bool waitConnected(WebSocketClient &client) {
+    QSignalSpy connected(&client, &WebSocketClient::connected);
+    return connected.wait(TimeoutMs) || client.isConnected();
+}
+
+// Verificación HTTP del nombre, como la hace MainWindow
+int checkName(const MockChatServer &server, const QString &name) {
+    QUrl url = server.url();
+    url.setScheme("http");
+    url.setQuery("name=" + name);
+    QNetworkAccessManager manager;
+    QNetworkReply *reply = manager.get(QNetworkRequest(url));
+    QSignalSpy finished(reply, &QNetworkReply::finished);
+    finished.wait(TimeoutMs);
+    const int code = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    delete reply;
+    return code;
+}
+
+QString shortText(int i) {
+    return QString("corto %1").arg(i);
+}
+
+// Página recibida por historyReceived u olderHistoryReceived
+struct Page {
+    int count = 0;
+    QList<HistoryEntry> entries;
+    bool hasMore = false;
+};
+
+} // namespace
+
+void TestMockServer::deliversDirectMessages() {
+    // El servidor se declara primero: los clientes se destruyen antes que él
+    MockChatServer server;
+    QVERIFY(server.listen());
+    WebSocketClient ana(server.url(), "ana");
+    QVERIFY(waitConnected(ana));
+    WebSocketClient beto(server.url(), "beto");
+    QVERIFY(waitConnected(beto));
+    QTRY_COMPARE_WITH_TIMEOUT(server.clientCount(), 2, TimeoutMs);
+
+    QSignalSpy received(&beto, &WebSocketClient::messageReceivedWithFlag);
+    ana.sendMessage("beto", "hola ñandú");
+    QTRY_COMPARE_WITH_TIMEOUT(received.size(), 1, TimeoutMs);
+    QCOMPARE(received[0][0].toString(), QString("ana"));
+    QCOMPARE(received[0][1].toString(), QString("hola ñandú"));
+    QCOMPARE(received[0][2].toBool(), false);
+}
+
+void TestMockServer::fragmentsLongMessages() {
+    // Más de 255 bytes no caben en un frame: viajan en fragmentos y llegan enteros
+    MockChatServer server;
+    QVERIFY(server.listen());
+    WebSocketClient ana(server.url(), "ana");
+    QVERIFY(waitConnected(ana));
+    WebSocketClient beto(server.url(), "beto");
+    QVERIFY(waitConnected(beto));
+    QTRY_COMPARE_WITH_TIMEOUT(server.clientCount(), 2, TimeoutMs);
+
+    QSignalSpy received(&beto, &WebSocketClient::messageReceivedWithFlag);
+    const QString text = QString("ñ").repeated(400);
+    ana.sendMessage("beto", text);
+    QTRY_COMPARE_WITH_TIMEOUT(received.size(), 1, TimeoutMs);
+    QCOMPARE(received[0][1].toString(), text);
+}
+
+void TestMockServer::pagesHistoryAcrossSplitMessage() {
+    MockChatServer server;
+    QVERIFY(server.listen());
+    WebSocketClient ana(server.url(), "ana");
+    QVERIFY(waitConnected(ana));
+    WebSocketClient beto(server.url(), "beto");
+    QVERIFY(waitConnected(beto));
+    QTRY_COMPARE_WITH_TIMEOUT(server.clientCount(), 2, TimeoutMs);
+
+    // Historial del servidor: 10 cortos (0-9), uno largo en tres fragmentos
+    // (10-12) y 48 cortos (13-60). La primera página, de 50, empieza en 11:
+    // corta el mensaje largo.
+    QSignalSpy received(&beto, &WebSocketClient::messageReceivedWithFlag);
+    const QString longText = QString("x").repeated(600);
+    for (int i = 0; i < 10; ++i)
+        ana.sendMessage("beto", shortText(i));
+    ana.sendMessage("beto", longText);
+    for (int i = 10; i < 58; ++i)
+        ana.sendMessage("beto", shortText(i));
+    QTRY_COMPARE_WITH_TIMEOUT(received.size(), 59, TimeoutMs);
+
+    Page newest;
+    Page older;
+    connect(&ana, &WebSocketClient::historyReceived, this,
+            [&newest](const QString &, const QList<HistoryEntry> &entries, bool hasMore) {
+        ++newest.count;
+        newest.entries = entries;
+        newest.hasMore = hasMore;
+    });
+    connect(&ana, &WebSocketClient::olderHistoryReceived, this,
+            [&older](const QString &, const QList<HistoryEntry> &entries, bool hasMore) {
+        ++older.count;
+        older.entries = entries;
+        older.hasMore = hasMore;
+    });
+
+    ana.getChatHistory("beto");
+    QTRY_COMPARE_WITH_TIMEOUT(newest.count, 1, TimeoutMs);
+    QVERIFY(newest.hasMore);
+    // Los dos últimos fragmentos quedan guardados para la página anterior
+    QCOMPARE(newest.entries.size(), qsizetype(48));
+    QCOMPARE(newest.entries.first().message, shortText(10));
+    QVERIFY(newest.entries.first().hasPosition);
+    QCOMPARE(newest.entries.first().position, 13u);
+    QCOMPARE(newest.entries.last().message, shortText(57));
+    QCOMPARE(newest.entries.last().position, 60u);
+
+    QVERIFY(ana.loadOlderHistory());
+    QTRY_COMPARE_WITH_TIMEOUT(older.count, 1, TimeoutMs);
+    QVERIFY(!older.hasMore);
+    QCOMPARE(older.entries.size(), qsizetype(11));
+    for (int i = 0; i < 10; ++i) {
+        QCOMPARE(older.entries[i].sender, QString("ana"));
+        QCOMPARE(older.entries[i].message, shortText(i));
+        QCOMPARE(older.entries[i].position, quint32(i));
+    }
+    // El mensaje largo se reensambla con los fragmentos guardados y lleva
+    // la posición de su último fragmento
+    QCOMPARE(older.entries[10].message, longText);
+    QCOMPARE(older.entries[10].position, 12u);
+    QVERIFY(!ana.loadOlderHistory());
+}
+
+void TestMockServer::ignoresStaleHistoryReplies() {
+    MockChatServer server;
+    QVERIFY(server.listen());
+    WebSocketClient ana(server.url(), "ana");
+    QVERIFY(waitConnected(ana));
+    WebSocketClient beto(server.url(), "beto");
+    QVERIFY(waitConnected(beto));
+    QTRY_COMPARE_WITH_TIMEOUT(server.clientCount(), 2, TimeoutMs);
+
+    QSignalSpy received(&beto, &WebSocketClient::messageReceivedWithFlag);
+    ana.sendMessage("beto", "uno");
+    QTRY_COMPARE_WITH_TIMEOUT(received.size(), 1, TimeoutMs);
+
+    // La primera respuesta llega cuando ya se pidió otra vez la página más
+    // reciente: solo se entrega la segunda
+    int pages = 0;
+    connect(&ana, &WebSocketClient::historyReceived, this,
+            [&pages](const QString &, const QList<HistoryEntry> &, bool) { ++pages; });
+    ana.getChatHistory("beto");
+    ana.getChatHistory("beto");
+    QTRY_COMPARE_WITH_TIMEOUT(pages, 1, TimeoutMs);
+    QTest::qWait(200);
+    QCOMPARE(pages, 1);
+}
+
+void TestMockServer::nameCheckBeforeHandshake() {
+    MockChatServer server;
+    QVERIFY(server.listen());
+
+    ConnectGate gate;
+    gate.start(false);
+    QCOMPARE(gate.nameChecked(checkName(server, "ana")), ConnectGate::Waiting);
+    WebSocketClient ana(server.url(), "ana");
+    QVERIFY(waitConnected(ana));
+    QCOMPARE(gate.socketConnected(), ConnectGate::Ready);
+}
+
+void TestMockServer::nameCheckAfterHandshake() {
+    // El servidor ya registró nuestro WebSocket: la verificación responde 400
+    // por nuestra propia sesión y la lista de usuarios la confirma
+    MockChatServer server;
+    QVERIFY(server.listen());
+
+    ConnectGate gate;
+    gate.start(false);
+    WebSocketClient ana(server.url(), "ana");
+    QSignalSpy users(&ana, &WebSocketClient::userListReceived);
+    QVERIFY(waitConnected(ana));
+    QCOMPARE(gate.socketConnected(), ConnectGate::Waiting);
+    QTRY_COMPARE_WITH_TIMEOUT(server.clientCount(), 1, TimeoutMs);
+
+    QCOMPARE(checkName(server, "ana"), 400);
+    QCOMPARE(gate.nameChecked(400), ConnectGate::Waiting);
+    QTRY_VERIFY_WITH_TIMEOUT(users.size() > 0, TimeoutMs);
+    QCOMPARE(gate.sessionConfirmed(), ConnectGate::Ready);
+}
+
+void TestMockServer::takenNameIsRejected() {
+    // Otro ya usa el nombre: el servidor cierra nuestro WebSocket, llegue
+    // antes o después el 400 de la verificación
+    MockChatServer server;
+    QVERIFY(server.listen());
+    WebSocketClient ana(server.url(), "ana");
+    QVERIFY(waitConnected(ana));
+    QTRY_COMPARE_WITH_TIMEOUT(server.clientCount(), 1, TimeoutMs);
+
+    ConnectGate gate;
+    gate.start(false);
+    WebSocketClient impostor(server.url(), "ana");
+    connect(&impostor, &WebSocketClient::connected, this, [&gate] { gate.socketConnected(); });
+    connect(&impostor, &WebSocketClient::reconnecting, this, [&gate] { gate.socketLost(); });
+    QSignalSpy lost(&impostor, &WebSocketClient::reconnecting);
+
+    gate.nameChecked(checkName(server, "ana"));
+    QTRY_VERIFY_WITH_TIMEOUT(lost.size() > 0, TimeoutMs);
+    QCOMPARE(gate.state(), ConnectGate::Rejected);
+    QCOMPARE(server.clientCount(), 1);
+}
+
+void TestMockServer::inflatesCompressedRosterAndHistory() {
+    // El cliente siempre pide compress=zlib; el servidor envuelve 51 y 56 en 57
+    MockServerConfig config;
+    config.compression = true;
+    config.rosterSize = 100;
+    MockChatServer server(config);
+    QVERIFY(server.listen());
+    const quint64 inflatedBefore = Metrics::counter("compression.inflatedBytes").value();
+
+    WebSocketClient ana(server.url(), "ana");
+    QSignalSpy users(&ana, &WebSocketClient::userListReceived);
+    QVERIFY(waitConnected(ana));
+    WebSocketClient beto(server.url(), "beto");
+    QVERIFY(waitConnected(beto));
+    QTRY_COMPARE_WITH_TIMEOUT(server.clientCount(), 2, TimeoutMs);
+
+    QTRY_VERIFY_WITH_TIMEOUT(users.size() > 0, TimeoutMs);
+    const QStringList roster = users.first().at(0).toStringList();
+    QCOMPARE(roster.filter(QRegularExpression("^bot-\\d+ \\(")).size(), qsizetype(100));
+
+    QSignalSpy received(&beto, &WebSocketClient::messageReceivedWithFlag);
+    for (int i = 0; i < 20; ++i)
+        ana.sendMessage("beto", shortText(i));
+    QTRY_COMPARE_WITH_TIMEOUT(received.size(), 20, TimeoutMs);
+
+    Page page;
+    connect(&ana, &WebSocketClient::historyReceived, this,
+            [&page](const QString &, const QList<HistoryEntry> &entries, bool) {
+        ++page.count;
+        page.entries = entries;
+    });
+    ana.getChatHistory("beto");
+    QTRY_COMPARE_WITH_TIMEOUT(page.count, 1, TimeoutMs);
+    QCOMPARE(page.entries.size(), qsizetype(20));
+    for (int i = 0; i < 20; ++i)
+        QCOMPARE(page.entries[i].message, shortText(i));
+
+    // Al menos la lista y la página llegaron comprimidas
+    const WebSocketClient::CompressionStats stats = ana.compressionStats();
+    QVERIFY(stats.frames >= 2);
+    QVERIFY(stats.inflatedBytes > 0);
+    QVERIFY(stats.ratio() > 0.0);
+    QVERIFY(Metrics::counter("compression.inflatedBytes").value() > inflatedBefore);
+}
+
+QTEST_GUILESS_MAIN(TestMockServer)
+#include "tst_mockserver.moc"
@@ -0,0 +1,13 @@
+# Protocol: límites de FrameReader, decodificadores, FrameBuilder e inflateFrame.
+
+TEMPLATE = app
+TARGET = tst_protocolcodec
+CONFIG += console c++17 testcase
+CONFIG -= app_bundle
+
+QT = core network websockets testlib
+
+include(../../core/core.pri)
+
+SOURCES += \
+    tst_protocolcodec.cpp
@@ -0,0 +1,210 @@
+#include <QtTest>
+
+#include "protocolcodec.h"
+
+using namespace Protocol;
+
+class TestProtocolCodec : public QObject {
+    Q_OBJECT
+
+private slots:
+    void readerRejectsShortReads();
+    void decodeMessage();
+    void decodeRejectsEveryTruncation_data();
+    void decodeRejectsEveryTruncation();
+    void decodeRejectsWrongOpcode();
+    void decodeUserListCountBeyondData();
+    void decodeHistoryCursor();
+    void builderCutsAtUtf8Boundary();
+    void builderHistoryPage();
+    void inflateRoundTrip();
+    void inflateRejectsHostileSizes();
+    void inflateRejectsNestedFrames();
+};
+
+namespace {
+
+QByteArray compressed(const QByteArray &frame) {
+    // [57][tamaño u32 BE][zlib]: qCompress ya antepone el tamaño
+    return char(Compressed) + qCompress(frame);
+}
+
+} // namespace
+
+void TestProtocolCodec::readerRejectsShortReads() {
+    FrameReader empty(QByteArrayView{});
+    quint8 byte = 0;
+    QVERIFY(!empty.readU8(byte));
+    QVERIFY(empty.atEnd());
+
+    // Una lectura que falla no avanza el cursor
+    const QByteArray three("\x01\x02\x03", 3);
+    FrameReader in(three);
+    quint32 word = 0;
+    QVERIFY(!in.readU32(word));
+    QCOMPARE(in.remaining(), qsizetype(3));
+
+    const QByteArray declared("\x05" "abc", 4);
+    FrameReader strings(declared);
+    QByteArrayView text;
+    QVERIFY(!strings.readString8(text));
+    QCOMPARE(strings.remaining(), qsizetype(4));
+
+    const QByteArray exact("\x00\x00\x01\x00" "\x02" "ok", 7);
+    FrameReader ok(exact);
+    QVERIFY(ok.readU32(word));
+    QCOMPARE(word, 256u);
+    QVERIFY(ok.readString8(text));
+    QCOMPARE(text.toByteArray(), QByteArray("ok"));
+    QVERIFY(ok.atEnd());
+}
+
+void TestProtocolCodec::decodeMessage() {
+    const QByteArray frame = FrameWriter(ChatMessage).string8("ana").string8("hola ñandú").data();
+    MessageFrame message;
+    QVERIFY(Protocol::decodeMessage(frame, message));
+    QCOMPARE(toString(message.sender), QString("ana"));
+    QCOMPARE(toString(message.text), QString("hola ñandú"));
+}
+
+void TestProtocolCodec::decodeRejectsEveryTruncation_data() {
+    QTest::addColumn<QByteArray>("frame");
+    QTest::newRow("50") << FrameWriter(Error).u8(3).data();
+    QTest::newRow("51") << FrameWriter(UserList).u8(2).string8("ana").u8(1).string8("beto").u8(2).data();
+    QTest::newRow("52") << FrameWriter(UserInfo).string8("ana").u8(1).data();
+    QTest::newRow("53") << FrameWriter(UserConnected).string8("ana").data();
+    QTest::newRow("54") << FrameWriter(StatusChange).string8("ana").u8(3).data();
+    QTest::newRow("55") << FrameWriter(ChatMessage).string8("ana").string8("hola").data();
+    QTest::newRow("56") << FrameWriter(ChatHistory).u8(2).string8("ana").string8("a")
+                                                    .string8("beto").string8("b").data();
+}
+
+void TestProtocolCodec::decodeRejectsEveryTruncation() {
+    QFETCH(QByteArray, frame);
+
+    auto decode = [](QByteArrayView data) {
+        switch (opcodeOf(data)) {
+        case Error:         { ErrorFrame out; return decodeError(data, out); }
+        case UserList:      { UserListFrame out; return decodeUserList(data, out); }
+        case UserInfo:      { UserInfoFrame out; return decodeUserInfo(data, out); }
+        case UserConnected: { UserConnectedFrame out; return decodeUserConnected(data, out); }
+        case StatusChange:  { StatusChangeFrame out; return decodeStatusChange(data, out); }
+        case ChatMessage:   { MessageFrame out; return Protocol::decodeMessage(data, out); }
+        case ChatHistory:   { HistoryFrame out; return decodeHistory(data, out); }
+        default:            return false;
+        }
+    };
+
+    QVERIFY(decode(frame));
+    for (qsizetype length = 1; length < frame.size(); ++length)
+        QVERIFY2(!decode(QByteArrayView(frame).first(length)), qPrintable(QString::number(length)));
+}
+
+void TestProtocolCodec::decodeRejectsWrongOpcode() {
+    const QByteArray frame = FrameWriter(UserInfo).string8("ana").u8(1).data();
+    StatusChangeFrame status;
+    QVERIFY(!decodeStatusChange(frame, status));
+    ErrorFrame error;
+    QVERIFY(!decodeError(QByteArrayView{}, error));
+}
+
+void TestProtocolCodec::decodeUserListCountBeyondData() {
+    // Declara 200 usuarios pero trae uno: se descarta sin recorrerlo
+    const QByteArray frame = FrameWriter(UserList).u8(200).string8("ana").u8(1).data();
+    UserListFrame list;
+    QVERIFY(!decodeUserList(frame, list));
+
+    const QByteArray valid = FrameWriter(UserList).u8(1).string8("ana").u8(2).data();
+    QVERIFY(decodeUserList(valid, list));
+    QCOMPARE(list.users.size(), qsizetype(1));
+    QCOMPARE(toString(list.users[0].name), QString("ana"));
+    QCOMPARE(list.users[0].status, quint8(2));
+}
+
+void TestProtocolCodec::decodeHistoryCursor() {
+    HistoryFrame history;
+    const QByteArray plain = FrameWriter(ChatHistory).u8(1).string8("ana").string8("a").data();
+    QVERIFY(decodeHistory(plain, history));
+    QVERIFY(!history.hasCursor);
+    QCOMPARE(history.nextCursor, 0u);
+
+    const QByteArray paged = FrameWriter(ChatHistory).u8(1).string8("ana").string8("a").u32(70000).data();
+    QVERIFY(decodeHistory(paged, history));
+    QVERIFY(history.hasCursor);
+    QCOMPARE(history.nextCursor, 70000u);
+    QCOMPARE(history.messages.size(), qsizetype(1));
+
+    // Un cursor incompleto es un servidor sin paginación con basura al final
+    const QByteArray partial = plain + QByteArray("\x00\x01", 2);
+    QVERIFY(decodeHistory(partial, history));
+    QVERIFY(!history.hasCursor);
+}
+
+void TestProtocolCodec::builderCutsAtUtf8Boundary() {
+    // 200 × "ñ" son 400 bytes: el campo se corta en 254, no a mitad de un carácter
+    FrameBuilder builder;
+    const QByteArray frame = builder.sendMessage(u"ana", QString(200, QChar(0x00F1)));
+
+    FrameReader in(frame);
+    quint8 opcode = 0;
+    QByteArrayView recipient, text;
+    QVERIFY(in.readU8(opcode) && in.readString8(recipient) && in.readString8(text));
+    QCOMPARE(opcode, quint8(SendChatMessage));
+    QCOMPARE(recipient.toByteArray(), QByteArray("ana"));
+    QCOMPARE(text.size(), qsizetype(254));
+    QCOMPARE(toString(text), QString(127, QChar(0x00F1)));
+    QVERIFY(in.atEnd());
+}
+
+void TestProtocolCodec::builderHistoryPage() {
+    FrameBuilder builder;
+    const QByteArray frame = builder.getHistoryPage(u"~", 0x01020304, 50);
+    QCOMPARE(frame, QByteArray("\x05\x01~\x01\x02\x03\x04\x32", 8));
+}
+
+void TestProtocolCodec::inflateRoundTrip() {
+    FrameWriter writer(ChatHistory);
+    writer.u8(100);
+    for (int i = 0; i < 100; ++i)
+        writer.string8("ana").string8("mensaje repetido para comprimir");
+    const QByteArray original = writer.data();
+
+    QByteArray inflated;
+    QVERIFY(inflateFrame(compressed(original), inflated));
+    QCOMPARE(inflated, original);
+}
+
+void TestProtocolCodec::inflateRejectsHostileSizes() {
+    const QByteArray frame = compressed(FrameWriter(UserInfo).string8("ana").u8(1).data());
+    QByteArray out;
+
+    // Tamaño declarado por encima de MaxInflatedSize: no se reserva nada
+    QByteArray huge = frame;
+    const quint32 tooBig = quint32(MaxInflatedSize) + 1;
+    huge[1] = char(tooBig >> 24);
+    huge[2] = char(tooBig >> 16);
+    huge[3] = char(tooBig >> 8);
+    huge[4] = char(tooBig);
+    QVERIFY(!inflateFrame(huge, out));
+
+    QByteArray zero = frame;
+    zero[1] = zero[2] = zero[3] = zero[4] = 0;
+    QVERIFY(!inflateFrame(zero, out));
+
+    // Tamaño declarado que no coincide con lo descomprimido
+    QByteArray wrong = frame;
+    wrong[4] = char(quint8(wrong[4]) + 1);
+    QVERIFY(!inflateFrame(wrong, out));
+
+    QVERIFY(!inflateFrame(frame.first(4), out));
+    QVERIFY(!inflateFrame(QByteArray(1, char(Compressed)), out));
+}
+
+void TestProtocolCodec::inflateRejectsNestedFrames() {
+    const QByteArray inner = compressed(FrameWriter(UserInfo).string8("ana").u8(1).data());
+    QByteArray out;
+    QVERIFY(!inflateFrame(compressed(inner), out));
+}
+
+QTEST_GUILESS_MAIN(TestProtocolCodec)
+#include "tst_protocolcodec.moc"
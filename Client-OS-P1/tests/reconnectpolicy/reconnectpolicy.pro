@@ -0,0 +1,13 @@
+# ReconnectPolicy: límites del backoff y reinicio de la serie.
+
+TEMPLATE = app
+TARGET = tst_reconnectpolicy
+CONFIG += console c++17 testcase
+CONFIG -= app_bundle
+
+QT = core network websockets testlib
+
+include(../../core/core.pri)
+
+SOURCES += \
+    tst_reconnectpolicy.cpp
@@ -0,0 +1,65 @@
+#include <QtTest>
+
+#include "reconnectpolicy.h"
+
+class TestReconnectPolicy : public QObject {
+    Q_OBJECT
+
+private slots:
+    void delaysStayUnderCeiling();
+    void sameSeedSameSeries();
+    void jitterSpreadsClients();
+    void quickDropKeepsGrowing();
+    void resetRestartsSeries();
+};
+
+void TestReconnectPolicy::delaysStayUnderCeiling() {
+    ReconnectPolicy policy(1);
+    for (int attempt = 0; attempt < 40; ++attempt) {
+        const qint64 ceiling = qMin(ReconnectPolicy::MaxDelayMs, ReconnectPolicy::BaseDelayMs << qMin(attempt, 16));
+        const qint64 delay = policy.nextDelayMs();
+        QVERIFY2(delay >= 0 && delay <= ceiling, qPrintable(QString("%1: %2").arg(attempt).arg(delay)));
+        QCOMPARE(policy.attempts(), attempt + 1);
+    }
+}
+
+void TestReconnectPolicy::sameSeedSameSeries() {
+    ReconnectPolicy a(42);
+    ReconnectPolicy b(42);
+    for (int i = 0; i < 10; ++i)
+        QCOMPARE(a.nextDelayMs(), b.nextDelayMs());
+}
+
+void TestReconnectPolicy::jitterSpreadsClients() {
+    // Muchos clientes que cayeron juntos no eligen todos la misma espera
+    QSet<qint64> delays;
+    for (quint32 seed = 1; seed <= 50; ++seed) {
+        ReconnectPolicy policy(seed);
+        for (int i = 0; i < 5; ++i)
+            policy.nextDelayMs();
+        delays.insert(policy.nextDelayMs());
+    }
+    QVERIFY(delays.size() > 25);
+}
+
+void TestReconnectPolicy::quickDropKeepsGrowing() {
+    // Una conexión que se cae antes de StableAfterMs no reinicia la serie
+    ReconnectPolicy policy(7);
+    policy.nextDelayMs();
+    policy.nextDelayMs();
+    policy.connected();
+    policy.nextDelayMs();
+    QCOMPARE(policy.attempts(), 3);
+}
+
+void TestReconnectPolicy::resetRestartsSeries() {
+    ReconnectPolicy policy(7);
+    for (int i = 0; i < 8; ++i)
+        policy.nextDelayMs();
+    policy.reset();
+    QCOMPARE(policy.attempts(), 0);
+    QVERIFY(policy.nextDelayMs() <= ReconnectPolicy::BaseDelayMs);
+}
+
+QTEST_GUILESS_MAIN(TestReconnectPolicy)
+#include "tst_reconnectpolicy.moc"
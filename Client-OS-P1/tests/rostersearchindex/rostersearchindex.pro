@@ -0,0 +1,13 @@
+# RosterSearchIndex: puntajes, búsquedas cortas y compactación.
+
+TEMPLATE = app
+TARGET = tst_rostersearchindex
+CONFIG += console c++17 testcase
+CONFIG -= app_bundle
+
+QT = core network websockets testlib
+
+include(../../core/core.pri)
+
+SOURCES += \
+    tst_rostersearchindex.cpp
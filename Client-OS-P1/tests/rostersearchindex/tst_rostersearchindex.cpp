@@ -0,0 +1,114 @@
+#include <QtTest>
+
+#include "rostersearchindex.h"
+
+class TestRosterSearchIndex : public QObject {
+    Q_OBJECT
+
+private slots:
+    void ranksPrefixSubstringSubsequence();
+    void shortQueriesScanBuffer();
+    void foldsCase();
+    void prefersWordBoundaries();
+    void respectsLimit();
+    void removeHidesNames();
+    void compactsAfterManyRemovals();
+};
+
+namespace {
+
+QStringList names(const QList<RosterSearchIndex::Match> &matches) {
+    QStringList out;
+    for (const RosterSearchIndex::Match &match : matches)
+        out.append(match.name);
+    return out;
+}
+
+} // namespace
+
+void TestRosterSearchIndex::ranksPrefixSubstringSubsequence() {
+    RosterSearchIndex index;
+    for (const char *name : {"axnxa", "mariana", "anabel", "ana", "pedro"})
+        index.insert(name);
+
+    const QList<RosterSearchIndex::Match> matches = index.search("ana");
+    QCOMPARE(names(matches), QStringList({"ana", "anabel", "mariana", "axnxa"}));
+    for (qsizetype i = 1; i < matches.size(); ++i)
+        QVERIFY(matches[i - 1].score > matches[i].score);
+}
+
+void TestRosterSearchIndex::shortQueriesScanBuffer() {
+    // Menos de tres caracteres: sin trigramas, una pasada por el búfer
+    RosterSearchIndex index;
+    for (const char *name : {"ana", "juan", "beto", "luana"})
+        index.insert(name);
+
+    const QStringList found = names(index.search("an"));
+    QCOMPARE(found.first(), QString("ana"));
+    QVERIFY(found.contains("juan"));
+    QVERIFY(found.contains("luana"));
+    QVERIFY(!found.contains("beto"));
+}
+
+void TestRosterSearchIndex::foldsCase() {
+    RosterSearchIndex index;
+    index.insert("Ñandú_Pérez");
+    const QList<RosterSearchIndex::Match> matches = index.search("ÑANDÚ");
+    QCOMPARE(matches.size(), qsizetype(1));
+    QCOMPARE(matches[0].name, QString("Ñandú_Pérez"));
+}
+
+void TestRosterSearchIndex::prefersWordBoundaries() {
+    RosterSearchIndex index;
+    index.insert("juan_perez");
+    index.insert("juanperezz");
+    const QStringList found = names(index.search("perez"));
+    QCOMPARE(found.first(), QString("juan_perez"));
+}
+
+void TestRosterSearchIndex::respectsLimit() {
+    RosterSearchIndex index;
+    for (int i = 0; i < 50; ++i)
+        index.insert(QString("bot-%1").arg(i));
+    QCOMPARE(index.search("bot", 10).size(), qsizetype(10));
+    QCOMPARE(index.search("bot").size(), qsizetype(50));
+}
+
+void TestRosterSearchIndex::removeHidesNames() {
+    RosterSearchIndex index;
+    index.insert("ana");
+    index.insert("anabel");
+    index.remove("ana");
+    QVERIFY(!index.contains("ana"));
+    QCOMPARE(names(index.search("ana")), QStringList({"anabel"}));
+    QCOMPARE(names(index.search("an")), QStringList({"anabel"}));
+
+    index.insert("ana");
+    QCOMPARE(names(index.search("ana")), QStringList({"ana", "anabel"}));
+}
+
+void TestRosterSearchIndex::compactsAfterManyRemovals() {
+    RosterSearchIndex index;
+    for (int i = 0; i < 200; ++i)
+        index.insert(QString("usuario-%1").arg(i, 3, 10, QLatin1Char('0')));
+    const qsizetype full = index.memoryUsage();
+
+    // Más de 64 bajas y más bajas que vivos: el índice se reconstruye
+    for (int i = 0; i < 150; ++i)
+        index.remove(QString("usuario-%1").arg(i, 3, 10, QLatin1Char('0')));
+    QCOMPARE(index.size(), 50);
+    QVERIFY(index.memoryUsage() < full);
+
+    const QStringList found = names(index.search("usuario", -1));
+    QCOMPARE(found.size(), qsizetype(50));
+    QCOMPARE(found.first(), QString("usuario-150"));
+    QVERIFY(!names(index.search("usuario-149")).contains("usuario-149"));
+    // Las subcadenas exactas van antes que los parecidos por trigramas
+    QStringList nineties;
+    for (int i = 190; i < 200; ++i)
+        nineties.append(QString("usuario-%1").arg(i));
+    QCOMPARE(names(index.search("suario-19", 10)), nineties);
+}
+
+QTEST_GUILESS_MAIN(TestRosterSearchIndex)
+#include "tst_rostersearchindex.moc"
@@ -0,0 +1,16 @@
+# Pruebas de chatcore con QtTest. Cada subdirectorio es un ejecutable
+# independiente; `make check` los compila y los corre todos.
+
+TEMPLATE = subdirs
+
+SUBDIRS += \
+    connectgate \
+    conversationstore \
+    fragmentation \
+    historypager \
+    latencyhistogram \
+    messagelog \
+    mockserver \
+    protocolcodec \
+    reconnectpolicy \
+    rostersearchindex
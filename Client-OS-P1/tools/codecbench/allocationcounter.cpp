@@ -0,0 +1,56 @@
+#include "allocationcounter.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+
+namespace {
+
+std::atomic<quint64> allocations{0};
+
+} // namespace
+
+#if defined(__GLIBC__)
+
+// El ejecutable define estos símbolos antes que libc, así que todas las
+// bibliotecas (Qt incluida) reservan a través de ellos.
+extern "C" {
+
+void *__libc_malloc(std::size_t size);
+void *__libc_calloc(std::size_t count, std::size_t size);
+void *__libc_realloc(void *pointer, std::size_t size);
+
+void *malloc(std::size_t size) noexcept {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_malloc(size);
+}
+
+void *calloc(std::size_t count, std::size_t size) noexcept {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_calloc(count, size);
+}
+
+void *realloc(void *pointer, std::size_t size) noexcept {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_realloc(pointer, size);
+}
+
+} // extern "C"
+
+#endif
+
+namespace AllocationCounter {
+
+bool supported() {
+#if defined(__GLIBC__)
+    return true;
+#else
+    return false;
+#endif
+}
+
+quint64 count() {
+    return allocations.load(std::memory_order_relaxed);
+}
+
+} // namespace AllocationCounter
@@ -0,0 +1,19 @@
+#ifndef ALLOCATIONCOUNTER_H
+#define ALLOCATIONCOUNTER_H
+#pragma once
+
+#include <QtGlobal>
+
+// Cuenta las reservas de memoria de todo el proceso.
+//
+// En glibc se interceptan malloc, calloc y realloc, que es por donde pasan
+// tanto operator new como los contenedores de Qt. En otras plataformas no
+// hay conteo y supported() devuelve false.
+namespace AllocationCounter {
+
+bool supported();
+quint64 count();
+
+} // namespace AllocationCounter
+
+#endif // ALLOCATIONCOUNTER_H
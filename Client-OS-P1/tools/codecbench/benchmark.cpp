@@ -0,0 +1,77 @@
+#include "benchmark.h"
+
+#include <QElapsedTimer>
+
+#include <algorithm>
+#include <vector>
+
+#include "allocationcounter.h"
+
+namespace {
+
+constexpr int WarmupIterations = 16;
+constexpr quint64 MaxIterations = quint64(1) << 30;
+
+volatile quint64 sink = 0;
+
+qint64 timeBatch(const BenchCase &benchCase, quint64 iterations) {
+    quint64 accumulated = 0;
+    QElapsedTimer timer;
+    timer.start();
+    for (quint64 i = 0; i < iterations; ++i)
+        accumulated += benchCase.run();
+    const qint64 elapsed = timer.nsecsElapsed();
+    sink = sink + accumulated;
+    return elapsed;
+}
+
+} // namespace
+
+QString BenchCase::name() const {
+    return QStringLiteral("%1/%2/%3/%4/%5").arg(direction).arg(opcode).arg(payload, script, path);
+}
+
+QJsonObject BenchResult::toJson(const BenchCase &benchCase) const {
+    QJsonObject object;
+    object["name"] = benchCase.name();
+    object["direction"] = benchCase.direction;
+    object["opcode"] = benchCase.opcode;
+    object["payload"] = benchCase.payload;
+    object["script"] = benchCase.script;
+    object["path"] = benchCase.path;
+    object["bytes"] = qint64(benchCase.bytes);
+    object["iterations"] = qint64(iterations);
+    object["nsPerOp"] = nsPerOp;
+    object["minNsPerOp"] = minNsPerOp;
+    object["opsPerSecond"] = opsPerSecond();
+    object["megabytesPerSecond"] = double(benchCase.bytes) * opsPerSecond() / 1e6;
+    object["allocsPerOp"] = allocsPerOp >= 0.0 ? QJsonValue(allocsPerOp) : QJsonValue();
+    return object;
+}
+
+BenchResult runBenchmark(const BenchCase &benchCase, const BenchSettings &settings) {
+    BenchResult result;
+    timeBatch(benchCase, WarmupIterations);
+
+    // Se duplica hasta que una tanda dure lo suficiente para el reloj
+    quint64 iterations = 1;
+    while (iterations < MaxIterations && timeBatch(benchCase, iterations) < settings.minSampleNs)
+        iterations *= 2;
+    result.iterations = iterations;
+
+    std::vector<double> samples;
+    samples.reserve(std::size_t(settings.samples));
+    for (int i = 0; i < settings.samples; ++i)
+        samples.push_back(double(timeBatch(benchCase, iterations)) / double(iterations));
+    std::sort(samples.begin(), samples.end());
+    result.nsPerOp = samples[samples.size() / 2];
+    result.minNsPerOp = samples.front();
+
+    // El conteo va aparte para no mezclarlo con los tiempos
+    if (AllocationCounter::supported()) {
+        const quint64 before = AllocationCounter::count();
+        timeBatch(benchCase, iterations);
+        result.allocsPerOp = double(AllocationCounter::count() - before) / double(iterations);
+    }
+    return result;
+}
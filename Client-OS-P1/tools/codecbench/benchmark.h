@@ -0,0 +1,47 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+#pragma once
+
+#include <QJsonObject>
+#include <QList>
+#include <QString>
+
+#include <functional>
+
+// Un caso: una operación de codificación o decodificación de un opcode con
+// un tamaño, un alfabeto y una implementación dados.
+struct BenchCase {
+    QString direction;      // "encode" | "decode"
+    int opcode = 0;
+    QString payload;        // tamaño de la entrada, p. ej. "255 users"
+    QString script;         // "ascii" | "multilingual" | "emoji" | "-"
+    QString path;           // "legacy" | "protocol" | "protocol+strings"
+    qsizetype bytes = 0;    // bytes del frame por operación
+    // Una operación; el valor devuelto se acumula para que no se optimice.
+    std::function<quint64()> run;
+
+    QString name() const;
+};
+
+struct BenchSettings {
+    int samples = 9;
+    qint64 minSampleNs = 20 * 1000 * 1000;
+};
+
+struct BenchResult {
+    quint64 iterations = 0;     // por muestra
+    double nsPerOp = 0.0;       // mediana de las muestras
+    double minNsPerOp = 0.0;
+    double allocsPerOp = -1.0;  // -1 si no se pueden contar
+
+    double opsPerSecond() const { return nsPerOp > 0.0 ? 1e9 / nsPerOp : 0.0; }
+    QJsonObject toJson(const BenchCase &benchCase) const;
+};
+
+// Calienta, calibra el número de iteraciones para que cada muestra dure al
+// menos minSampleNs, toma las muestras y cuenta reservas en una tanda aparte.
+BenchResult runBenchmark(const BenchCase &benchCase, const BenchSettings &settings);
+
+QList<BenchCase> codecCases();
+
+#endif // BENCHMARK_H
@@ -0,0 +1,27 @@
+# Benchmark del codec: cada opcode con el codec original (QDataStream) y con
+# el de chatcore, en ASCII, texto multilingüe y emoji.
+
+TEMPLATE = app
+TARGET = codecbench
+CONFIG += console c++17
+CONFIG -= app_bundle
+
+QT = core network websockets
+
+CONFIG(release, debug|release): DEFINES += QT_NO_DEBUG_OUTPUT
+
+include(../../core/core.pri)
+
+SOURCES += \
+    allocationcounter.cpp \
+    benchmark.cpp \
+    codeccases.cpp \
+    fixtures.cpp \
+    legacycodec.cpp \
+    main.cpp
+
+HEADERS += \
+    allocationcounter.h \
+    benchmark.h \
+    fixtures.h \
+    legacycodec.h
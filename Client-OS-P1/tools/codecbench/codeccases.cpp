@@ -0,0 +1,227 @@
+#include "benchmark.h"
+
+#include <QStringList>
+
+#include <memory>
+
+#include "fixtures.h"
+#include "legacycodec.h"
+#include "protocolcodec.h"
+
+// Todos los casos del benchmark. Cada opcode se mide con el codec original
+// (legacy, QDataStream) y con el actual (protocol). En decodificación hay
+// además "protocol+strings", que convierte cada campo a QString: es lo que
+// hace NetworkWorker al armar un evento, y es la comparación justa con
+// legacy, que siempre copia.
+
+namespace {
+
+using Fixtures::Script;
+
+constexpr int ShortText = 40;
+constexpr int LongText = 240;
+constexpr int HistoryText = 120;
+const int RosterSizes[] = {16, 64, 255};
+const int HistorySizes[] = {50, 255};
+
+QString statusText(quint8 status) {
+    switch (status) {
+    case 1: return QStringLiteral("Activo");
+    case 2: return QStringLiteral("Ocupado");
+    case 3: return QStringLiteral("Inactivo");
+    default: return QStringLiteral("Desconectado");
+    }
+}
+
+quint64 length(const QString &text) {
+    return quint64(text.size());
+}
+
+// Tres casos de decodificación que comparten la misma entrada
+void addDecode(QList<BenchCase> &cases, int opcode, const QString &payload, const QString &script,
+               const QByteArray &frame, std::function<quint64()> legacy,
+               std::function<quint64()> views, std::function<quint64()> strings) {
+    if (legacy)
+        cases.append(BenchCase{"decode", opcode, payload, script, "legacy", frame.size(), std::move(legacy)});
+    cases.append(BenchCase{"decode", opcode, payload, script, "protocol", frame.size(), std::move(views)});
+    cases.append(BenchCase{"decode", opcode, payload, script, "protocol+strings", frame.size(), std::move(strings)});
+}
+
+void addEncodeCases(QList<BenchCase> &cases) {
+    // Un FrameBuilder por caso, reutilizado entre operaciones como en NetworkWorker
+    auto builder = [] { return std::make_shared<Protocol::FrameBuilder>(); };
+
+    {
+        auto frames = builder();
+        const qsizetype size = frames->listUsers().size();
+        cases.append(BenchCase{"encode", 1, "empty", "-", "legacy", size,
+                               [] { return quint64(Legacy::listUsers().size()); }});
+        cases.append(BenchCase{"encode", 1, "empty", "-", "protocol", size,
+                               [frames] { return quint64(frames->listUsers().size()); }});
+    }
+
+    for (Script script : Fixtures::scripts()) {
+        const QString scriptName = Fixtures::scriptName(script);
+        const QString user = Fixtures::userName(script, 7);
+        const QString peer = Fixtures::userName(script, 8);
+        auto frames = builder();
+
+        cases.append(BenchCase{"encode", 2, "name", scriptName, "legacy", frames->getUser(user).size(),
+                               [user] { return quint64(Legacy::getUser(user).size()); }});
+        cases.append(BenchCase{"encode", 2, "name", scriptName, "protocol", frames->getUser(user).size(),
+                               [frames, user] { return quint64(frames->getUser(user).size()); }});
+
+        cases.append(BenchCase{"encode", 3, "name+status", scriptName, "legacy", frames->changeStatus(user, 2).size(),
+                               [user] { return quint64(Legacy::changeStatus(user, 2).size()); }});
+        cases.append(BenchCase{"encode", 3, "name+status", scriptName, "protocol", frames->changeStatus(user, 2).size(),
+                               [frames, user] { return quint64(frames->changeStatus(user, 2).size()); }});
+
+        for (int bytes : {ShortText, LongText}) {
+            const QString text = Fixtures::messageText(script, 0, bytes);
+            const QString payload = QStringLiteral("%1B text").arg(bytes);
+            const qsizetype size = frames->sendMessage(peer, text).size();
+            cases.append(BenchCase{"encode", 4, payload, scriptName, "legacy", size,
+                                   [peer, text] { return quint64(Legacy::sendMessage(peer, text).size()); }});
+            cases.append(BenchCase{"encode", 4, payload, scriptName, "protocol", size,
+                                   [frames, peer, text] { return quint64(frames->sendMessage(peer, text).size()); }});
+        }
+
+        cases.append(BenchCase{"encode", 5, "chat", scriptName, "legacy", frames->getHistory(peer).size(),
+                               [peer] { return quint64(Legacy::getHistory(peer).size()); }});
+        cases.append(BenchCase{"encode", 5, "chat", scriptName, "protocol", frames->getHistory(peer).size(),
+                               [frames, peer] { return quint64(frames->getHistory(peer).size()); }});
+        cases.append(BenchCase{"encode", 5, "chat+page", scriptName, "protocol", frames->getHistoryPage(peer, 1234, 50).size(),
+                               [frames, peer] { return quint64(frames->getHistoryPage(peer, 1234, 50).size()); }});
+    }
+}
+
+void addDecodeCases(QList<BenchCase> &cases) {
+    {
+        const QByteArray frame = Fixtures::errorFrame();
+        addDecode(cases, 50, "code", "-", frame,
+            [frame] { quint8 code = 0; return quint64(Legacy::decodeError(frame, code)) + code; },
+            [frame] { Protocol::ErrorFrame out; return quint64(Protocol::decodeError(frame, out)) + out.code; },
+            [frame] { Protocol::ErrorFrame out; return quint64(Protocol::decodeError(frame, out)) + out.code; });
+    }
+
+    for (Script script : Fixtures::scripts()) {
+        const QString scriptName = Fixtures::scriptName(script);
+
+        for (int users : RosterSizes) {
+            const QByteArray frame = Fixtures::userListFrame(script, users);
+            addDecode(cases, 51, QStringLiteral("%1 users").arg(users), scriptName, frame,
+                [frame] {
+                    QStringList list;
+                    Legacy::decodeUserList(frame, list);
+                    return quint64(list.size());
+                },
+                [frame] {
+                    Protocol::UserListFrame out;
+                    Protocol::decodeUserList(frame, out);
+                    return quint64(out.users.size());
+                },
+                [frame] {
+                    // Mismo formato que legacy y que NetworkWorker: "nombre (Estado)"
+                    Protocol::UserListFrame out;
+                    QStringList list;
+                    if (Protocol::decodeUserList(frame, out)) {
+                        list.reserve(out.users.size());
+                        for (const Protocol::UserEntry &entry : out.users)
+                            list.append(Protocol::toString(entry.name) + " (" + statusText(entry.status) + ")");
+                    }
+                    return quint64(list.size());
+                });
+        }
+
+        {
+            const QByteArray frame = Fixtures::userInfoFrame(script);
+            addDecode(cases, 52, "name+status", scriptName, frame,
+                [frame] { QString name; quint8 status = 0; Legacy::decodeUserInfo(frame, name, status); return length(name) + status; },
+                [frame] { Protocol::UserInfoFrame out; Protocol::decodeUserInfo(frame, out); return quint64(out.name.size()) + out.status; },
+                [frame] { Protocol::UserInfoFrame out; Protocol::decodeUserInfo(frame, out); return length(Protocol::toString(out.name)) + out.status; });
+        }
+        {
+            const QByteArray frame = Fixtures::userConnectedFrame(script);
+            addDecode(cases, 53, "name", scriptName, frame,
+                [frame] { QString name; Legacy::decodeUserConnected(frame, name); return length(name); },
+                [frame] { Protocol::UserConnectedFrame out; Protocol::decodeUserConnected(frame, out); return quint64(out.name.size()); },
+                [frame] { Protocol::UserConnectedFrame out; Protocol::decodeUserConnected(frame, out); return length(Protocol::toString(out.name)); });
+        }
+        {
+            const QByteArray frame = Fixtures::statusChangeFrame(script);
+            addDecode(cases, 54, "name+status", scriptName, frame,
+                [frame] { QString name; quint8 status = 0; Legacy::decodeStatusChange(frame, name, status); return length(name) + status; },
+                [frame] { Protocol::StatusChangeFrame out; Protocol::decodeStatusChange(frame, out); return quint64(out.name.size()) + out.status; },
+                [frame] { Protocol::StatusChangeFrame out; Protocol::decodeStatusChange(frame, out); return length(Protocol::toString(out.name)) + out.status; });
+        }
+
+        for (int bytes : {ShortText, LongText}) {
+            const QByteArray frame = Fixtures::messageFrame(script, bytes);
+            addDecode(cases, 55, QStringLiteral("%1B text").arg(bytes), scriptName, frame,
+                [frame] { QString sender, text; Legacy::decodeMessage(frame, sender, text); return length(sender) + length(text); },
+                [frame] { Protocol::MessageFrame out; Protocol::decodeMessage(frame, out); return quint64(out.sender.size() + out.text.size()); },
+                [frame] {
+                    Protocol::MessageFrame out;
+                    Protocol::decodeMessage(frame, out);
+                    return length(Protocol::toString(out.sender)) + length(Protocol::toString(out.text));
+                });
+        }
+
+        for (int messages : HistorySizes) {
+            const QByteArray frame = Fixtures::historyFrame(script, messages, HistoryText, false);
+            const QString payload = QStringLiteral("%1 msgs").arg(messages);
+            addDecode(cases, 56, payload, scriptName, frame,
+                [frame] {
+                    QList<QPair<QString, QString>> list;
+                    Legacy::decodeHistory(frame, list);
+                    return quint64(list.size());
+                },
+                [frame] {
+                    Protocol::HistoryFrame out;
+                    Protocol::decodeHistory(frame, out);
+                    return quint64(out.messages.size());
+                },
+                [frame] {
+                    Protocol::HistoryFrame out;
+                    QList<QPair<QString, QString>> list;
+                    if (Protocol::decodeHistory(frame, out)) {
+                        list.reserve(out.messages.size());
+                        for (const Protocol::MessageFrame &message : out.messages)
+                            list.append(qMakePair(Protocol::toString(message.sender), Protocol::toString(message.text)));
+                    }
+                    return quint64(list.size());
+                });
+
+            // El mismo historial comprimido; el codec original no tenía compresión
+            const QByteArray compressed = Fixtures::compressedFrame(frame);
+            addDecode(cases, 57, payload, scriptName, compressed, nullptr,
+                [compressed] {
+                    QByteArray inflated;
+                    Protocol::HistoryFrame out;
+                    if (!Protocol::inflateFrame(compressed, inflated) || !Protocol::decodeHistory(inflated, out))
+                        return quint64(0);
+                    return quint64(out.messages.size());
+                },
+                [compressed] {
+                    QByteArray inflated;
+                    Protocol::HistoryFrame out;
+                    QList<QPair<QString, QString>> list;
+                    if (Protocol::inflateFrame(compressed, inflated) && Protocol::decodeHistory(inflated, out)) {
+                        list.reserve(out.messages.size());
+                        for (const Protocol::MessageFrame &message : out.messages)
+                            list.append(qMakePair(Protocol::toString(message.sender), Protocol::toString(message.text)));
+                    }
+                    return quint64(list.size());
+                });
+        }
+    }
+}
+
+} // namespace
+
+QList<BenchCase> codecCases() {
+    QList<BenchCase> cases;
+    addEncodeCases(cases);
+    addDecodeCases(cases);
+    return cases;
+}
@@ -0,0 +1,131 @@
+#include "fixtures.h"
+
+#include <QStringList>
+
+#include "protocolcodec.h"
+
+namespace Fixtures {
+
+namespace {
+
+const QStringList &words(Script script) {
+    static const QStringList ascii = {
+        "hola", "the", "meeting", "is", "at", "noon", "ok", "server", "deploy", "ready",
+        "lunch?", "check", "the", "logs", "build", "is", "green", "thanks", "see", "you"
+    };
+    static const QStringList multilingual = {
+        "mañana", "reunión", "café", "привет", "сервер", "готов", "日本語", "会議", "内容",
+        "Größe", "naïve", "ελληνικά", "λόγος", "안녕하세요", "주문", "ok", "señal", "对的"
+    };
+    static const QStringList emoji = {
+        "🎉", "👍", "😂", "🔥", "❤️", "🚀", "👨‍👩‍👧", "jaja", "🙏🏽", "✨", "ok", "🇬🇹",
+        "😅", "💯", "🤝", "🫶", "👀", "lol"
+    };
+    switch (script) {
+    case Multilingual: return multilingual;
+    case Emoji: return emoji;
+    case Ascii: break;
+    }
+    return ascii;
+}
+
+QByteArray utf8(const QString &text) {
+    return text.toUtf8();
+}
+
+} // namespace
+
+QList<Script> scripts() {
+    return {Ascii, Multilingual, Emoji};
+}
+
+QString scriptName(Script script) {
+    switch (script) {
+    case Ascii: return QStringLiteral("ascii");
+    case Multilingual: return QStringLiteral("multilingual");
+    case Emoji: return QStringLiteral("emoji");
+    }
+    return QString();
+}
+
+QString userName(Script script, int index) {
+    static const QStringList multilingual = {"José", "Дмитрий", "山田", "Zoë", "Άννα"};
+    static const QStringList emoji = {"🦊fox", "🐼panda", "🌵cactus", "🎧dj"};
+    switch (script) {
+    case Multilingual:
+        return multilingual[index % multilingual.size()] + '_' + QString::number(index);
+    case Emoji:
+        return emoji[index % emoji.size()] + '_' + QString::number(index);
+    case Ascii:
+        break;
+    }
+    return QStringLiteral("user_") + QString::number(index);
+}
+
+QString messageText(Script script, int index, int maxBytes) {
+    const QStringList &pool = words(script);
+    QString text;
+    qsizetype bytes = 0;
+    for (int i = index;; ++i) {
+        const QString &word = pool[i % pool.size()];
+        const qsizetype size = word.toUtf8().size() + (text.isEmpty() ? 0 : 1);
+        if (bytes + size > maxBytes)
+            break;
+        if (!text.isEmpty())
+            text += ' ';
+        text += word;
+        bytes += size;
+    }
+    return text;
+}
+
+QByteArray errorFrame() {
+    return Protocol::FrameWriter(Protocol::Error).u8(4).data();
+}
+
+QByteArray userListFrame(Script script, int users) {
+    Protocol::FrameWriter frame(Protocol::UserList);
+    frame.u8(quint8(users));
+    for (int i = 0; i < users; ++i)
+        frame.string8(utf8(userName(script, i))).u8(quint8(1 + i % 3));
+    return frame.data();
+}
+
+QByteArray userInfoFrame(Script script) {
+    return Protocol::FrameWriter(Protocol::UserInfo).string8(utf8(userName(script, 7))).u8(2).data();
+}
+
+QByteArray userConnectedFrame(Script script) {
+    return Protocol::FrameWriter(Protocol::UserConnected).string8(utf8(userName(script, 7))).data();
+}
+
+QByteArray statusChangeFrame(Script script) {
+    return Protocol::FrameWriter(Protocol::StatusChange).string8(utf8(userName(script, 7))).u8(3).data();
+}
+
+QByteArray messageFrame(Script script, int textBytes) {
+    return Protocol::FrameWriter(Protocol::ChatMessage)
+        .string8(utf8(userName(script, 7)))
+        .string8(utf8(messageText(script, 0, textBytes)))
+        .data();
+}
+
+QByteArray historyFrame(Script script, int messages, int textBytes, bool paged) {
+    Protocol::FrameWriter frame(Protocol::ChatHistory);
+    frame.u8(quint8(messages));
+    for (int i = 0; i < messages; ++i) {
+        // Largos variados alrededor de textBytes, como en una conversación real
+        const int bytes = qMax(8, textBytes / 2 + (i * 37) % textBytes);
+        frame.string8(utf8(userName(script, i % 2)))
+             .string8(utf8(messageText(script, i, qMin(bytes, int(Protocol::FrameBuilder::MaxString8)))));
+    }
+    if (paged)
+        frame.u32(quint32(messages));
+    return frame.data();
+}
+
+QByteArray compressedFrame(const QByteArray &frame) {
+    return char(Protocol::Compressed) + qCompress(frame);
+}
+
+} // namespace Fixtures
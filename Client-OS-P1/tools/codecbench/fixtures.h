@@ -0,0 +1,38 @@
+#ifndef FIXTURES_H
+#define FIXTURES_H
+#pragma once
+
+#include <QByteArray>
+#include <QList>
+#include <QString>
+
+// Datos de entrada de los benchmarks: nombres y textos en tres alfabetos y
+// frames del servidor armados con ellos. Todo es determinista.
+namespace Fixtures {
+
+enum Script {
+    Ascii,
+    Multilingual,   // acentos, cirílico, griego, CJK: 2 y 3 bytes por carácter
+    Emoji           // pares sustitutos y secuencias ZWJ: 4 bytes o más
+};
+
+QList<Script> scripts();
+QString scriptName(Script script);
+
+QString userName(Script script, int index);
+// Texto de a lo sumo `maxBytes` bytes UTF-8, sin cortar caracteres.
+QString messageText(Script script, int index, int maxBytes);
+
+QByteArray errorFrame();
+QByteArray userListFrame(Script script, int users);
+QByteArray userInfoFrame(Script script);
+QByteArray userConnectedFrame(Script script);
+QByteArray statusChangeFrame(Script script);
+QByteArray messageFrame(Script script, int textBytes);
+QByteArray historyFrame(Script script, int messages, int textBytes, bool paged);
+// [57][qCompress(frame)], como lo envía un servidor con compresión
+QByteArray compressedFrame(const QByteArray &frame);
+
+} // namespace Fixtures
+
+#endif // FIXTURES_H
@@ -0,0 +1,155 @@
+#include "legacycodec.h"
+
+#include <QDataStream>
+
+namespace Legacy {
+
+namespace {
+
+QString getString8(QDataStream &in) {
+    quint8 length;
+    in >> length;
+    QByteArray data;
+    data.resize(length);
+    in.readRawData(data.data(), length);
+    return QString::fromUtf8(data);
+}
+
+bool begin(QDataStream &in, quint8 expected) {
+    quint8 opcode;
+    in >> opcode;
+    return in.status() == QDataStream::Ok && opcode == expected;
+}
+
+} // namespace
+
+QByteArray listUsers() {
+    QByteArray payload;
+    QDataStream out(&payload, QIODevice::WriteOnly);
+    out << quint8(1);
+    return payload;
+}
+
+QByteArray getUser(const QString &username) {
+    QByteArray payload;
+    QDataStream out(&payload, QIODevice::WriteOnly);
+    out << quint8(2) << quint8(username.size());
+    out.writeRawData(username.toUtf8().data(), username.size());
+    return payload;
+}
+
+QByteArray changeStatus(const QString &username, quint8 status) {
+    QByteArray payload;
+    QDataStream out(&payload, QIODevice::WriteOnly);
+    out << quint8(3);
+    out << quint8(username.size());
+    out.writeRawData(username.toUtf8().data(), username.size());
+    out << status;
+    return payload;
+}
+
+QByteArray sendMessage(const QString &recipient, const QString &message) {
+    QByteArray payload;
+    QDataStream out(&payload, QIODevice::WriteOnly);
+    out << quint8(4);
+    out << quint8(recipient.size());
+    out.writeRawData(recipient.toUtf8().data(), recipient.size());
+    out << quint8(message.size());
+    out.writeRawData(message.toUtf8().data(), message.size());
+    return payload;
+}
+
+QByteArray getHistory(const QString &chatName) {
+    QByteArray payload;
+    QDataStream out(&payload, QIODevice::WriteOnly);
+    out << quint8(5);
+    out << quint8(chatName.size());
+    out.writeRawData(chatName.toUtf8().data(), chatName.size());
+    return payload;
+}
+
+bool decodeError(const QByteArray &frame, quint8 &code) {
+    QDataStream in(frame);
+    if (!begin(in, 50))
+        return false;
+    in >> code;
+    return in.status() == QDataStream::Ok;
+}
+
+bool decodeUserList(const QByteArray &frame, QStringList &users) {
+    QDataStream in(frame);
+    if (!begin(in, 51))
+        return false;
+    quint8 numUsers;
+    in >> numUsers;
+
+    users.clear();
+    for (int i = 0; i < numUsers; ++i) {
+        QString user = getString8(in);
+        quint8 status;
+        in >> status;
+
+        QString statusText;
+        switch (status) {
+        case 1: statusText = "Activo"; break;
+        case 2: statusText = "Ocupado"; break;
+        case 3: statusText = "Inactivo"; break;
+        default: statusText = "Desconectado";
+        }
+        users.append(user + " (" + statusText + ")");
+    }
+    return in.status() == QDataStream::Ok;
+}
+
+bool decodeUserInfo(const QByteArray &frame, QString &name, quint8 &status) {
+    QDataStream in(frame);
+    if (!begin(in, 52))
+        return false;
+    name = getString8(in);
+    in >> status;
+    return in.status() == QDataStream::Ok;
+}
+
+bool decodeUserConnected(const QByteArray &frame, QString &name) {
+    QDataStream in(frame);
+    if (!begin(in, 53))
+        return false;
+    name = getString8(in);
+    return in.status() == QDataStream::Ok;
+}
+
+bool decodeStatusChange(const QByteArray &frame, QString &name, quint8 &status) {
+    QDataStream in(frame);
+    if (!begin(in, 54))
+        return false;
+    name = getString8(in);
+    in >> status;
+    return in.status() == QDataStream::Ok;
+}
+
+bool decodeMessage(const QByteArray &frame, QString &sender, QString &text) {
+    QDataStream in(frame);
+    if (!begin(in, 55))
+        return false;
+    sender = getString8(in);
+    text = getString8(in);
+    return in.status() == QDataStream::Ok;
+}
+
+bool decodeHistory(const QByteArray &frame, QList<QPair<QString, QString>> &messages) {
+    QDataStream in(frame);
+    if (!begin(in, 56))
+        return false;
+    quint8 numMessages;
+    in >> numMessages;
+
+    messages.clear();
+    for (int i = 0; i < numMessages; ++i) {
+        QString sender = getString8(in);
+        QString text = getString8(in);
+        messages.append(qMakePair(sender, text));
+    }
+    return in.status() == QDataStream::Ok;
+}
+
+} // namespace Legacy
@@ -0,0 +1,37 @@
+#ifndef LEGACYCODEC_H
+#define LEGACYCODEC_H
+#pragma once
+
+#include <QByteArray>
+#include <QList>
+#include <QPair>
+#include <QString>
+#include <QStringList>
+
+// El codec original de WebSocketClient, basado en QDataStream, conservado
+// solo como referencia para los benchmarks.
+//
+// Reproduce el código anterior tal cual, incluido el prefijo de longitud en
+// unidades UTF-16 (QString::size()) que truncaba los textos no ASCII: lo que
+// se mide es su costo, no su salida. Cada decodificador copia todos los
+// textos a QString, como hacía el original.
+namespace Legacy {
+
+QByteArray listUsers();
+QByteArray getUser(const QString &username);
+QByteArray changeStatus(const QString &username, quint8 status);
+QByteArray sendMessage(const QString &recipient, const QString &message);
+QByteArray getHistory(const QString &chatName);
+
+bool decodeError(const QByteArray &frame, quint8 &code);
+// "nombre (Estado)", como lo emitía userListReceived
+bool decodeUserList(const QByteArray &frame, QStringList &users);
+bool decodeUserInfo(const QByteArray &frame, QString &name, quint8 &status);
+bool decodeUserConnected(const QByteArray &frame, QString &name);
+bool decodeStatusChange(const QByteArray &frame, QString &name, quint8 &status);
+bool decodeMessage(const QByteArray &frame, QString &sender, QString &text);
+bool decodeHistory(const QByteArray &frame, QList<QPair<QString, QString>> &messages);
+
+} // namespace Legacy
+
+#endif // LEGACYCODEC_H
@@ -0,0 +1,105 @@
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QTextStream>
+
+#include <cstdio>
+
+#include "allocationcounter.h"
+#include "benchmark.h"
+
+// Benchmark del codec: throughput y reservas por operación de cada opcode,
+// con el codec original (QDataStream) y el actual.
+//
+//   codecbench                       tabla legible
+//   codecbench --json results.json   además, resultados en JSON
+//   codecbench --filter decode/56    solo los casos cuyo nombre contiene el texto
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("codecbench");
+
+    const BenchSettings defaults;
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Benchmark del codec del protocolo de chat");
+    parser.addHelpOption();
+    parser.addOptions({
+        {"filter", "Solo los casos cuyo nombre contiene este texto.", "texto"},
+        {"list", "Listar los casos sin medirlos."},
+        {"samples", "Muestras por caso.", "n", QString::number(defaults.samples)},
+        {"min-time", "Duración mínima de cada muestra, en ms.", "ms", QString::number(defaults.minSampleNs / 1000000)},
+        {"json", "Escribir los resultados en JSON (\"-\" para la salida estándar).", "archivo"},
+    });
+    parser.process(app);
+
+    BenchSettings settings;
+    settings.samples = qMax(1, parser.value("samples").toInt());
+    settings.minSampleNs = qMax(1, parser.value("min-time").toInt()) * qint64(1000000);
+
+    const QString filter = parser.value("filter");
+    QList<BenchCase> cases;
+    for (const BenchCase &benchCase : codecCases()) {
+        if (filter.isEmpty() || benchCase.name().contains(filter))
+            cases.append(benchCase);
+    }
+
+    const QString jsonPath = parser.value("json");
+    // Con JSON a la salida estándar, la tabla va a stderr
+    QTextStream table(jsonPath == "-" ? stderr : stdout);
+
+    if (parser.isSet("list")) {
+        for (const BenchCase &benchCase : cases)
+            table << benchCase.name() << Qt::endl;
+        return 0;
+    }
+
+#ifndef QT_NO_DEBUG
+    table << "Aviso: compilado en debug, los tiempos no son representativos" << Qt::endl;
+#endif
+    table << QStringLiteral("%1 %2 %3 %4 %5")
+                 .arg(QStringLiteral("caso"), -48)
+                 .arg(QStringLiteral("ns/op"), 10)
+                 .arg(QStringLiteral("Mops/s"), 9)
+                 .arg(QStringLiteral("MB/s"), 9)
+                 .arg(QStringLiteral("allocs/op"), 10)
+          << Qt::endl;
+
+    QJsonArray results;
+    for (const BenchCase &benchCase : cases) {
+        const BenchResult result = runBenchmark(benchCase, settings);
+        const QString allocs = result.allocsPerOp >= 0.0 ? QString::number(result.allocsPerOp, 'f', 2) : QStringLiteral("n/d");
+        table << QStringLiteral("%1 %2 %3 %4 %5")
+                     .arg(benchCase.name(), -48)
+                     .arg(result.nsPerOp, 10, 'f', 1)
+                     .arg(result.opsPerSecond() / 1e6, 9, 'f', 3)
+                     .arg(double(benchCase.bytes) * result.opsPerSecond() / 1e6, 9, 'f', 1)
+                     .arg(allocs, 10)
+              << Qt::endl;
+        results.append(result.toJson(benchCase));
+    }
+
+    if (jsonPath.isEmpty())
+        return 0;
+
+    QJsonObject report;
+    report["benchmark"] = "codec";
+    report["qtVersion"] = qVersion();
+    report["allocationCounting"] = AllocationCounter::supported();
+    report["samples"] = settings.samples;
+    report["minSampleNs"] = settings.minSampleNs;
+    report["results"] = results;
+    const QByteArray json = QJsonDocument(report).toJson(QJsonDocument::Indented);
+
+    if (jsonPath == "-") {
+        std::fwrite(json.constData(), 1, std::size_t(json.size()), stdout);
+        return 0;
+    }
+    QFile file(jsonPath);
+    if (!file.open(QIODevice::WriteOnly) || file.write(json) != json.size()) {
+        QTextStream(stderr) << "No se pudo escribir " << jsonPath << Qt::endl;
+        return 1;
+    }
+    return 0;
+}
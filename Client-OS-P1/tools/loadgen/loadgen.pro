@@ -0,0 +1,22 @@
+# Generador de carga de línea de comandos: muchas sesiones simuladas contra
+# el servidor, con el protocolo de la biblioteca chatcore.
+
+TEMPLATE = app
+TARGET = loadgen
+CONFIG += console c++17
+CONFIG -= app_bundle
+
+QT = core network websockets
+
+CONFIG(release, debug|release): DEFINES += QT_NO_DEBUG_OUTPUT
+
+include(../../core/core.pri)
+
+SOURCES += \
+    loadgenerator.cpp \
+    loadshard.cpp \
+    main.cpp
+
+HEADERS += \
+    loadgenerator.h \
+    loadshard.h
@@ -0,0 +1,134 @@
+#include "loadgenerator.h"
+
+namespace {
+
+QString bytes(quint64 count) {
+    if (count < 1024)
+        return QString::number(count) + " B";
+    if (count < 1024 * 1024)
+        return QString::number(double(count) / 1024.0, 'f', 1) + " KiB";
+    return QString::number(double(count) / (1024.0 * 1024.0), 'f', 1) + " MiB";
+}
+
+QString percentiles(const LatencyHistogram& histogram) {
+    if (histogram.count() == 0)
+        return QStringLiteral("sin muestras");
+    return QStringLiteral("p50 %1  p99 %2  p999 %3  máx %4  (%5 muestras)")
+        .arg(LatencyHistogram::format(histogram.percentile(50.0)),
+             LatencyHistogram::format(histogram.percentile(99.0)),
+             LatencyHistogram::format(histogram.percentile(99.9)),
+             LatencyHistogram::format(histogram.max()),
+             QString::number(histogram.count()));
+}
+
+} // namespace
+
+LoadGenerator::LoadGenerator(const LoadConfig& config, QTextStream& out, QObject* parent)
+    : QObject(parent), m_config(config), m_out(out)
+{
+    m_progress.setInterval(ProgressMs);
+    connect(&m_progress, &QTimer::timeout, this, &LoadGenerator::printProgress);
+
+    m_deadline.setSingleShot(true);
+    m_deadline.setInterval(config.durationSec * 1000);
+    connect(&m_deadline, &QTimer::timeout, this, &LoadGenerator::finish);
+}
+
+LoadGenerator::~LoadGenerator() {
+    if (m_running)
+        finish();
+}
+
+void LoadGenerator::start() {
+    const int threads = qBound(1, m_config.threads, qMax(1, m_config.sessions));
+    m_out << "Conectando " << m_config.sessions << " sesiones a " << m_config.url.toString()
+          << " con " << threads << " hilos durante " << m_config.durationSec << " s" << Qt::endl;
+
+    for (int i = 0; i < threads; ++i) {
+        auto thread = std::make_unique<QThread>();
+        thread->setObjectName(QStringLiteral("loadgen-%1").arg(i));
+        auto shard = std::make_unique<LoadShard>(m_config, &m_nextSession);
+        shard->moveToThread(thread.get());
+        thread->start();
+        QMetaObject::invokeMethod(shard.get(), &LoadShard::start, Qt::QueuedConnection);
+        m_threads.push_back(std::move(thread));
+        m_shards.push_back(std::move(shard));
+    }
+
+    m_running = true;
+    m_clock.start();
+    m_progress.start();
+    m_deadline.start();
+}
+
+LoadShard::Snapshot LoadGenerator::collect() const {
+    LoadShard::Snapshot totals;
+    for (const auto& shard : m_shards)
+        totals += shard->snapshot();
+    return totals;
+}
+
+void LoadGenerator::printProgress() {
+    const LoadShard::Snapshot now = collect();
+    const double seconds = ProgressMs / 1000.0;
+    m_out << QStringLiteral("[%1 s] sesiones %2/%3  ops %4/s  entregas %5/s  errores %6")
+                 .arg(m_clock.elapsed() / 1000, 4)
+                 .arg(now.opened - now.dropped)
+                 .arg(m_config.sessions)
+                 .arg(double(now.totalSent() - m_last.totalSent()) / seconds, 0, 'f', 0)
+                 .arg(double(now.delivered - m_last.delivered) / seconds, 0, 'f', 0)
+                 .arg(now.failed + now.dropped + now.serverErrors)
+          << Qt::endl;
+    m_last = now;
+}
+
+void LoadGenerator::finish() {
+    if (!m_running)
+        return;
+    m_running = false;
+    m_progress.stop();
+    m_deadline.stop();
+    const double seconds = double(m_clock.nsecsElapsed()) / 1e9;
+
+    // Los histogramas se leen solo con cada hilo ya detenido
+    for (std::size_t i = 0; i < m_shards.size(); ++i) {
+        QMetaObject::invokeMethod(m_shards[i].get(), &LoadShard::stop, Qt::BlockingQueuedConnection);
+        m_threads[i]->quit();
+        m_threads[i]->wait();
+    }
+
+    LatencyHistogram delivery;
+    LatencyHistogram history;
+    for (const auto& shard : m_shards) {
+        delivery.merge(shard->delivery());
+        history.merge(shard->historyRoundTrip());
+    }
+    printReport(seconds, collect(), delivery, history);
+
+    m_shards.clear();
+    m_threads.clear();
+    emit finished();
+}
+
+void LoadGenerator::printReport(double seconds, const LoadShard::Snapshot& totals,
+                                const LatencyHistogram& delivery, const LatencyHistogram& history) {
+    m_out << Qt::endl
+          << QStringLiteral("Duración     %1 s").arg(seconds, 0, 'f', 1) << Qt::endl
+          << QStringLiteral("Sesiones     %1 abiertas, %2 fallidas, %3 caídas")
+                 .arg(totals.opened).arg(totals.failed).arg(totals.dropped) << Qt::endl
+          << QStringLiteral("Enviados     %1 mensajes, %2 estados, %3 historiales (%4 ops/s)")
+                 .arg(totals.sent[LoadShard::Send])
+                 .arg(totals.sent[LoadShard::Status])
+                 .arg(totals.sent[LoadShard::History])
+                 .arg(double(totals.totalSent()) / seconds, 0, 'f', 1) << Qt::endl
+          << QStringLiteral("Recibidos    %1 entregas (%2 msg/s), %3 cambios de estado, %4 historiales")
+                 .arg(totals.delivered)
+                 .arg(double(totals.delivered) / seconds, 0, 'f', 1)
+                 .arg(totals.statusEvents)
+                 .arg(totals.historyReplies) << Qt::endl
+          << QStringLiteral("Bytes        %1 enviados, %2 recibidos")
+                 .arg(bytes(totals.bytesOut), bytes(totals.bytesIn)) << Qt::endl
+          << QStringLiteral("Errores      %1 del servidor (opcode 50)").arg(totals.serverErrors) << Qt::endl
+          << "Entrega      " << percentiles(delivery) << Qt::endl
+          << "Historial    " << percentiles(history) << Qt::endl;
+}
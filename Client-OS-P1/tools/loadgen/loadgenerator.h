@@ -0,0 +1,51 @@
+#ifndef LOADGENERATOR_H
+#define LOADGENERATOR_H
+#pragma once
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QTextStream>
+#include <QThread>
+#include <QTimer>
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "loadshard.h"
+
+// Reparte las sesiones entre los hilos de carga, muestra el progreso cada
+// segundo y al terminar imprime el throughput y los percentiles.
+class LoadGenerator : public QObject {
+    Q_OBJECT
+public:
+    LoadGenerator(const LoadConfig& config, QTextStream& out, QObject* parent = nullptr);
+    ~LoadGenerator();
+
+    void start();
+
+signals:
+    void finished();
+
+private:
+    static constexpr int ProgressMs = 1000;
+
+    LoadShard::Snapshot collect() const;
+    void printProgress();
+    void finish();
+    void printReport(double seconds, const LoadShard::Snapshot& totals,
+                     const LatencyHistogram& delivery, const LatencyHistogram& history);
+
+    const LoadConfig m_config;
+    QTextStream& m_out;
+    std::atomic<int> m_nextSession{0};
+    std::vector<std::unique_ptr<QThread>> m_threads;
+    std::vector<std::unique_ptr<LoadShard>> m_shards;
+    QTimer m_progress;
+    QTimer m_deadline;
+    QElapsedTimer m_clock;
+    LoadShard::Snapshot m_last;
+    bool m_running = false;
+};
+
+#endif // LOADGENERATOR_H
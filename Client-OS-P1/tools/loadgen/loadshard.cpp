@@ -0,0 +1,250 @@
+#include "loadshard.h"
+
+#include <QUrlQuery>
+
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+constexpr char StampTag[] = "lg ";
+constexpr qsizetype StampTagSize = sizeof(StampTag) - 1;
+
+QString sessionName(const QString& prefix, int index) {
+    return prefix + '-' + QString::number(index);
+}
+
+// "lg <ns> " al inicio del texto; devuelve false si el mensaje no es de carga.
+bool parseStamp(QByteArrayView text, qint64& sentNs) {
+    if (!text.startsWith(QByteArrayView(StampTag, StampTagSize)))
+        return false;
+    const char* begin = text.data() + StampTagSize;
+    const char* end = text.data() + text.size();
+    return std::from_chars(begin, end, sentNs).ec == std::errc();
+}
+
+} // namespace
+
+LoadShard::Snapshot& LoadShard::Snapshot::operator+=(const Snapshot& other) {
+    opened += other.opened;
+    failed += other.failed;
+    dropped += other.dropped;
+    for (int op = 0; op < OpCount; ++op)
+        sent[op] += other.sent[op];
+    delivered += other.delivered;
+    statusEvents += other.statusEvents;
+    historyReplies += other.historyReplies;
+    serverErrors += other.serverErrors;
+    bytesOut += other.bytesOut;
+    bytesIn += other.bytesIn;
+    return *this;
+}
+
+LoadShard::LoadShard(const LoadConfig& config, std::atomic<int>* nextSession)
+    : m_config(config), m_nextSession(nextSession),
+      m_random(QRandomGenerator::global()->generate()),
+      m_padding(qMax(0, config.messageSize), 'x')
+{
+}
+
+qint64 LoadShard::nowNs() {
+    using namespace std::chrono;
+    return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+void LoadShard::start() {
+    m_tick = new QTimer(this);
+    m_tick->setTimerType(Qt::PreciseTimer);
+    m_tick->setInterval(TickMs);
+    connect(m_tick, &QTimer::timeout, this, &LoadShard::tick);
+    m_tick->start();
+
+    claimSessions();
+}
+
+void LoadShard::stop() {
+    m_stopping = true;
+    delete m_tick;
+    m_tick = nullptr;
+    // abort() en lugar de close(): con miles de sesiones no se espera el
+    // cierre ordenado de cada una.
+    for (const auto& session : m_sessions) {
+        session->socket->abort();
+        delete session->socket;
+        session->socket = nullptr;
+    }
+}
+
+LoadShard::Snapshot LoadShard::snapshot() const {
+    Snapshot s;
+    s.opened = m_counters.opened.load(std::memory_order_relaxed);
+    s.failed = m_counters.failed.load(std::memory_order_relaxed);
+    s.dropped = m_counters.dropped.load(std::memory_order_relaxed);
+    for (int op = 0; op < OpCount; ++op)
+        s.sent[op] = m_counters.sent[op].load(std::memory_order_relaxed);
+    s.delivered = m_counters.delivered.load(std::memory_order_relaxed);
+    s.statusEvents = m_counters.statusEvents.load(std::memory_order_relaxed);
+    s.historyReplies = m_counters.historyReplies.load(std::memory_order_relaxed);
+    s.serverErrors = m_counters.serverErrors.load(std::memory_order_relaxed);
+    s.bytesOut = m_counters.bytesOut.load(std::memory_order_relaxed);
+    s.bytesIn = m_counters.bytesIn.load(std::memory_order_relaxed);
+    return s;
+}
+
+void LoadShard::claimSessions() {
+    while (!m_stopping && m_handshakes < MaxHandshakes) {
+        const int index = m_nextSession->fetch_add(1, std::memory_order_relaxed);
+        if (index >= m_config.sessions)
+            return;
+        openSession(index);
+    }
+}
+
+void LoadShard::openSession(int index) {
+    auto owned = std::make_unique<Session>();
+    Session* session = owned.get();
+    session->index = index;
+    session->name = sessionName(m_config.prefix, index);
+    session->nameUtf8 = session->name.toUtf8();
+    session->socket = new QWebSocket(QString(), QWebSocketProtocol::VersionLatest, this);
+    m_sessions.push_back(std::move(owned));
+    ++m_handshakes;
+
+    connect(session->socket, &QWebSocket::connected, this, [this, session] {
+        session->connecting = false;
+        session->open = true;
+        session->nextOpNs = nowNs() + nextIntervalNs();
+        --m_handshakes;
+        m_counters.opened.fetch_add(1, std::memory_order_relaxed);
+        claimSessions();
+    });
+    connect(session->socket, &QWebSocket::binaryMessageReceived, this, [this, session](const QByteArray& frame) {
+        onFrame(*session, frame);
+    });
+    // Un connect fallido no emite disconnected(); el cambio de estado sí llega
+    connect(session->socket, &QWebSocket::stateChanged, this, [this, session](QAbstractSocket::SocketState state) {
+        if (state == QAbstractSocket::UnconnectedState)
+            onSocketDown(session);
+    });
+
+    QUrl url = m_config.url;
+    QUrlQuery query;
+    query.addQueryItem("name", session->name);
+    url.setQuery(query);
+    session->socket->open(url);
+}
+
+void LoadShard::onSocketDown(Session* session) {
+    if (m_stopping)
+        return;
+    if (session->connecting) {
+        session->connecting = false;
+        --m_handshakes;
+        m_counters.failed.fetch_add(1, std::memory_order_relaxed);
+        claimSessions();
+    } else if (session->open) {
+        session->open = false;
+        m_counters.dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+qint64 LoadShard::nextIntervalNs() {
+    // Llegadas de Poisson: intervalos exponenciales con media 1/rate
+    const double mean = 1e9 / m_config.rate;
+    return qint64(-std::log(1.0 - m_random.generateDouble()) * mean);
+}
+
+QString LoadShard::peerOf(int index) {
+    if (m_config.sessions < 2)
+        return sessionName(m_config.prefix, index);
+    int peer = int(m_random.bounded(m_config.sessions - 1));
+    if (peer >= index)
+        ++peer;
+    return sessionName(m_config.prefix, peer);
+}
+
+void LoadShard::tick() {
+    const qint64 now = nowNs();
+    for (const auto& owned : m_sessions) {
+        Session& session = *owned;
+        if (!session.open)
+            continue;
+        if (now - session.nextOpNs > CatchUpLimitNs)
+            session.nextOpNs = now;
+        while (session.nextOpNs <= now) {
+            runOp(session, now);
+            session.nextOpNs += nextIntervalNs();
+        }
+    }
+}
+
+void LoadShard::runOp(Session& session, qint64 now) {
+    const int total = m_config.sendWeight + m_config.statusWeight + m_config.historyWeight;
+    const int pick = int(m_random.bounded(total));
+    const Op op = pick < m_config.sendWeight ? Send
+                : pick < m_config.sendWeight + m_config.statusWeight ? Status
+                : History;
+
+    const QByteArray* frame = nullptr;
+    switch (op) {
+    case Send: {
+        char stamp[StampTagSize + 24];
+        memcpy(stamp, StampTag, StampTagSize);
+        char* end = std::to_chars(stamp + StampTagSize, stamp + sizeof(stamp) - 1, now).ptr;
+        *end++ = ' ';
+        const QByteArrayView prefix(stamp, end - stamp);
+        const qsizetype fill = qBound<qsizetype>(0, m_padding.size() - prefix.size(),
+                                                 Protocol::FrameBuilder::MaxString8 - prefix.size());
+        frame = &m_frames.sendMessageUtf8(peerOf(session.index), prefix, QByteArrayView(m_padding).first(fill));
+        break;
+    }
+    case Status:
+        // Alterna entre ACTIVO y OCUPADO para que cada envío sea un cambio real
+        session.status = session.status == 1 ? 2 : 1;
+        frame = &m_frames.changeStatus(session.name, session.status);
+        break;
+    case History:
+        session.historySentNs.enqueue(now);
+        frame = &m_frames.getHistory(peerOf(session.index));
+        break;
+    case OpCount:
+        return;
+    }
+
+    session.socket->sendBinaryMessage(*frame);
+    m_counters.sent[op].fetch_add(1, std::memory_order_relaxed);
+    m_counters.bytesOut.fetch_add(quint64(frame->size()), std::memory_order_relaxed);
+}
+
+void LoadShard::onFrame(Session& session, const QByteArray& frame) {
+    m_counters.bytesIn.fetch_add(quint64(frame.size()), std::memory_order_relaxed);
+
+    switch (Protocol::opcodeOf(frame)) {
+    case Protocol::ChatMessage: {
+        Protocol::MessageFrame message;
+        qint64 sentNs = 0;
+        // El eco al propio remitente no cuenta como entrega
+        if (Protocol::decodeMessage(frame, message) && message.sender != QByteArrayView(session.nameUtf8)
+            && parseStamp(message.text, sentNs)) {
+            m_delivery.record(nowNs() - sentNs);
+            m_counters.delivered.fetch_add(1, std::memory_order_relaxed);
+        }
+        break;
+    }
+    case Protocol::ChatHistory:
+        if (!session.historySentNs.isEmpty())
+            m_historyRoundTrip.record(nowNs() - session.historySentNs.dequeue());
+        m_counters.historyReplies.fetch_add(1, std::memory_order_relaxed);
+        break;
+    case Protocol::StatusChange:
+        m_counters.statusEvents.fetch_add(1, std::memory_order_relaxed);
+        break;
+    case Protocol::Error:
+        m_counters.serverErrors.fetch_add(1, std::memory_order_relaxed);
+        break;
+    default:
+        break;
+    }
+}
@@ -0,0 +1,137 @@
+#ifndef LOADSHARD_H
+#define LOADSHARD_H
+#pragma once
+
+#include <QObject>
+#include <QQueue>
+#include <QRandomGenerator>
+#include <QString>
+#include <QThread>
+#include <QTimer>
+#include <QUrl>
+#include <QWebSocket>
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "latencyhistogram.h"
+#include "protocolcodec.h"
+
+struct LoadConfig {
+    QUrl url{QStringLiteral("ws://localhost:8080")};
+    QString prefix = QStringLiteral("lg");
+    int sessions = 100;
+    int threads = QThread::idealThreadCount();
+    int durationSec = 30;
+    double rate = 1.0;            // operaciones por segundo y sesión
+    int sendWeight = 80;          // opcode 4
+    int statusWeight = 15;        // opcode 3
+    int historyWeight = 5;        // opcode 5
+    int messageSize = 32;         // bytes de texto por mensaje, sello incluido
+};
+
+// Un hilo de carga: su propio bucle de eventos y las sesiones que le tocaron.
+//
+// Un QWebSocket queda atado al hilo que lo creó, así que las sesiones no
+// pueden cambiar de hilo una vez abiertas. El reparto se hace al abrirlas:
+// cada shard toma la siguiente sesión del contador compartido cuando uno de
+// sus handshakes termina, de modo que los hilos más desocupados se quedan con
+// más sesiones y ninguno espera a los demás.
+//
+// Los mensajes llevan como texto "lg <ns> relleno", donde <ns> es el reloj
+// monótono del proceso al enviar; la sesión que lo recibe calcula la latencia
+// de entrega. Todas las sesiones comparten proceso, así que el reloj es común.
+class LoadShard : public QObject {
+    Q_OBJECT
+public:
+    enum Op { Send, Status, History, OpCount };
+
+    // Totales leídos con snapshot() desde cualquier hilo.
+    struct Snapshot {
+        quint64 opened = 0;
+        quint64 failed = 0;
+        quint64 dropped = 0;
+        quint64 sent[OpCount] = {};
+        quint64 delivered = 0;
+        quint64 statusEvents = 0;
+        quint64 historyReplies = 0;
+        quint64 serverErrors = 0;
+        quint64 bytesOut = 0;
+        quint64 bytesIn = 0;
+
+        quint64 totalSent() const { return sent[Send] + sent[Status] + sent[History]; }
+        Snapshot &operator+=(const Snapshot &other);
+    };
+
+    LoadShard(const LoadConfig& config, std::atomic<int>* nextSession);
+
+    // Se llaman en el hilo del shard.
+    void start();
+    void stop();
+
+    Snapshot snapshot() const;
+    // Solo se leen cuando el hilo del shard ya terminó.
+    const LatencyHistogram& delivery() const { return m_delivery; }
+    const LatencyHistogram& historyRoundTrip() const { return m_historyRoundTrip; }
+
+    static qint64 nowNs();
+
+private:
+    struct Session {
+        int index = 0;
+        QString name;
+        QByteArray nameUtf8;
+        QWebSocket* socket = nullptr;
+        bool connecting = true;
+        bool open = false;
+        quint8 status = 1;
+        qint64 nextOpNs = 0;
+        QQueue<qint64> historySentNs;
+    };
+
+    struct Counters {
+        std::atomic<quint64> opened{0};
+        std::atomic<quint64> failed{0};
+        std::atomic<quint64> dropped{0};
+        std::atomic<quint64> sent[OpCount]{};
+        std::atomic<quint64> delivered{0};
+        std::atomic<quint64> statusEvents{0};
+        std::atomic<quint64> historyReplies{0};
+        std::atomic<quint64> serverErrors{0};
+        std::atomic<quint64> bytesOut{0};
+        std::atomic<quint64> bytesIn{0};
+    };
+
+    // Handshakes simultáneos por shard: marca el ritmo de la rampa de conexión.
+    static constexpr int MaxHandshakes = 64;
+    static constexpr int TickMs = 5;
+    // Tras un atasco de más de esto no se recuperan las operaciones perdidas.
+    static constexpr qint64 CatchUpLimitNs = 1000LL * 1000 * 1000;
+
+    void claimSessions();
+    void openSession(int index);
+    void onSocketDown(Session* session);
+    void tick();
+    void runOp(Session& session, qint64 now);
+    void onFrame(Session& session, const QByteArray& frame);
+    qint64 nextIntervalNs();
+    QString peerOf(int index);
+
+    const LoadConfig m_config;
+    std::atomic<int>* m_nextSession;
+    std::vector<std::unique_ptr<Session>> m_sessions;
+    int m_handshakes = 0;
+    bool m_stopping = false;
+
+    QTimer* m_tick = nullptr;
+    QRandomGenerator m_random;
+    Protocol::FrameBuilder m_frames;
+    QByteArray m_padding;
+
+    Counters m_counters;
+    LatencyHistogram m_delivery;
+    LatencyHistogram m_historyRoundTrip;
+};
+
+#endif // LOADSHARD_H
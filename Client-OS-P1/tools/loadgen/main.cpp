@@ -0,0 +1,84 @@
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QTextStream>
+
+#include "loadgenerator.h"
+#include "mockserver.h"
+
+// Generador de carga: abre muchas sesiones simuladas contra un servidor de
+// chat con el mismo código de protocolo que la aplicación y mide el
+// throughput y la latencia de entrega.
+//
+//   loadgen --url ws://servidor:8080 --sessions 2000 --rate 2 --mix 80:15:5
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("loadgen");
+
+    const LoadConfig defaults;
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Generador de carga para el servidor de chat");
+    parser.addHelpOption();
+    parser.addOptions({
+        {"url", "Servidor WebSocket.", "url", defaults.url.toString()},
+        {{"n", "sessions"}, "Sesiones simuladas.", "n", QString::number(defaults.sessions)},
+        {{"t", "threads"}, "Hilos de carga.", "n", QString::number(defaults.threads)},
+        {{"d", "duration"}, "Duración de la prueba en segundos.", "s", QString::number(defaults.durationSec)},
+        {{"r", "rate"}, "Operaciones por segundo y sesión.", "ops", QString::number(defaults.rate)},
+        {"mix", "Pesos de envío (4), estado (3) e historial (5).", "a:b:c",
+         QStringLiteral("%1:%2:%3").arg(defaults.sendWeight).arg(defaults.statusWeight).arg(defaults.historyWeight)},
+        {"size", "Bytes de texto por mensaje (máx. 255).", "bytes", QString::number(defaults.messageSize)},
+        {"prefix", "Prefijo de los nombres de usuario simulados.", "nombre", defaults.prefix},
+        {"mock", "Usar un servidor de prueba en este proceso en lugar de --url."},
+    });
+    parser.process(app);
+
+    LoadConfig config;
+    bool ok = true;
+    auto number = [&](const QString& option, int minimum) {
+        bool valid = false;
+        const int value = parser.value(option).toInt(&valid);
+        ok = ok && valid && value >= minimum;
+        return value;
+    };
+    config.url = QUrl(parser.value("url"));
+    config.prefix = parser.value("prefix");
+    config.sessions = number("sessions", 1);
+    config.threads = number("threads", 1);
+    config.durationSec = number("duration", 1);
+    config.messageSize = qMin(number("size", 0), int(Protocol::FrameBuilder::MaxString8));
+    bool validRate = false;
+    config.rate = parser.value("rate").toDouble(&validRate);
+    ok = ok && validRate && config.rate > 0;
+
+    const QStringList mix = parser.value("mix").split(':');
+    if (mix.size() == 3) {
+        config.sendWeight = mix[0].toInt();
+        config.statusWeight = mix[1].toInt();
+        config.historyWeight = mix[2].toInt();
+    }
+    const bool validMix = mix.size() == 3 && config.sendWeight >= 0 && config.statusWeight >= 0
+                          && config.historyWeight >= 0
+                          && config.sendWeight + config.statusWeight + config.historyWeight > 0;
+
+    if (!ok || !validMix || !config.url.isValid() || config.prefix.isEmpty()) {
+        QTextStream(stderr) << "Opciones inválidas\n\n" << parser.helpText();
+        return 1;
+    }
+
+    // Sin red: el servidor de prueba corre en el hilo principal y las
+    // sesiones en los hilos de carga.
+    MockChatServer mock;
+    if (parser.isSet("mock")) {
+        if (!mock.listen())
+            return 1;
+        config.url = mock.url();
+    }
+
+    QTextStream out(stdout);
+    LoadGenerator generator(config, out);
+    QObject::connect(&generator, &LoadGenerator::finished, &app, &QCoreApplication::quit, Qt::QueuedConnection);
+    generator.start();
+
+    return app.exec();
+}
@@ -0,0 +1,58 @@
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QTextStream>
+
+#include "logging.h"
+#include "mockserver.h"
+
+// Servidor de chat local con comportamiento configurable.
+//
+//   mockserver --port 18080 --latency 40 --jitter 20 --roster 200 --storm 50 --compress
+int main(int argc, char *argv[])
+{
+    Logging::install();
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("mockserver");
+
+    const MockServerConfig defaults;
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Servidor de chat local para pruebas y benchmarks");
+    parser.addHelpOption();
+    parser.addOptions({
+        {"port", "Puerto de escucha (HTTP y WebSocket).", "port", "18080"},
+        {"any", "Escuchar en todas las interfaces, no solo en localhost."},
+        {"latency", "Retraso de cada frame enviado, en ms.", "ms", QString::number(defaults.latencyMs)},
+        {"jitter", "Retraso aleatorio adicional, 0..ms.", "ms", QString::number(defaults.jitterMs)},
+        {"roster", "Usuarios simulados en la lista.", "n", QString::number(defaults.rosterSize)},
+        {"history", "Mensajes que se conservan por chat.", "n", QString::number(defaults.historyDepth)},
+        {"storm", "Cambios de estado por segundo de los usuarios simulados.", "hz", QString::number(defaults.presenceStormHz)},
+        {"seed", "Semilla para jitter y usuarios simulados.", "n", QString::number(defaults.seed)},
+        {"compress", "Enviar 51 y 56 comprimidos (57) a quien pida compress=zlib."},
+    });
+    parser.process(app);
+
+    MockServerConfig config;
+    config.latencyMs = parser.value("latency").toInt();
+    config.jitterMs = parser.value("jitter").toInt();
+    config.rosterSize = parser.value("roster").toInt();
+    config.historyDepth = parser.value("history").toInt();
+    config.presenceStormHz = parser.value("storm").toInt();
+    config.seed = parser.value("seed").toUInt();
+    config.compression = parser.isSet("compress");
+
+    MockChatServer server(config);
+    const QHostAddress address = parser.isSet("any") ? QHostAddress::Any : QHostAddress::LocalHost;
+    if (!server.listen(address, quint16(parser.value("port").toUInt())))
+        return 1;
+
+    QTextStream out(stdout);
+    out << "Servidor de prueba en " << server.url().toString() << Qt::endl;
+    QObject::connect(&server, &MockChatServer::clientConnected, [&](const QString &name) {
+        out << "+ " << name << " (" << server.clientCount() << " conectados)" << Qt::endl;
+    });
+    QObject::connect(&server, &MockChatServer::clientDisconnected, [&](const QString &name) {
+        out << "- " << name << " (" << server.clientCount() << " conectados)" << Qt::endl;
+    });
+
+    return app.exec();
+}
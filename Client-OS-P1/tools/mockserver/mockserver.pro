@@ -0,0 +1,16 @@
+# Servidor de chat local (MockChatServer de chatcore) como ejecutable, para
+# usar la aplicación o el generador de carga sin el servidor remoto.
+
+TEMPLATE = app
+TARGET = mockserver
+CONFIG += console c++17
+CONFIG -= app_bundle
+
+QT = core network websockets
+
+CONFIG(release, debug|release): DEFINES += QT_NO_DEBUG_OUTPUT
+
+include(../../core/core.pri)
+
+SOURCES += \
+    main.cpp
@@ -23,14 +23,11 @@ public:
         QHBoxLayout *mainLayout = new QHBoxLayout(this);
         mainLayout->setContentsMargins(10, 10, 5, 10);
 
-        // Avatar - circular label with first letter of username
+        // Avatar - circular pixmap provided through setAvatar()
         m_avatarLabel = new QLabel(this);
         m_avatarLabel->setFixedSize(50, 50);
         m_avatarLabel->setAlignment(Qt::AlignCenter);
 
-        // Get first letter of username
-        QString firstLetter = username.isEmpty() ? QString("?") : QString(username.at(0).toUpper());
-        m_avatarLabel->setText(firstLetter);
 
         // User info layout
         QVBoxLayout *infoLayout = new QVBoxLayout();
@@ -66,15 +63,16 @@ public:
         mainLayout->addWidget(m_avatarLabel);
         mainLayout->addLayout(infoLayout);
         mainLayout->addStretch();
-
-        // Style the avatar
-        updateAvatar();
     }
 
     void setUsername(const QString &username) {
         m_username = username;
         m_usernameLabel->setText(username);
-        updateAvatar();
+    }
+
+    // Avatar ya pintado (ver AvatarCache)
+    void setAvatar(const QPixmap &avatar) {
+        m_avatarLabel->setPixmap(avatar);
     }
 
     void setStatus(const QString &status) {
@@ -106,34 +104,6 @@ protected:
     }
 
 private:
-    void updateAvatar() {
-        QString firstLetter = m_username.isEmpty() ? QString("?") : QString(m_username.at(0).toUpper());
-        m_avatarLabel->setText(firstLetter);
-
-        // Generate a color based on the username
-        int hash = 0;
-        for (const QChar &c : m_username) {
-            hash = ((hash << 5) - hash) + c.unicode();
-        }
-
-        QColor avatarColor;
-        if (m_username.isEmpty()) {
-            avatarColor = QColor("#128C7E"); // Default color
-        } else {
-            // Generate a hue based on the hash
-            int hue = qAbs(hash) % 360;
-            avatarColor = QColor::fromHsv(hue, 200, 200);
-        }
-
-        m_avatarLabel->setStyleSheet(QString("QLabel {"
-                                             "background-color: %1;"
-                                             "border-radius: 25px;"
-                                             "color: white;"
-                                             "font-weight: bold;"
-                                             "font-size: 18px;"
-                                             "}").arg(avatarColor.name()));
-    }
-
     void updateStatusIndicator(const QString &status) {
         QString statusColor;
         QString statusSymbol;